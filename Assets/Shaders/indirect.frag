@@ -0,0 +1,16 @@
+#version 450
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Descriptor heap, set 0 is shared by every shader
+layout(set = 0, binding = 0) uniform sampler2D textures[];
+
+layout(location = 0) in vec2 texture_coordinate;
+layout(location = 1) flat in uint texture_index;
+
+layout(location = 0) out vec4 color_out;
+
+void main()
+{
+    color_out = vec4(texture(textures[nonuniformEXT(texture_index)], texture_coordinate).xyz, 1.0f);
+}
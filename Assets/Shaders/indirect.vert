@@ -0,0 +1,46 @@
+#version 450
+
+// Instances of Vulkan::IndirectBatch, every draw command starts at its instance
+
+struct Instance
+{
+    mat4 model;
+    vec4 bounds;
+
+    uint mesh_index;
+    uint texture_index;
+    uint padding[2];
+};
+
+// Descriptor heap, set 0 is shared by every shader
+layout(set = 0, binding = 1) readonly buffer FrameData
+{
+    mat4 projected_view;
+} frames[];
+
+layout(set = 0, binding = 1) readonly buffer Instances
+{
+    Instance instances[];
+} instance_buffers[];
+
+layout(push_constant) uniform DrawData
+{
+    uint frame_buffer_index;
+    uint instance_buffer_index;
+} draw;
+
+layout(location = 0) in vec3 local_position_in;
+layout(location = 1) in vec2 uv_in;
+
+layout(location = 0) out vec2 uv_out;
+layout(location = 1) flat out uint texture_index_out;
+
+void main()
+{
+    const Instance instance = instance_buffers[draw.instance_buffer_index].instances[gl_InstanceIndex];
+
+    gl_Position = frames[draw.frame_buffer_index].projected_view * instance.model * vec4(local_position_in, 1.0f);
+
+    uv_out            = uv_in;
+    texture_index_out = instance.texture_index;
+}
@@ -0,0 +1,51 @@
+#version 450
+
+// Instanced draws from Vulkan::InstanceStream, the draw's first instance is its offset in the stream
+
+struct Transform
+{
+    vec4 rows[3]; // Affine, the last row is (0, 0, 0, 1)
+};
+
+// Descriptor heap, set 0 is shared by every shader
+layout(set = 0, binding = 1) readonly buffer FrameData
+{
+    mat4 projected_view;
+} frames[];
+
+layout(set = 0, binding = 1) readonly buffer Transforms
+{
+    Transform transforms[];
+} transform_buffers[];
+
+layout(push_constant) uniform DrawData
+{
+    uint frame_buffer_index;
+    uint transform_buffer_index;
+    uint texture_index;
+} draw;
+
+layout(location = 0) in vec3 local_position_in;
+layout(location = 1) in vec2 uv_in;
+
+layout(location = 0) out vec2 uv_out;
+layout(location = 1) flat out uint texture_index_out;
+
+void main()
+{
+    const Transform transform = transform_buffers[draw.transform_buffer_index].transforms[gl_InstanceIndex];
+
+    const vec4 local_position = vec4(local_position_in, 1.0f);
+
+    const vec4 world_position = vec4(
+        dot(transform.rows[0], local_position),
+        dot(transform.rows[1], local_position),
+        dot(transform.rows[2], local_position),
+        1.0f
+    );
+
+    gl_Position = frames[draw.frame_buffer_index].projected_view * world_position;
+
+    uv_out            = uv_in;
+    texture_index_out = draw.texture_index;
+}
@@ -1,6 +1,16 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D tex;
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Descriptor heap, set 0 is shared by every shader
+layout(set = 0, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform InstanceData
+{
+    mat4 model;
+    uint frame_buffer_index;
+    uint texture_index;
+} instance;
 
 layout(location = 0) in vec2 texture_coordinate;
 layout(location = 1) in vec3 world_position;
@@ -9,7 +19,7 @@ layout(location = 0) out vec4 color_out;
 
 void main()
 {
-    vec3 color = texture(tex, texture_coordinate).xyz * gl_FragCoord.x / 512;
+    vec3 color = texture(textures[nonuniformEXT(instance.texture_index)], texture_coordinate).xyz * gl_FragCoord.x / 512;
 
     color_out = vec4(color, 1.0f);
 }
@@ -1,13 +1,16 @@
 #version 450
 
-layout(binding = 0) uniform FrameData
+// Descriptor heap, set 0 is shared by every shader
+layout(set = 0, binding = 1) readonly buffer FrameData
 {
     mat4 projected_view;
-} frame;
+} frames[];
 
 layout(push_constant) uniform InstanceData
 {
     mat4 model;
+    uint frame_buffer_index;
+    uint texture_index;
 } instance;
 
 layout(location = 0) in vec3 local_position_in;
@@ -20,7 +23,7 @@ void main()
 {
     const vec4 world_position = instance.model * vec4(local_position_in, 1.0f);
 
-    gl_Position = frame.projected_view * world_position;
+    gl_Position = frames[instance.frame_buffer_index].projected_view * world_position;
 
     world_position_out = world_position.xyz;
     uv_out = uv_in;
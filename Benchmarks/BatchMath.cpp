@@ -0,0 +1,175 @@
+#include "Benchmark.hpp"
+
+#include "Crunch/BatchMath.hpp"
+
+#include <random>
+
+// Crunch BatchMath throughput on one core for every kernel the CPU supports, at a count that stays in L2 and one
+// that streams from memory. The GLM rows run the equivalent GLM expressions one element at a time.
+
+using namespace Cr;
+
+namespace
+{
+
+struct Data
+{
+    std::vector<F32> tx, ty, tz, qx, qy, qz, qw, sx, sy, sz, ex, ey, ez;
+    std::vector<F32> rx, ry, rz, rex, rey, rez;
+    std::vector<Mat4f> matrices;
+
+    explicit Data(std::size_t count)
+        : tx(count), ty(count), tz(count), qx(count), qy(count), qz(count), qw(count), sx(count), sy(count), sz(count)
+        , ex(count), ey(count), ez(count), rx(count), ry(count), rz(count), rex(count), rey(count), rez(count)
+        , matrices(count)
+    {
+        std::mt19937 random(static_cast<U32>(count));
+        std::uniform_real_distribution<F32> value(-1.0f, 1.0f);
+
+        for (auto* component : { &tx, &ty, &tz, &sx, &sy, &sz, &ex, &ey, &ez })
+        {
+            std::ranges::generate(*component, [&]() { return value(random); });
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Quatf q = glm::normalize(Quatf(value(random), value(random), value(random), value(random)));
+
+            qx[i] = q.x;
+            qy[i] = q.y;
+            qz[i] = q.z;
+            qw[i] = q.w;
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions = Benchmark::get_option(argc, argv, "--repetitions", 20);
+
+    const Mat4f matrix = glm::translate(Mat4f { 1.0f }, Vec3f { 1.0f, 2.0f, 3.0f }) * glm::mat4_cast(glm::angleAxis(0.5f, VEC3F_UP));
+
+    CR_INFO("BatchMath: one core, best of {}, million elements per second", repetitions);
+    CR_INFO("{:>10} {:>8} {:>12} {:>12} {:>12}", "Elements", "Kernel", "compose", "points", "aabbs");
+
+    for (const std::size_t count : { std::size_t(16'384), std::size_t(4'194'304) })
+    {
+        Data data(count);
+
+        const Vec3Span    translations { data.tx, data.ty, data.tz };
+        const QuatSpan    rotations    { data.qx, data.qy, data.qz, data.qw };
+        const Vec3Span    scales       { data.sx, data.sy, data.sz };
+        const Vec3Span    extents      { data.ex, data.ey, data.ez };
+        const Vec3SpanOut results      { data.rx, data.ry, data.rz };
+        const Vec3SpanOut result_ext   { data.rex, data.rey, data.rez };
+
+        // Small inputs are repeated to keep the timer resolution out of the results
+        const U32 rounds = static_cast<U32>(std::max<std::size_t>(1, (1u << 22) / count));
+
+        const auto report = [&](const char* name, F64 compose_time, F64 points_time, F64 aabbs_time)
+        {
+            const F64 elements = F64(count) * rounds * 1e-6;
+
+            CR_INFO("{:>10} {:>8} {:>12.1f} {:>12.1f} {:>12.1f}", count, name, elements / compose_time, elements / points_time, elements / aabbs_time);
+        };
+
+        const F64 glm_compose = Benchmark::measure(repetitions, [&]() {
+            for (U32 round = 0; round < rounds; ++round)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    data.matrices[i] = glm::translate(Mat4f { 1.0f }, Vec3f { data.tx[i], data.ty[i], data.tz[i] }) *
+                                       glm::mat4_cast(Quatf(data.qw[i], data.qx[i], data.qy[i], data.qz[i])) *
+                                       glm::scale(Mat4f { 1.0f }, Vec3f { data.sx[i], data.sy[i], data.sz[i] });
+                }
+
+                Benchmark::keep(data.matrices.data());
+            }
+        });
+
+        const F64 glm_points = Benchmark::measure(repetitions, [&]() {
+            for (U32 round = 0; round < rounds; ++round)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const Vec4f point = matrix * Vec4f(data.tx[i], data.ty[i], data.tz[i], 1.0f);
+
+                    data.rx[i] = point.x;
+                    data.ry[i] = point.y;
+                    data.rz[i] = point.z;
+                }
+
+                Benchmark::keep(data.rx.data());
+            }
+        });
+
+        const F64 glm_aabbs = Benchmark::measure(repetitions, [&]() {
+            Mat3f linear = Mat3f(matrix);
+
+            for (U32 column = 0; column < 3; ++column)
+            {
+                linear[column] = glm::abs(linear[column]);
+            }
+
+            for (U32 round = 0; round < rounds; ++round)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const Vec4f center = matrix * Vec4f(data.tx[i], data.ty[i], data.tz[i], 1.0f);
+                    const Vec3f extent = linear * Vec3f(data.ex[i], data.ey[i], data.ez[i]);
+
+                    data.rx[i]  = center.x;
+                    data.ry[i]  = center.y;
+                    data.rz[i]  = center.z;
+                    data.rex[i] = extent.x;
+                    data.rey[i] = extent.y;
+                    data.rez[i] = extent.z;
+                }
+
+                Benchmark::keep(data.rex.data());
+            }
+        });
+
+        report("GLM", glm_compose, glm_points, glm_aabbs);
+
+        for (const BatchMathKernel kernel : { BatchMathKernel::Scalar, BatchMathKernel::SSE, BatchMathKernel::AVX2 })
+        {
+            if (!is_batch_math_kernel_supported(kernel))
+            {
+                continue;
+            }
+
+            set_batch_math_kernel(kernel);
+
+            const F64 compose_time = Benchmark::measure(repetitions, [&]() {
+                for (U32 round = 0; round < rounds; ++round)
+                {
+                    compose_transforms(translations, rotations, scales, data.matrices);
+                    Benchmark::keep(data.matrices.data());
+                }
+            });
+
+            const F64 points_time = Benchmark::measure(repetitions, [&]() {
+                for (U32 round = 0; round < rounds; ++round)
+                {
+                    transform_points(matrix, translations, results);
+                    Benchmark::keep(data.rx.data());
+                }
+            });
+
+            const F64 aabbs_time = Benchmark::measure(repetitions, [&]() {
+                for (U32 round = 0; round < rounds; ++round)
+                {
+                    transform_aabbs(matrix, translations, extents, results, result_ext);
+                    Benchmark::keep(data.rex.data());
+                }
+            });
+
+            report(get_batch_math_kernel_name(), compose_time, points_time, aabbs_time);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+
+namespace Cr::Benchmark
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the result of a measured computation alive without storing it anywhere
+template<typename T>
+inline void keep(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Calls function repetitions times and returns the fastest run in seconds, the minimum is the least noisy estimate
+// of what the code costs on an otherwise idle machine
+template<typename F>
+[[nodiscard]] F64 measure(U32 repetitions, F&& function)
+{
+    F64 best = std::numeric_limits<F64>::max();
+
+    for (U32 i = 0; i < repetitions; ++i)
+    {
+        const auto begin = Clock::now();
+        function();
+        const auto end   = Clock::now();
+
+        best = std::min(best, std::chrono::duration<F64>(end - begin).count());
+    }
+
+    return best;
+}
+
+// Value of a "--name value" command line option, benchmarks run briefly by default to keep CI short
+[[nodiscard]] inline U32 get_option(int argc, char* argv[], std::string_view name, U32 fallback)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::string_view(argv[i]) == name)
+        {
+            return std::max(std::atoi(argv[i + 1]), 1);
+        }
+    }
+
+    return fallback;
+}
+
+} // namespace Cr::Benchmark
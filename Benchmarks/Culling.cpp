@@ -0,0 +1,63 @@
+#include "Benchmark.hpp"
+
+#include "Graphics/Culling.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <random>
+#include <thread>
+
+// Graphics::FrustumCuller at 10k, 100k and 1M spheres scattered around a camera, on the calling thread and split
+// across every hardware thread. Roughly a fifth of the spheres end up visible.
+
+using namespace Cr;
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions = Benchmark::get_option(argc, argv, "--repetitions", 10);
+
+    Core::JobSystem jobs(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    const Mat4f projection     = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    const Mat4f view           = glm::lookAt(Vec3f{ 0.0f }, Vec3f{ 0.0f, 0.0f, -1.0f }, VEC3F_UP);
+    const Mat4f projected_view = projection * view;
+
+    CR_INFO("Culling: {} kernel, {} threads, best of {}", Graphics::FrustumCuller::get_kernel_name(), jobs.get_thread_count(), repetitions);
+    CR_INFO("{:>10} {:>10} {:>12} {:>14} {:>12} {:>14}", "Spheres", "Visible", "1 thread ms", "Mspheres/s", "jobs ms", "Mspheres/s");
+
+    for (const U32 count : { 10'000u, 100'000u, 1'000'000u })
+    {
+        Graphics::FrustumCuller culler;
+
+        std::mt19937 random(count);
+        std::uniform_real_distribution<F32> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<F32> radius(0.5f, 4.0f);
+
+        for (U32 i = 0; i < count; ++i)
+        {
+            (void)culler.add({ position(random), position(random), position(random) }, radius(random));
+        }
+
+        std::vector<U32> visible;
+        visible.reserve(count);
+
+        const F64 single_time = Benchmark::measure(repetitions, [&]() {
+            culler.cull(projected_view, visible);
+        });
+
+        const std::size_t visible_count = visible.size();
+
+        const F64 jobs_time = Benchmark::measure(repetitions, [&]() {
+            culler.cull(projected_view, visible, jobs);
+        });
+
+        CR_ASSERT_THROW(visible.size() == visible_count, "Culling on the job system found {} spheres instead of {}", visible.size(), visible_count);
+
+        CR_INFO("{:>10} {:>10} {:>12.3f} {:>14.1f} {:>12.3f} {:>14.1f}",
+            count, visible_count,
+            single_time * 1e3, count / single_time * 1e-6,
+            jobs_time   * 1e3, count / jobs_time   * 1e-6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "Benchmark.hpp"
+
+#include "Crunch/Filesystem.hpp"
+
+#include <cstring>
+#include <numeric>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+// MappedFile against read_binary_file from 1 MiB to 1 GiB, the time to open a file and read every byte of it once.
+// Warm runs find the file in the page cache. Cold runs evict it first where the platform allows it, without root,
+// and measure the storage device as much as the loader.
+
+using namespace Cr;
+
+namespace
+{
+
+// Stands in for a consumer of the data, every byte is read once
+U64 checksum(std::span<const U8> data)
+{
+    const std::size_t words = data.size() / sizeof(U64);
+
+    U64 sum = 0;
+
+    for (std::size_t i = 0; i < words; ++i)
+    {
+        U64 word;
+        std::memcpy(&word, data.data() + i * sizeof(U64), sizeof(U64));
+        sum += word;
+    }
+
+    for (std::size_t i = words * sizeof(U64); i < data.size(); ++i)
+    {
+        sum += data[i];
+    }
+
+    return sum;
+}
+
+// Drops the clean pages of the file from the page cache, false when the platform can not
+bool evict(const std::filesystem::path& path)
+{
+#if defined(__linux__)
+    const int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+    {
+        return false;
+    }
+
+    // Only clean pages are dropped, a freshly written file is flushed first
+    const bool evicted = ::fdatasync(file) == 0 && ::posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(file);
+
+    return evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions = Benchmark::get_option(argc, argv, "--repetitions", 5);
+    const U32 max_size_mb = Benchmark::get_option(argc, argv, "--max-size", 1024); // In MiB
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "CrunchBenchmarkFilesystem.bin";
+
+    CR_INFO("Filesystem: {}, best of {}, GiB/s including a pass over every byte", path.string(), repetitions);
+    CR_INFO("{:>10} {:>8} {:>14} {:>14} {:>10}", "MiB", "Cache", "read_binary", "MappedFile", "speedup");
+
+    for (U32 size_mb = 1; size_mb <= max_size_mb; size_mb *= 4)
+    {
+        const std::size_t size = std::size_t(size_mb) << 20;
+
+        {
+            std::vector<U8> contents(size);
+            std::iota(contents.begin(), contents.end(), U8(0));
+
+            write_binary_file(path, contents);
+        }
+
+        U64 expected = 0;
+
+        for (const bool cold : { false, true })
+        {
+            if (cold && !evict(path))
+            {
+                CR_WARN("Page cache can not be dropped on this platform, skipping cold runs");
+                break;
+            }
+
+            // Not Benchmark::measure, eviction has to stay outside of the timed part
+            const auto run = [&](auto&& load) {
+                F64 best = std::numeric_limits<F64>::max();
+
+                for (U32 i = 0; i < repetitions; ++i)
+                {
+                    if (cold)
+                    {
+                        (void)evict(path);
+                    }
+
+                    const auto begin = Benchmark::Clock::now();
+                    const U64  sum   = load();
+                    const auto end   = Benchmark::Clock::now();
+
+                    CR_ASSERT_THROW(expected == 0 || sum == expected, "Loaders disagree on the contents of {}", path.string());
+                    expected = sum;
+
+                    best = std::min(best, std::chrono::duration<F64>(end - begin).count());
+                }
+
+                return best;
+            };
+
+            const F64 read_time = run([&]() {
+                const std::vector<U8> data = read_binary_file(path);
+                return checksum(data);
+            });
+
+            const F64 map_time = run([&]() {
+                const MappedFile file(path);
+                return checksum(file.get_data());
+            });
+
+            const F64 gib = F64(size) / F64(1 << 30);
+
+            CR_INFO("{:>10} {:>8} {:>14.2f} {:>14.2f} {:>10.2f}", size_mb, cold ? "cold" : "warm", gib / read_time, gib / map_time, read_time / map_time);
+        }
+    }
+
+    std::filesystem::remove(path);
+
+    return 0;
+}
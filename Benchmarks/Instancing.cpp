@@ -0,0 +1,189 @@
+#include "Benchmark.hpp"
+
+#include "Graphics/Vulkan/API.hpp"
+#include "Graphics/Mesh.hpp"
+
+#include "Crunch/Filesystem.hpp"
+
+// 10k cubes drawn one by one with push constants versus one instanced draw reading transforms from a
+// Vulkan::InstanceStream, rendered headless at 1280x720. Every cube is inside the view. Reports the CPU time spent
+// recording and submitting a frame and the frame time, which is bound by whichever of CPU and GPU is slower.
+
+using namespace Cr;
+using namespace Cr::Graphics;
+
+static constexpr U32 GRID_SIZE     = 100; // 10k cubes
+static constexpr U32 WARMUP_FRAMES = 16;
+
+static constexpr VkExtent2D FRAME_EXTENT { 1280, 720 };
+
+static Unique<Vulkan::ShaderModule> load_shader_module(Vulkan::API& vk, std::string_view name, VkShaderStageFlags stage)
+{
+    const MappedFile file(std::string(CR_BENCHMARK_ASSET_DIR "/Shaders/") + std::string(name));
+
+    return vk.create_shader_module(file.get_data(), stage);
+}
+
+int main(int argc, char* argv[])
+{
+    const U32 frame_count = Benchmark::get_option(argc, argv, "--frames", 500);
+
+    try
+    {
+        Vulkan::API vk { FRAME_EXTENT, false };
+
+        const auto vertex_module           = load_shader_module(vk, "triangle.vert.spv",  VK_SHADER_STAGE_VERTEX_BIT);
+        const auto fragment_module         = load_shader_module(vk, "triangle.frag.spv",  VK_SHADER_STAGE_FRAGMENT_BIT);
+        const auto instanced_vertex_module = load_shader_module(vk, "instanced.vert.spv", VK_SHADER_STAGE_VERTEX_BIT);
+        const auto indirect_fragment_module = load_shader_module(vk, "indirect.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
+
+        const std::array individual_modules { vertex_module.get(), fragment_module.get() };
+        const std::array instanced_modules  { instanced_vertex_module.get(), indirect_fragment_module.get() };
+
+        const Vulkan::ShaderHandle individual_shader = vk.create_shader(VK_PIPELINE_BIND_POINT_GRAPHICS, individual_modules);
+        const Vulkan::ShaderHandle instanced_shader  = vk.create_shader(VK_PIPELINE_BIND_POINT_GRAPHICS, instanced_modules);
+
+        const auto vertices = get_cube_vertices(1.0f, 0);
+        const auto indices  = get_cube_indices(0);
+
+        const Vulkan::MeshHandle cube = vk.create_mesh(vertices.data(), sizeof(vertices[0]) * vertices.size(), indices);
+
+        // White 1x1 texture, sampled by both fragment shaders
+        const Vulkan::TextureHandle texture = vk.create_texture(VK_FORMAT_R8G8B8A8_UNORM, { 1, 1, 1 });
+        {
+            const std::array<U8, 4> white { 255, 255, 255, 255 };
+
+            const VkBufferImageCopy region {
+                .imageSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .layerCount = 1 },
+                .imageExtent      = { 1, 1, 1 },
+            };
+
+            vk.get_uploader().copy_to_texture(white.data(), white.size(), vk.get(texture), {&region, 1});
+        }
+
+        // Grid of cubes in front of a camera looking down at it
+        const Mat4f projection = glm::perspective(glm::radians(90.0f), F32(FRAME_EXTENT.width) / F32(FRAME_EXTENT.height), 0.1f, 500.0f);
+        const Mat4f view       = glm::lookAt(Vec3f{ 0.0f, 80.0f, 60.0f }, Vec3f{ 0.0f }, VEC3F_UP);
+
+        const UniformBufferObject frame_data { .projected_view = projection * view };
+
+        const Vulkan::BufferHandle frame_buffer = vk.create_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(frame_data), Vulkan::HostAccess::SequentialWrite);
+        vk.get(frame_buffer).set_data(&frame_data, sizeof(frame_data), 0);
+
+        std::vector<Mat4f> transforms;
+        transforms.reserve(GRID_SIZE * GRID_SIZE);
+
+        for (U32 z = 0; z < GRID_SIZE; ++z)
+        {
+            for (U32 x = 0; x < GRID_SIZE; ++x)
+            {
+                const Vec3f position { F32(x) - F32(GRID_SIZE) / 2, 0.0f, F32(z) - F32(GRID_SIZE) / 2 };
+                transforms.push_back(glm::scale(glm::translate(Mat4f{ 1.0f }, position), Vec3f{ 0.4f }));
+            }
+        }
+
+        auto instance_stream = vk.create_instance_stream(static_cast<U32>(transforms.size()));
+
+        const U32 frame_buffer_index = vk.get(frame_buffer).get_descriptor_index();
+        const U32 texture_index      = vk.get(texture).get_descriptor_index();
+        const U32 index_count        = vk.get(cube).index_count;
+
+        // The mesh is bound once per frame for both paths, like the engine does
+        auto bind_cube = [&](Vulkan::CommandBuffer& cmd) {
+            cmd.bind_vertex_buffer(vk.get(vk.get(cube).vertex_buffer));
+            cmd.bind_index_buffer(vk.get(vk.get(cube).index_buffer), VK_INDEX_TYPE_UINT32);
+        };
+
+        auto record_individual = [&](Vulkan::CommandBuffer& cmd) {
+            const Vulkan::Shader& shader = vk.get(individual_shader);
+
+            bind_cube(cmd);
+            cmd.bind_shader(shader);
+
+            for (const Mat4f& transform : transforms)
+            {
+                const PushConstantObject object_data {
+                    .model              = transform,
+                    .frame_buffer_index = frame_buffer_index,
+                    .texture_index      = texture_index,
+                };
+
+                cmd.push_constants(shader, object_data);
+                cmd.draw_indexed(index_count, 1, 0, 0, 0);
+            }
+        };
+
+        auto record_instanced = [&](Vulkan::CommandBuffer& cmd) {
+            const Vulkan::Shader& shader = vk.get(instanced_shader);
+
+            instance_stream->begin(vk.get_frame_index());
+            const U32 first_instance = instance_stream->write(transforms);
+            instance_stream->end();
+
+            const std::array constants { frame_buffer_index, instance_stream->get_descriptor_index(), texture_index };
+
+            bind_cube(cmd);
+            cmd.bind_shader(shader);
+            cmd.push_constants(shader, constants.data(), sizeof(constants));
+            cmd.draw_indexed(index_count, static_cast<U32>(transforms.size()), 0, 0, first_instance);
+        };
+
+        struct Result
+        {
+            F64 record_time = 0.0; // Per frame, seconds
+            F64 frame_time  = 0.0;
+        };
+
+        auto run = [&](auto&& record) {
+            Result result {};
+
+            auto render_frame = [&]() {
+                auto& cmd = vk.begin_frame();
+
+                const auto record_start = Benchmark::Clock::now();
+
+                vk.begin_rendering();
+                record(cmd);
+                vk.end_frame();
+
+                return std::chrono::duration<F64>(Benchmark::Clock::now() - record_start).count();
+            };
+
+            for (U32 frame = 0; frame < WARMUP_FRAMES; ++frame)
+            {
+                (void)render_frame();
+            }
+
+            const auto start = Benchmark::Clock::now();
+
+            for (U32 frame = 0; frame < frame_count; ++frame)
+            {
+                result.record_time += render_frame();
+            }
+
+            vk.get_command_queue(VK_QUEUE_GRAPHICS_BIT).wait_for_idle();
+
+            result.frame_time   = std::chrono::duration<F64>(Benchmark::Clock::now() - start).count() / frame_count;
+            result.record_time /= frame_count;
+
+            return result;
+        };
+
+        const Result individual = run(record_individual);
+        const Result instanced  = run(record_instanced);
+
+        CR_INFO("Instancing: {} cubes, {} frames of {}x{}", transforms.size(), frame_count, FRAME_EXTENT.width, FRAME_EXTENT.height);
+        CR_INFO("{:>12} {:>12} {:>12}", "Path", "record ms", "frame ms");
+        CR_INFO("{:>12} {:>12.3f} {:>12.3f}", "individual", individual.record_time * 1e3, individual.frame_time * 1e3);
+        CR_INFO("{:>12} {:>12.3f} {:>12.3f}", "instanced",  instanced.record_time  * 1e3, instanced.frame_time  * 1e3);
+
+        vk.destroy(std::move(instance_stream));
+    }
+    catch (const std::exception& e)
+    {
+        CR_ERROR("{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
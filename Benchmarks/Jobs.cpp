@@ -0,0 +1,75 @@
+#include "Benchmark.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <cmath>
+#include <thread>
+
+// Scaling of Core::JobSystem from one thread to every hardware thread, on a compute bound parallel_for and on
+// empty jobs measuring the scheduling overhead alone
+
+using namespace Cr;
+
+static constexpr U32 ELEMENT_COUNT = 1 << 22;
+static constexpr U32 BATCH_SIZE    = 1 << 12;
+static constexpr U32 EMPTY_JOBS    = 1 << 10; // Per round, well inside the per thread job pool
+static constexpr U32 EMPTY_ROUNDS  = 64;
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions  = Benchmark::get_option(argc, argv, "--repetitions", 5);
+    const U32 thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<F32> values(ELEMENT_COUNT);
+
+    for (U32 i = 0; i < ELEMENT_COUNT; ++i)
+    {
+        values[i] = F32(i) * 0.001f;
+    }
+
+    std::vector<F32> results(ELEMENT_COUNT);
+
+    CR_INFO("Jobs: {} elements in batches of {}, {} rounds of {} empty jobs, best of {}", ELEMENT_COUNT, BATCH_SIZE, EMPTY_ROUNDS, EMPTY_JOBS, repetitions);
+    CR_INFO("{:>8} {:>12} {:>9} {:>14}", "Threads", "for ms", "Speedup", "Empty jobs/s");
+
+    F64 single_thread_time = 0.0;
+
+    for (U32 threads = 1; threads <= thread_count; ++threads)
+    {
+        Core::JobSystem jobs(threads - 1); // The calling thread takes part in waits
+
+        const F64 for_time = Benchmark::measure(repetitions, [&]() {
+            jobs.parallel_for(ELEMENT_COUNT, BATCH_SIZE, [&](U32 begin, U32 end) {
+                for (U32 i = begin; i < end; ++i)
+                {
+                    results[i] = std::sin(values[i]) * std::cos(values[i]) + std::sqrt(values[i]);
+                }
+            });
+        });
+
+        Benchmark::keep(results[ELEMENT_COUNT / 2]);
+
+        const F64 empty_time = Benchmark::measure(repetitions, [&]() {
+            for (U32 round = 0; round < EMPTY_ROUNDS; ++round)
+            {
+                Core::JobCounter counter;
+
+                for (U32 i = 0; i < EMPTY_JOBS; ++i)
+                {
+                    jobs.run([]() {}, &counter);
+                }
+
+                jobs.wait(counter);
+            }
+        });
+
+        if (threads == 1)
+        {
+            single_thread_time = for_time;
+        }
+
+        CR_INFO("{:>8} {:>12.3f} {:>8.2f}x {:>14.0f}", threads, for_time * 1e3, single_thread_time / for_time, EMPTY_ROUNDS * EMPTY_JOBS / empty_time);
+    }
+
+    return 0;
+}
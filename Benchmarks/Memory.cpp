@@ -0,0 +1,157 @@
+#include "Benchmark.hpp"
+
+#include "Crunch/Memory.hpp"
+
+#include <random>
+
+// Per frame scratch containers on the default allocator against Crunch arenas. Every frame fills a few hundred
+// short lived vectors of submit sized structs, the sizes a frame of draw and barrier lists typically needs, and
+// drops them again. The arenas are rewound per frame instead of freeing anything.
+
+using namespace Cr;
+
+namespace
+{
+
+struct Info
+{
+    U64 handle;
+    U64 value;
+    U32 stages;
+    U32 flags;
+};
+
+constexpr U32 VECTORS_PER_FRAME = 512;
+
+// Element counts of every vector of a frame, the same for every allocator
+std::vector<U32> get_sizes()
+{
+    std::mt19937 random(1);
+    std::geometric_distribution<U32> size(0.1);
+
+    std::vector<U32> sizes(VECTORS_PER_FRAME);
+    std::ranges::generate(sizes, [&]() { return 1 + size(random); });
+
+    return sizes;
+}
+
+// Grows every vector element by element, as recording code does when it does not know the count up front
+template<typename Vector, typename Make>
+U64 fill_frame(const std::vector<U32>& sizes, Make&& make_vector)
+{
+    U64 checksum = 0;
+
+    for (const U32 size : sizes)
+    {
+        Vector infos = make_vector();
+
+        for (U32 i = 0; i < size; ++i)
+        {
+            infos.push_back({ .handle = i, .value = size, .stages = i, .flags = 0 });
+        }
+
+        checksum += infos.back().handle;
+        Benchmark::keep(infos.data());
+    }
+
+    return checksum;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions = Benchmark::get_option(argc, argv, "--repetitions", 10);
+    const U32 frames      = Benchmark::get_option(argc, argv, "--frames", 1000);
+
+    const std::vector<U32> sizes = get_sizes();
+
+    U64 infos_per_frame = 0;
+
+    for (const U32 size : sizes)
+    {
+        infos_per_frame += size;
+    }
+
+    CR_INFO("Memory: {} frames of {} vectors, {} infos per frame, best of {}", frames, VECTORS_PER_FRAME, infos_per_frame, repetitions);
+    CR_INFO("{:>24} {:>12} {:>12}", "Allocator", "frame us", "speedup");
+
+    const F64 default_time = Benchmark::measure(repetitions, [&]() {
+        for (U32 frame = 0; frame < frames; ++frame)
+        {
+            Benchmark::keep(fill_frame<std::vector<Info>>(sizes, []() { return std::vector<Info> {}; }));
+        }
+    });
+
+    const auto report = [&](const char* name, F64 time) {
+        CR_INFO("{:>24} {:>12.2f} {:>12.2f}", name, time / frames * 1e6, default_time / time);
+    };
+
+    report("std::allocator", default_time);
+
+    const F64 pmr_default_time = Benchmark::measure(repetitions, [&]() {
+        for (U32 frame = 0; frame < frames; ++frame)
+        {
+            Benchmark::keep(fill_frame<std::pmr::vector<Info>>(sizes, []() { return std::pmr::vector<Info> {}; }));
+        }
+    });
+
+    report("pmr default resource", pmr_default_time);
+
+    LinearArena arena;
+
+    const F64 arena_time = Benchmark::measure(repetitions, [&]() {
+        for (U32 frame = 0; frame < frames; ++frame)
+        {
+            arena.reset();
+            Benchmark::keep(fill_frame<std::pmr::vector<Info>>(sizes, [&]() { return std::pmr::vector<Info> { &arena }; }));
+        }
+    });
+
+    report("LinearArena", arena_time);
+
+    FrameArena frame_arena(3);
+
+    const F64 frame_arena_time = Benchmark::measure(repetitions, [&]() {
+        for (U32 frame = 0; frame < frames; ++frame)
+        {
+            frame_arena.begin_frame(frame % 3);
+            Benchmark::keep(fill_frame<std::pmr::vector<Info>>(sizes, [&]() { return std::pmr::vector<Info> { &frame_arena.get() }; }));
+        }
+    });
+
+    report("FrameArena", frame_arena_time);
+
+    // Queue::submit pattern, a stack buffer per call and reserved vectors
+    const F64 stack_time = Benchmark::measure(repetitions, [&]() {
+        for (U32 frame = 0; frame < frames; ++frame)
+        {
+            U64 checksum = 0;
+
+            for (const U32 size : sizes)
+            {
+                std::array<std::byte, 2048> scratch_buffer;
+                LinearArena scratch { scratch_buffer };
+
+                std::pmr::vector<Info> infos { &scratch };
+                infos.reserve(size);
+
+                for (U32 i = 0; i < size; ++i)
+                {
+                    infos.push_back({ .handle = i, .value = size, .stages = i, .flags = 0 });
+                }
+
+                checksum += infos.back().handle;
+                Benchmark::keep(infos.data());
+            }
+
+            Benchmark::keep(checksum);
+        }
+    });
+
+    report("stack LinearArena", stack_time);
+
+    CR_INFO("LinearArena kept {} KiB of blocks after warming up", arena.get_capacity() / 1024);
+
+    return 0;
+}
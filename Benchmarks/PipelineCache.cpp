@@ -0,0 +1,337 @@
+#include "Benchmark.hpp"
+
+#include "Graphics/Vulkan/PipelineCache.hpp"
+
+#include "Crunch/Filesystem.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+
+// Cold versus warm creation of a few hundred graphics pipelines through Vulkan::PipelineCache. The cold pass starts
+// from an empty cache and saves it to disk, the warm pass loads the file back through the header check. Disk caches
+// of the drivers themselves are turned off, otherwise every pass after the first would be warm.
+
+using namespace Cr;
+using namespace Cr::Graphics;
+
+static constexpr U32 VARIANT_COUNT = 192; // Values of the VARIANT specialization constant per repetition
+static constexpr U32 BLEND_COUNT   = 2;   // Blending off and on for every variant
+
+static constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+// Instance and device without a surface, the first one supporting Vulkan 1.3 and graphics is used
+class Context : public NoCopy, public NoMove
+{
+    public:
+        Context()
+        {
+            const VkApplicationInfo application_info {
+                .sType      = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                .apiVersion = VK_API_VERSION_1_3,
+            };
+
+            const VkInstanceCreateInfo instance_info {
+                .sType            = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                .pApplicationInfo = &application_info,
+            };
+
+            VK_ASSERT_THROW(vkCreateInstance(&instance_info, nullptr, &instance), "Failed to create Vulkan instance");
+
+            U32 device_count = 0;
+            VK_ASSERT_THROW(vkEnumeratePhysicalDevices(instance, &device_count, nullptr), "Failed to count physical devices");
+
+            std::vector<VkPhysicalDevice> devices(device_count);
+            VK_ASSERT_THROW(vkEnumeratePhysicalDevices(instance, &device_count, devices.data()), "Failed to get physical devices");
+
+            for (VkPhysicalDevice candidate : devices)
+            {
+                vkGetPhysicalDeviceProperties(candidate, &properties);
+
+                if (properties.apiVersion < VK_API_VERSION_1_3) { continue; }
+
+                U32 family_count = 0;
+                vkGetPhysicalDeviceQueueFamilyProperties(candidate, &family_count, nullptr);
+
+                std::vector<VkQueueFamilyProperties> families(family_count);
+                vkGetPhysicalDeviceQueueFamilyProperties(candidate, &family_count, families.data());
+
+                for (U32 family = 0; family < family_count; ++family)
+                {
+                    if (families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+                    {
+                        physical_device = candidate;
+                        family_index    = family;
+                        break;
+                    }
+                }
+
+                if (physical_device) { break; }
+            }
+
+            CR_ASSERT_THROW(physical_device != VK_NULL_HANDLE, "No Vulkan 1.3 device with a graphics queue");
+
+            const F32 priority = 1.0f;
+
+            const VkDeviceQueueCreateInfo queue_info {
+                .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                .queueFamilyIndex = family_index,
+                .queueCount       = 1,
+                .pQueuePriorities = &priority,
+            };
+
+            VkPhysicalDeviceVulkan13Features features_13 {
+                .sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+                .dynamicRendering = VK_TRUE,
+            };
+
+            const VkDeviceCreateInfo device_info {
+                .sType                = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+                .pNext                = &features_13,
+                .queueCreateInfoCount = 1,
+                .pQueueCreateInfos    = &queue_info,
+            };
+
+            VK_ASSERT_THROW(vkCreateDevice(physical_device, &device_info, nullptr, &device), "Failed to create Vulkan device");
+        }
+
+        ~Context()
+        {
+            vkDestroyDevice(device, nullptr);
+            vkDestroyInstance(instance, nullptr);
+        }
+
+        VkInstance                 instance        = VK_NULL_HANDLE;
+        VkPhysicalDevice           physical_device = VK_NULL_HANDLE;
+        VkDevice                   device          = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties properties      {};
+        U32                        family_index    = 0;
+};
+
+static VkShaderModule create_shader_module(VkDevice device, const std::filesystem::path& path)
+{
+    const MappedFile file(path);
+
+    const VkShaderModuleCreateInfo module_info {
+        .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = file.get_data().size(),
+        .pCode    = reinterpret_cast<const U32*>(file.get_data().data()),
+    };
+
+    VkShaderModule module;
+    VK_ASSERT_THROW(vkCreateShaderModule(device, &module_info, nullptr, &module), "Failed to create shader module {}", path.string());
+
+    return module;
+}
+
+// Creates every permutation one at a time like Vulkan::Shader does, variants start at first_variant
+static std::vector<VkPipeline> create_pipelines(VkDevice device, VkPipelineCache cache, VkPipelineLayout layout, VkShaderModule vertex, VkShaderModule fragment, U32 first_variant)
+{
+    std::vector<VkPipeline> pipelines;
+    pipelines.reserve(VARIANT_COUNT * BLEND_COUNT);
+
+    const VkPipelineVertexInputStateCreateInfo vertex_input {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+    };
+
+    const VkPipelineInputAssemblyStateCreateInfo input_assembly {
+        .sType    = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+    };
+
+    const VkPipelineViewportStateCreateInfo viewport {
+        .sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
+        .scissorCount  = 1,
+    };
+
+    const VkPipelineRasterizationStateCreateInfo rasterization {
+        .sType       = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode    = VK_CULL_MODE_NONE,
+        .frontFace   = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .lineWidth   = 1.0f,
+    };
+
+    const VkPipelineMultisampleStateCreateInfo multisample {
+        .sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+    };
+
+    const std::array<VkDynamicState, 2> dynamic_states { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+    const VkPipelineDynamicStateCreateInfo dynamic {
+        .sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = static_cast<U32>(dynamic_states.size()),
+        .pDynamicStates    = dynamic_states.data(),
+    };
+
+    const VkPipelineRenderingCreateInfo rendering {
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount    = 1,
+        .pColorAttachmentFormats = &COLOR_FORMAT,
+    };
+
+    const VkSpecializationMapEntry variant_entry {
+        .constantID = 0,
+        .offset     = 0,
+        .size       = sizeof(U32),
+    };
+
+    for (U32 variant = first_variant; variant < first_variant + VARIANT_COUNT; ++variant)
+    {
+        const VkSpecializationInfo specialization {
+            .mapEntryCount = 1,
+            .pMapEntries   = &variant_entry,
+            .dataSize      = sizeof(variant),
+            .pData         = &variant,
+        };
+
+        const std::array<VkPipelineShaderStageCreateInfo, 2> stages {
+            VkPipelineShaderStageCreateInfo {
+                .sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage  = VK_SHADER_STAGE_VERTEX_BIT,
+                .module = vertex,
+                .pName  = "main",
+            },
+            VkPipelineShaderStageCreateInfo {
+                .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage               = VK_SHADER_STAGE_FRAGMENT_BIT,
+                .module              = fragment,
+                .pName               = "main",
+                .pSpecializationInfo = &specialization,
+            },
+        };
+
+        for (U32 blend = 0; blend < BLEND_COUNT; ++blend)
+        {
+            const VkPipelineColorBlendAttachmentState attachment {
+                .blendEnable         = blend ? VK_TRUE : VK_FALSE,
+                .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+                .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                .colorBlendOp        = VK_BLEND_OP_ADD,
+                .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+                .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+                .alphaBlendOp        = VK_BLEND_OP_ADD,
+                .colorWriteMask      = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,
+            };
+
+            const VkPipelineColorBlendStateCreateInfo color_blend {
+                .sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+                .attachmentCount = 1,
+                .pAttachments    = &attachment,
+            };
+
+            const VkGraphicsPipelineCreateInfo pipeline_info {
+                .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext               = &rendering,
+                .stageCount          = static_cast<U32>(stages.size()),
+                .pStages             = stages.data(),
+                .pVertexInputState   = &vertex_input,
+                .pInputAssemblyState = &input_assembly,
+                .pViewportState      = &viewport,
+                .pRasterizationState = &rasterization,
+                .pMultisampleState   = &multisample,
+                .pColorBlendState    = &color_blend,
+                .pDynamicState       = &dynamic,
+                .layout              = layout,
+            };
+
+            VkPipeline pipeline;
+            VK_ASSERT_THROW(vkCreateGraphicsPipelines(device, cache, 1, &pipeline_info, nullptr, &pipeline), "Failed to create pipeline permutation {}", variant);
+
+            pipelines.push_back(pipeline);
+        }
+    }
+
+    return pipelines;
+}
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions = Benchmark::get_option(argc, argv, "--repetitions", 3);
+
+    // Mesa and NVIDIA keep their own shader caches on disk
+    setenv("MESA_SHADER_CACHE_DISABLE", "true", 1);
+    setenv("__GL_SHADER_DISK_CACHE",    "0",    1);
+
+    try
+    {
+        Context context;
+
+        const VkShaderModule vertex   = create_shader_module(context.device, CR_BENCHMARK_SHADER_DIR "/permutation.vert.spv");
+        const VkShaderModule fragment = create_shader_module(context.device, CR_BENCHMARK_SHADER_DIR "/permutation.frag.spv");
+
+        const VkPipelineLayoutCreateInfo layout_info {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        };
+
+        VkPipelineLayout layout;
+        VK_ASSERT_THROW(vkCreatePipelineLayout(context.device, &layout_info, nullptr, &layout), "Failed to create pipeline layout");
+
+        const std::filesystem::path cache_path = std::filesystem::temp_directory_path() / "crunch_benchmark_pipeline_cache.bin";
+
+        auto destroy_pipelines = [&](const std::vector<VkPipeline>& pipelines) {
+            for (VkPipeline pipeline : pipelines)
+            {
+                vkDestroyPipeline(context.device, pipeline, nullptr);
+            }
+        };
+
+        CR_INFO("PipelineCache: {} permutations on {}, best of {}", VARIANT_COUNT * BLEND_COUNT, context.properties.deviceName, repetitions);
+
+        F64 cold_time = std::numeric_limits<F64>::max();
+        F64 warm_time = std::numeric_limits<F64>::max();
+        U64 file_size = 0;
+
+        for (U32 repetition = 0; repetition < repetitions; ++repetition)
+        {
+            // New variants every repetition, so nothing the driver kept in memory from the last one is hit
+            const U32 first_variant = repetition * VARIANT_COUNT;
+
+            std::filesystem::remove(cache_path);
+
+            {
+                Vulkan::PipelineCache cache(context.device, context.properties, cache_path);
+
+                std::vector<VkPipeline> pipelines;
+                cold_time = std::min(cold_time, Benchmark::measure(1, [&]() {
+                    pipelines = create_pipelines(context.device, cache.get_native(), layout, vertex, fragment, first_variant);
+                }));
+
+                destroy_pipelines(pipelines);
+                cache.save();
+            }
+
+            file_size = std::filesystem::file_size(cache_path);
+
+            {
+                Vulkan::PipelineCache cache(context.device, context.properties, cache_path);
+
+                std::vector<VkPipeline> pipelines;
+                warm_time = std::min(warm_time, Benchmark::measure(1, [&]() {
+                    pipelines = create_pipelines(context.device, cache.get_native(), layout, vertex, fragment, first_variant);
+                }));
+
+                destroy_pipelines(pipelines);
+            }
+        }
+
+        std::filesystem::remove(cache_path);
+
+        vkDestroyPipelineLayout(context.device, layout, nullptr);
+        vkDestroyShaderModule(context.device, fragment, nullptr);
+        vkDestroyShaderModule(context.device, vertex,   nullptr);
+
+        CR_INFO("{:>8} {:>12} {:>14}", "Cache", "total ms", "us/pipeline");
+        CR_INFO("{:>8} {:>12.2f} {:>14.1f}", "cold", cold_time * 1e3, cold_time * 1e6 / (VARIANT_COUNT * BLEND_COUNT));
+        CR_INFO("{:>8} {:>12.2f} {:>14.1f}", "warm", warm_time * 1e3, warm_time * 1e6 / (VARIANT_COUNT * BLEND_COUNT));
+        CR_INFO("Warm is {:.1f}x faster, cache file {} KiB", cold_time / warm_time, file_size / 1024);
+    }
+    catch (const std::exception& e)
+    {
+        CR_ERROR("{}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+#version 450
+
+// Every value of VARIANT is a different program to the driver. The loop count depends on it, so each one is
+// unrolled and optimized on its own like a material permutation would be.
+layout(constant_id = 0) const uint VARIANT = 0;
+
+layout(location = 0) out vec4 color_out;
+
+void main()
+{
+    vec3 color = vec3(float(VARIANT & 0xFFu) / 255.0);
+
+    for (uint i = 0u; i < 8u + VARIANT % 8u; ++i)
+    {
+        color = fract(sin(color * float(VARIANT + i) + gl_FragCoord.xyx) * 43758.5453);
+    }
+
+    color_out = vec4(color, 1.0);
+}
@@ -0,0 +1,10 @@
+#version 450
+
+// Fullscreen triangle without vertex input, shared by every permutation of BenchmarkPipelineCache
+
+void main()
+{
+    const vec2 position = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,131 @@
+#include "Benchmark.hpp"
+
+#include "Crunch/Crunch.hpp"
+
+#include <ktx.h>
+
+// Basis transcoding throughput on one core, the work Graphics::AssetLoader runs per texture on a worker. A
+// procedural sRGB texture with alpha is encoded once to ETC1S and UASTC, then every repetition transcodes a fresh
+// copy of it to each target. Loading the payload is not timed, only ktxTexture2_TranscodeBasis is.
+
+using namespace Cr;
+
+namespace
+{
+
+struct Target
+{
+    ktx_transcode_fmt_e format;
+    const char*         name;
+};
+
+constexpr Target TARGETS[] = {
+    { KTX_TTF_BC7_RGBA,      "BC7"       },
+    { KTX_TTF_BC3_RGBA,      "BC3"       },
+    { KTX_TTF_BC1_RGB,       "BC1"       },
+    { KTX_TTF_ASTC_4x4_RGBA, "ASTC 4x4"  },
+    { KTX_TTF_ETC2_RGBA,     "ETC2 RGBA" },
+    { KTX_TTF_ETC1_RGB,      "ETC1 RGB"  },
+    { KTX_TTF_RGBA32,        "RGBA8"     },
+};
+
+void check(KTX_error_code result, const char* what)
+{
+    CR_ASSERT_THROW(result == KTX_SUCCESS, "{} failed: {}", what, ktxErrorString(result));
+}
+
+// Smooth gradients with a few hard edges and a varying alpha, roughly what a game texture gives the encoder
+std::vector<U8> encode(U32 size, bool uastc)
+{
+    ktxTextureCreateInfo info {
+        .vkFormat        = 43, // VK_FORMAT_R8G8B8A8_SRGB
+        .baseWidth       = size,
+        .baseHeight      = size,
+        .baseDepth       = 1,
+        .numDimensions   = 2,
+        .numLevels       = 1,
+        .numLayers       = 1,
+        .numFaces        = 1,
+        .isArray         = KTX_FALSE,
+        .generateMipmaps = KTX_FALSE,
+    };
+
+    ktxTexture2* texture = nullptr;
+    check(ktxTexture2_Create(&info, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &texture), "Creating the source texture");
+
+    std::vector<U8> texels(std::size_t(size) * size * 4);
+
+    for (U32 y = 0; y < size; ++y)
+    {
+        for (U32 x = 0; x < size; ++x)
+        {
+            U8* texel = &texels[(std::size_t(y) * size + x) * 4];
+
+            texel[0] = U8(x * 255 / size);
+            texel[1] = U8(y * 255 / size);
+            texel[2] = ((x / 64) + (y / 64)) % 2 == 0 ? 200 : 40;
+            texel[3] = U8((x ^ y) & 0xFF);
+        }
+    }
+
+    check(ktxTexture_SetImageFromMemory(ktxTexture(texture), 0, 0, 0, texels.data(), texels.size()), "Setting the source texels");
+
+    ktxBasisParams params {};
+    params.structSize   = sizeof(params);
+    params.uastc        = uastc ? KTX_TRUE : KTX_FALSE;
+    params.threadCount  = 1;
+    params.qualityLevel = 128;
+
+    check(ktxTexture2_CompressBasisEx(texture, &params), "Basis encoding");
+
+    U8*        data = nullptr;
+    ktx_size_t data_size = 0;
+    check(ktxTexture_WriteToMemory(ktxTexture(texture), &data, &data_size), "Writing the encoded texture");
+
+    std::vector<U8> file(data, data + data_size);
+
+    std::free(data);
+    ktxTexture_Destroy(ktxTexture(texture));
+
+    return file;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const U32 repetitions = Benchmark::get_option(argc, argv, "--repetitions", 5);
+    const U32 size        = Benchmark::get_option(argc, argv, "--size", 1024);
+
+    CR_INFO("Transcode: {}x{} sRGB texture with alpha, one core, best of {}, Mtexels/s", size, size, repetitions);
+    CR_INFO("{:>8} {:>12} {:>12}", "Source", "Target", "Mtexels/s");
+
+    for (const bool uastc : { false, true })
+    {
+        const std::vector<U8> file = encode(size, uastc);
+
+        for (const Target& target : TARGETS)
+        {
+            F64 best = std::numeric_limits<F64>::max();
+
+            for (U32 i = 0; i < repetitions; ++i)
+            {
+                ktxTexture2* texture = nullptr;
+                check(ktxTexture2_CreateFromMemory(file.data(), file.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture), "Loading the encoded texture");
+
+                const auto begin = Benchmark::Clock::now();
+                check(ktxTexture2_TranscodeBasis(texture, target.format, 0), "Transcoding");
+                const auto end   = Benchmark::Clock::now();
+
+                Benchmark::keep(texture->pData);
+                ktxTexture_Destroy(ktxTexture(texture));
+
+                best = std::min(best, std::chrono::duration<F64>(end - begin).count());
+            }
+
+            CR_INFO("{:>8} {:>12} {:>12.1f}", uastc ? "UASTC" : "ETC1S", target.name, F64(size) * size / best * 1e-6);
+        }
+    }
+
+    return 0;
+}
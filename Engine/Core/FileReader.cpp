@@ -0,0 +1,364 @@
+#include "Core/FileReader.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __linux__
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace Cr::Core
+{
+
+namespace
+{
+
+// Reads larger than this come back short anyway, the rest is resubmitted
+constexpr U64 MAX_READ_SIZE = 1ull << 30;
+
+// Ring indices are shared with the kernel, which reads and writes them concurrently
+U32 load_acquire(U32* value)
+{
+    return std::atomic_ref<U32>(*value).load(std::memory_order_acquire);
+}
+
+void store_release(U32* value, U32 new_value)
+{
+    std::atomic_ref<U32>(*value).store(new_value, std::memory_order_release);
+}
+
+} // namespace
+
+FileReader::FileReader(Core::JobSystem& jobs, U32 queue_depth)
+    : m_jobs(jobs)
+    , m_queue_depth(queue_depth)
+{
+    CR_ASSERT_THROW(queue_depth > 0, "File reader queue depth must be non-zero");
+
+    if (!create_ring(queue_depth))
+    {
+        CR_WARN("io_uring unavailable ({}), reading files on the job system", std::strerror(errno));
+    }
+}
+
+FileReader::~FileReader()
+{
+    // The kernel and the workers write into request buffers until their reads complete
+    if (uses_io_uring())
+    {
+        m_queued.clear();
+
+        // Not through wait(), which returns right away while unpolled completions are left
+        while (m_in_flight > 0)
+        {
+            wait_for_ring();
+            reap();
+        }
+
+        destroy_ring();
+    }
+    else
+    {
+        m_jobs.wait(m_reading);
+    }
+
+    for (const auto& [id, request] : m_requests)
+    {
+        ::close(request->file);
+    }
+}
+
+FileReader::ReadID FileReader::read(const std::filesystem::path& path)
+{
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    CR_ASSERT_THROW(file >= 0, "Failed to open {}: {}", path.string(), std::strerror(errno));
+
+    struct stat info {};
+
+    if (::fstat(file, &info) != 0)
+    {
+        const int error = errno;
+        ::close(file);
+
+        CR_ASSERT_THROW(false, "Failed to stat {}: {}", path.string(), std::strerror(error));
+    }
+
+    auto request = create_unique<Request>();
+
+    request->id   = m_next_id++;
+    request->file = file;
+    request->data.resize(static_cast<std::size_t>(info.st_size));
+
+    Request& queued = *request;
+    m_requests.emplace(queued.id, std::move(request));
+
+    if (queued.data.empty())
+    {
+        complete(queued, 0);
+    }
+    else if (uses_io_uring())
+    {
+        if (m_in_flight < m_queue_depth)
+        {
+            ++m_in_flight;
+            submit(queued);
+        }
+        else
+        {
+            m_queued.push_back(&queued);
+        }
+    }
+    else
+    {
+        // Requests are only erased by poll() on this thread, after the job has reported back
+        m_jobs.run([this, &queued]()
+        {
+            I32 error = 0;
+
+            while (queued.offset < queued.data.size())
+            {
+                const ssize_t size = ::pread(queued.file, queued.data.data() + queued.offset,
+                                             queued.data.size() - queued.offset, static_cast<off_t>(queued.offset));
+
+                if (size < 0 && errno == EINTR) { continue; }
+                if (size <= 0) { error = size < 0 ? errno : EIO; break; }
+
+                queued.offset += static_cast<U64>(size);
+            }
+
+            std::lock_guard lock { m_mutex };
+            m_finished.push_back({ queued.id, error });
+        }, &m_reading);
+    }
+
+    return queued.id;
+}
+
+std::vector<FileReader::Completion> FileReader::poll()
+{
+    if (uses_io_uring())
+    {
+        reap();
+    }
+    else
+    {
+        std::vector<Finished> finished;
+
+        {
+            std::lock_guard lock { m_mutex };
+            finished.swap(m_finished);
+        }
+
+        for (const Finished& read : finished)
+        {
+            complete(*m_requests.at(read.id), read.error);
+        }
+    }
+
+    return std::exchange(m_completed, {});
+}
+
+void FileReader::wait()
+{
+    if (!m_completed.empty()) { return; }
+
+    if (uses_io_uring())
+    {
+        if (m_in_flight > 0) { wait_for_ring(); }
+
+        return;
+    }
+
+    // Jobs can not be waited on one at a time, helps the workers with all remaining reads
+    m_jobs.wait(m_reading);
+}
+
+bool FileReader::create_ring(U32 queue_depth)
+{
+#if __linux__
+    io_uring_params params {};
+
+    const long ring_file = ::syscall(__NR_io_uring_setup, queue_depth, &params);
+
+    if (ring_file < 0) { return false; }
+
+    m_ring_file = static_cast<int>(ring_file);
+
+    // Every request has at most one read in flight, so the queue never holds more than queue_depth entries
+    m_queue_depth = std::min(queue_depth, params.sq_entries);
+
+    m_ring.sq_mapping_size = params.sq_off.array + params.sq_entries * sizeof(U32);
+    m_ring.cq_mapping_size = params.cq_off.cqes  + params.cq_entries * sizeof(io_uring_cqe);
+    m_ring.sqes_size       = params.sq_entries * sizeof(io_uring_sqe);
+
+    const bool single_mapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+    if (single_mapping)
+    {
+        m_ring.sq_mapping_size = std::max(m_ring.sq_mapping_size, m_ring.cq_mapping_size);
+    }
+
+    auto map = [this](std::size_t size, off_t offset) -> void*
+    {
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_file, offset);
+        return mapping == MAP_FAILED ? nullptr : mapping;
+    };
+
+    m_ring.sq_mapping = map(m_ring.sq_mapping_size, IORING_OFF_SQ_RING);
+    m_ring.cq_mapping = single_mapping ? m_ring.sq_mapping : map(m_ring.cq_mapping_size, IORING_OFF_CQ_RING);
+    m_ring.sqes       = map(m_ring.sqes_size, IORING_OFF_SQES);
+
+    if (m_ring.sq_mapping == nullptr || m_ring.cq_mapping == nullptr || m_ring.sqes == nullptr)
+    {
+        const int error = errno;
+        destroy_ring();
+        errno = error;
+
+        return false;
+    }
+
+    auto* sq = static_cast<U8*>(m_ring.sq_mapping);
+    auto* cq = static_cast<U8*>(m_ring.cq_mapping);
+
+    m_ring.sq_head  = reinterpret_cast<U32*>(sq + params.sq_off.head);
+    m_ring.sq_tail  = reinterpret_cast<U32*>(sq + params.sq_off.tail);
+    m_ring.sq_mask  = reinterpret_cast<U32*>(sq + params.sq_off.ring_mask);
+    m_ring.sq_array = reinterpret_cast<U32*>(sq + params.sq_off.array);
+
+    m_ring.cq_head = reinterpret_cast<U32*>(cq + params.cq_off.head);
+    m_ring.cq_tail = reinterpret_cast<U32*>(cq + params.cq_off.tail);
+    m_ring.cq_mask = reinterpret_cast<U32*>(cq + params.cq_off.ring_mask);
+    m_ring.cqes    = cq + params.cq_off.cqes;
+
+    return true;
+#else
+    (void)queue_depth;
+
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+void FileReader::destroy_ring()
+{
+#if __linux__
+    if (m_ring.sqes != nullptr) { ::munmap(m_ring.sqes, m_ring.sqes_size); }
+
+    if (m_ring.cq_mapping != nullptr && m_ring.cq_mapping != m_ring.sq_mapping)
+    {
+        ::munmap(m_ring.cq_mapping, m_ring.cq_mapping_size);
+    }
+
+    if (m_ring.sq_mapping != nullptr) { ::munmap(m_ring.sq_mapping, m_ring.sq_mapping_size); }
+
+    ::close(m_ring_file);
+
+    m_ring      = {};
+    m_ring_file = -1;
+#endif
+}
+
+void FileReader::submit(Request& request)
+{
+#if __linux__
+    // Only this thread produces, the kernel consumes from sq_head
+    const U32 tail  = *m_ring.sq_tail;
+    const U32 index = tail & *m_ring.sq_mask;
+
+    io_uring_sqe& sqe = static_cast<io_uring_sqe*>(m_ring.sqes)[index];
+
+    sqe           = {};
+    sqe.opcode    = IORING_OP_READ;
+    sqe.fd        = request.file;
+    sqe.off       = request.offset;
+    sqe.addr      = reinterpret_cast<U64>(request.data.data() + request.offset);
+    sqe.len       = static_cast<U32>(std::min<U64>(request.data.size() - request.offset, MAX_READ_SIZE));
+    sqe.user_data = request.id;
+
+    m_ring.sq_array[index] = index;
+    store_release(m_ring.sq_tail, tail + 1);
+
+    long submitted;
+    while ((submitted = ::syscall(__NR_io_uring_enter, m_ring_file, 1, 0, 0, nullptr, 0)) < 0 && errno == EINTR) {}
+
+    CR_ASSERT_THROW(submitted == 1, "Failed to submit file read: {}", std::strerror(errno));
+#else
+    (void)request;
+#endif
+}
+
+void FileReader::wait_for_ring()
+{
+#if __linux__
+    while (::syscall(__NR_io_uring_enter, m_ring_file, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno == EINTR) {}
+#endif
+}
+
+void FileReader::reap()
+{
+#if __linux__
+    U32 head = *m_ring.cq_head;
+
+    for (const U32 tail = load_acquire(m_ring.cq_tail); head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = static_cast<const io_uring_cqe*>(m_ring.cqes)[head & *m_ring.cq_mask];
+
+        Request& request = *m_requests.at(cqe.user_data);
+
+        const I32 result = cqe.res;
+
+        if (result == -EINTR || result == -EAGAIN)
+        {
+            submit(request);
+        }
+        else if (result <= 0)
+        {
+            --m_in_flight;
+            complete(request, result < 0 ? -result : EIO); // Nothing read means the file shrank
+        }
+        else if ((request.offset += static_cast<U64>(result)) < request.data.size())
+        {
+            submit(request);
+        }
+        else
+        {
+            --m_in_flight;
+            complete(request, 0);
+        }
+    }
+
+    store_release(m_ring.cq_head, head);
+
+    while (!m_queued.empty() && m_in_flight < m_queue_depth)
+    {
+        ++m_in_flight;
+        submit(*m_queued.front());
+        m_queued.pop_front();
+    }
+#endif
+}
+
+void FileReader::complete(Request& request, I32 error)
+{
+    const ReadID id = request.id;
+
+    ::close(request.file);
+
+    m_completed.push_back({
+        .id    = id,
+        .error = error,
+        .data  = error == 0 ? std::move(request.data) : std::vector<U8>{},
+    });
+
+    m_requests.erase(id);
+}
+
+} // namespace Cr::Core
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+namespace Cr::Core
+{
+
+// Reads whole files in the background. Reads go through an io_uring submission queue where the kernel supports
+// it, otherwise every read is a blocking job on the job system. Files are opened on the calling thread, so a
+// missing file throws right away, everything after that overlaps with the caller.
+// Must be driven from the thread that created the job system.
+class FileReader : public NoCopy, public NoMove
+{
+    public:
+        using ReadID = U64;
+
+        struct Completion
+        {
+            ReadID          id    = 0;
+            I32             error = 0; // errno of the failed read, 0 on success
+            std::vector<U8> data;
+        };
+
+        FileReader() = delete;
+        explicit FileReader(Core::JobSystem& jobs, U32 queue_depth = 64); // Reads in flight at once
+        ~FileReader(); // Waits for the reads in flight
+
+        [[nodiscard]] ReadID read(const std::filesystem::path& path);
+
+        // Reads finished since the last call in completion order, never blocks
+        [[nodiscard]] std::vector<Completion> poll();
+
+        // Blocks until at least one read has finished, returns right away when none is pending. Without io_uring
+        // it helps the workers until every read in flight has finished.
+        void wait();
+
+        [[nodiscard]] U32 get_pending_count() const { return static_cast<U32>(m_requests.size()); }
+
+        [[nodiscard]] constexpr bool uses_io_uring() const { return m_ring_file != -1; }
+
+    private:
+        struct Request
+        {
+            ReadID          id     = 0;
+            int             file   = -1;
+            U64             offset = 0; // Bytes read so far
+            std::vector<U8> data;
+        };
+
+        struct Finished
+        {
+            ReadID id;
+            I32    error;
+        };
+
+        // Shared with the kernel, the completion ring may live in the submission ring mapping
+        struct Ring
+        {
+            void* sq_mapping = nullptr;
+            void* cq_mapping = nullptr;
+            void* sqes       = nullptr;
+
+            std::size_t sq_mapping_size = 0;
+            std::size_t cq_mapping_size = 0;
+            std::size_t sqes_size       = 0;
+
+            U32* sq_head  = nullptr;
+            U32* sq_tail  = nullptr;
+            U32* sq_mask  = nullptr;
+            U32* sq_array = nullptr;
+
+            U32*  cq_head = nullptr;
+            U32*  cq_tail = nullptr;
+            U32*  cq_mask = nullptr;
+            void* cqes    = nullptr;
+        };
+
+        [[nodiscard]] bool create_ring(U32 queue_depth);
+        void destroy_ring();
+
+        // Queues the next part of the request and hands it to the kernel
+        void submit(Request& request);
+
+        // Blocks until the completion ring holds at least one entry, whatever was already moved to m_completed
+        void wait_for_ring();
+
+        // Moves ring completions to m_completed, resubmitting requests that were only partly read
+        void reap();
+
+        void complete(Request& request, I32 error);
+
+        Core::JobSystem& m_jobs;
+
+        int  m_ring_file = -1; // -1 without io_uring
+        Ring m_ring {};
+
+        U32 m_queue_depth = 0;
+        U32 m_in_flight   = 0; // Requests handed to the kernel, one read each
+
+        ReadID m_next_id = 1;
+
+        std::unordered_map<ReadID, Unique<Request>> m_requests;
+        std::deque<Request*>                        m_queued; // Waiting for room in the ring
+
+        std::vector<Completion> m_completed;
+
+        // Fallback reads, finished by the workers
+        Core::JobCounter      m_reading;
+        std::mutex            m_mutex;
+        std::vector<Finished> m_finished;
+};
+
+} // namespace Cr::Core
@@ -0,0 +1,389 @@
+#include "Core/Jobs.hpp"
+
+#include <thread>
+
+namespace Cr::Core
+{
+
+static constexpr U32 JOB_POOL_SIZE  = 4096; // Per thread, power of two
+static constexpr U32 JOB_QUEUE_SIZE = 4096; // Per thread, power of two
+
+static_assert((JOB_POOL_SIZE  & (JOB_POOL_SIZE  - 1)) == 0);
+static_assert((JOB_QUEUE_SIZE & (JOB_QUEUE_SIZE - 1)) == 0);
+
+static thread_local U32 t_thread_index = JobSystem::INVALID_THREAD_INDEX;
+
+struct Job
+{
+    JobFunction       function;
+    JobCounter*       counter = nullptr;
+    std::atomic<bool> in_use  = false;
+};
+
+// Chase-Lev deque, Lê et al. "Correct and Efficient Work-Stealing for Weak Memory Models" (2013)
+// Owner pushes and pops at the bottom, thieves steal from the top.
+class WorkStealingDeque : public NoCopy, public NoMove
+{
+    public:
+        WorkStealingDeque() = default;
+        ~WorkStealingDeque() = default;
+
+        [[nodiscard]] bool push(Job* job)
+        {
+            const I64 bottom = m_bottom.load(std::memory_order_relaxed);
+            const I64 top    = m_top.load(std::memory_order_acquire);
+
+            if (bottom - top >= I64(JOB_QUEUE_SIZE)) { return false; }
+
+            m_buffer[bottom & (JOB_QUEUE_SIZE - 1)].store(job, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        [[nodiscard]] Job* pop()
+        {
+            const I64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            I64 top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = m_buffer[bottom & (JOB_QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+            if (top == bottom)
+            {
+                // Last element, race against thieves
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    job = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return job;
+        }
+
+        [[nodiscard]] Job* steal()
+        {
+            I64 top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const I64 bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom) { return nullptr; }
+
+            Job* job = m_buffer[top & (JOB_QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return nullptr;
+            }
+
+            return job;
+        }
+
+    private:
+        alignas(64) std::atomic<I64> m_top    {0};
+        alignas(64) std::atomic<I64> m_bottom {0};
+
+        std::array<std::atomic<Job*>, JOB_QUEUE_SIZE> m_buffer {};
+};
+
+struct JobSystem::Worker
+{
+    std::thread       thread; // Not joinable for the creating thread
+    WorkStealingDeque queue;
+
+    std::array<Job, JOB_POOL_SIZE> jobs;
+    U32 next_job = 0;
+
+    U32 random_state = 0;
+};
+
+JobSystem::JobSystem(U32 worker_count)
+{
+    CR_ASSERT_THROW(t_thread_index == INVALID_THREAD_INDEX, "Thread already belongs to a job system");
+
+    m_workers.reserve(worker_count + 1);
+    for (U32 i = 0; i <= worker_count; ++i)
+    {
+        m_workers.push_back(create_unique<Worker>());
+        m_workers.back()->random_state = 0x9E3779B9u * (i + 1);
+    }
+
+    t_thread_index = 0;
+
+    for (U32 i = 1; i <= worker_count; ++i)
+    {
+        m_workers[i]->thread = std::thread(&JobSystem::worker_loop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    m_running.store(false, std::memory_order_release);
+
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+
+    t_thread_index = INVALID_THREAD_INDEX;
+}
+
+U32 JobSystem::get_thread_index()
+{
+    return t_thread_index;
+}
+
+void JobSystem::run(JobFunction function, JobCounter* counter)
+{
+    Job& job = allocate_job(std::move(function), counter);
+
+    if (counter)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    schedule(job);
+}
+
+void JobSystem::run_after(JobCounter& dependency, JobFunction function, JobCounter* counter)
+{
+    Job& job = allocate_job(std::move(function), counter);
+
+    if (counter)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard lock(dependency.m_mutex);
+
+        if (!dependency.is_done())
+        {
+            dependency.m_continuations.push_back(&job);
+            return;
+        }
+    }
+
+    schedule(job);
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    const U32 index = t_thread_index;
+    CR_ASSERT(index < m_workers.size(), "Waiting on jobs from a thread outside of the job system");
+
+    while (!counter.is_done())
+    {
+        if (Job* job = find_job(index))
+        {
+            execute(*job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Let the thread that finished the counter release it before the caller is allowed to destroy it
+    std::unique_lock lock(counter.m_mutex);
+
+    if (std::exception_ptr exception = std::exchange(counter.m_exception, nullptr))
+    {
+        lock.unlock();
+        std::rethrow_exception(exception);
+    }
+}
+
+void JobSystem::worker_loop(U32 index)
+{
+    t_thread_index = index;
+
+    while (m_running.load(std::memory_order_acquire))
+    {
+        if (Job* job = find_job(index))
+        {
+            execute(*job);
+            continue;
+        }
+
+        // Sample the signal before the second look so a push in between can't be missed
+        const U32 signal = m_signal.load(std::memory_order_acquire);
+
+        if (Job* job = find_job(index))
+        {
+            execute(*job);
+            continue;
+        }
+
+        m_signal.wait(signal, std::memory_order_acquire);
+    }
+}
+
+Job* JobSystem::find_job(U32 index)
+{
+    Worker& self = *m_workers[index];
+
+    if (Job* job = self.queue.pop())
+    {
+        return job;
+    }
+
+    const U32 count = static_cast<U32>(m_workers.size());
+
+    // xorshift32 for the first victim, then walk through the rest
+    self.random_state ^= self.random_state << 13;
+    self.random_state ^= self.random_state >> 17;
+    self.random_state ^= self.random_state << 5;
+
+    const U32 first = self.random_state % count;
+
+    for (U32 i = 0; i < count; ++i)
+    {
+        const U32 victim = (first + i) % count;
+
+        if (victim == index) { continue; }
+
+        if (Job* job = m_workers[victim]->queue.steal())
+        {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+Job& JobSystem::allocate_job(JobFunction&& function, JobCounter* counter)
+{
+    const U32 index = t_thread_index;
+    CR_ASSERT_THROW(index < m_workers.size(), "Submitting jobs from a thread outside of the job system");
+
+    Worker& self = *m_workers[index];
+
+    while (true)
+    {
+        for (U32 attempt = 0; attempt < JOB_POOL_SIZE; ++attempt)
+        {
+            Job& job = self.jobs[self.next_job++ & (JOB_POOL_SIZE - 1)];
+
+            if (!job.in_use.load(std::memory_order_acquire))
+            {
+                job.function = std::move(function);
+                job.counter  = counter;
+                job.in_use.store(true, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        // Whole pool in flight, help drain it
+        if (Job* job = find_job(index))
+        {
+            execute(*job);
+        }
+    }
+}
+
+void JobSystem::schedule(Job& job)
+{
+    const U32 index = t_thread_index;
+    CR_ASSERT_THROW(index < m_workers.size(), "Scheduling jobs from a thread outside of the job system");
+
+    Worker& self = *m_workers[index];
+
+    if (!self.queue.push(&job))
+    {
+        execute(job); // Queue full, no point in deferring
+        return;
+    }
+
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_one();
+}
+
+void JobSystem::execute(Job& job)
+{
+    std::exception_ptr exception;
+
+    try
+    {
+        job.function();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    JobCounter* counter = job.counter;
+
+    job.function = nullptr;
+    job.counter  = nullptr;
+    job.in_use.store(false, std::memory_order_release);
+
+    if (counter == nullptr)
+    {
+        if (exception)
+        {
+            try
+            {
+                std::rethrow_exception(exception);
+            }
+            catch (const std::exception& error)
+            {
+                CR_ERROR("Uncaught exception in job: {}", error.what());
+            }
+            catch (...)
+            {
+                CR_ERROR("Uncaught exception in job");
+            }
+        }
+        return;
+    }
+
+    // Stored before the decrement, so the waiter seeing zero also sees the exception
+    if (exception)
+    {
+        std::lock_guard lock(counter->m_mutex);
+
+        if (!counter->m_exception)
+        {
+            counter->m_exception = exception;
+        }
+    }
+
+    U32 pending = counter->m_pending.load(std::memory_order_relaxed);
+    while (pending > 1 && !counter->m_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) {}
+
+    if (pending > 1) { return; }
+
+    // Possibly the last job, finish under the lock so waiters can't destroy the counter underneath
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard lock(counter->m_mutex);
+
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            continuations.swap(counter->m_continuations);
+        }
+    }
+
+    for (Job* continuation : continuations)
+    {
+        schedule(*continuation);
+    }
+}
+
+} // namespace Cr::Core
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace Cr::Core
+{
+
+struct Job;
+
+using JobFunction = std::function<void()>;
+
+// Number of jobs still pending in a group, jobs can be chained to run once it reaches zero. The first exception
+// thrown by a job of the group is kept and rethrown by the wait on it.
+class JobCounter : public NoCopy, public NoMove
+{
+    public:
+        JobCounter() = default;
+        ~JobCounter() = default;
+
+        [[nodiscard]] bool is_done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<U32> m_pending {0};
+
+        mutable std::mutex m_mutex;
+        std::vector<Job*>  m_continuations;
+
+        mutable std::exception_ptr m_exception; // Cleared when rethrown
+
+};
+
+// Fixed pool of workers, each owning a work-stealing deque. Jobs can only be submitted from the
+// thread that created the system or from inside other jobs.
+//
+// A throwing job still completes: its counter is decremented and its continuations run. Exceptions of jobs without
+// a counter have nobody to report to and are logged.
+class JobSystem : public NoCopy, public NoMove
+{
+    public:
+        static constexpr U32 INVALID_THREAD_INDEX = ~0u;
+
+        JobSystem() = delete;
+        explicit JobSystem(U32 worker_count); // Excludes the creating thread, which takes part in waits
+        ~JobSystem();
+
+        void run(JobFunction function, JobCounter* counter = nullptr);
+        void run_after(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+
+        // Executes pending jobs on the calling thread until the counter reaches zero, then rethrows the first
+        // exception of its jobs
+        void wait(const JobCounter& counter);
+
+        // Splits [0, count) into batches of batch_size and calls function(begin, end) for each in parallel.
+        // Every batch has finished when it returns or throws.
+        template<typename F>
+        void parallel_for(U32 count, U32 batch_size, F&& function);
+
+        [[nodiscard]] U32 get_thread_count() const { return static_cast<U32>(m_workers.size()); }
+
+        // 0 for the creating thread, 1..N for workers and INVALID_THREAD_INDEX for everything else
+        [[nodiscard]] static U32 get_thread_index();
+
+    private:
+        struct Worker;
+
+        void worker_loop(U32 index);
+
+        [[nodiscard]] Job* find_job(U32 index);
+        [[nodiscard]] Job& allocate_job(JobFunction&& function, JobCounter* counter);
+
+        void schedule(Job& job);
+        void execute(Job& job);
+
+        std::vector<Unique<Worker>> m_workers;
+
+        std::atomic<U32>  m_signal  {0};
+        std::atomic<bool> m_running {true};
+};
+
+template<typename F>
+void JobSystem::parallel_for(U32 count, U32 batch_size, F&& function)
+{
+    CR_ASSERT(batch_size > 0, "parallel_for batch size must be non-zero");
+
+    JobCounter counter;
+
+    for (U32 begin = 0; begin < count; begin += batch_size)
+    {
+        const U32 end = std::min(begin + batch_size, count);
+        run([&function, begin, end]() { function(begin, end); }, &counter);
+    }
+
+    wait(counter);
+}
+
+} // namespace Cr::Core
@@ -0,0 +1,446 @@
+#include "Crunch/BatchMath.hpp"
+
+#if CR_ARCH_X86
+    #include <immintrin.h>
+#endif
+
+namespace Cr
+{
+
+namespace
+{
+
+// Kernels process [begin, end) in whole vectors and return where they stopped, the scalar kernels finish the tail
+
+using ComposeKernel = std::size_t (*)(const Vec3Span& translations, const QuatSpan& rotations, const Vec3Span& scales, Mat4f* matrices, std::size_t begin, std::size_t end);
+using PointKernel   = std::size_t (*)(const Mat4f& matrix, const Vec3Span& points, const Vec3SpanOut& results, std::size_t begin, std::size_t end);
+using AABBKernel    = std::size_t (*)(const Mat4f& matrix, const Vec3Span& centers, const Vec3Span& extents, const Vec3SpanOut& result_centers, const Vec3SpanOut& result_extents, std::size_t begin, std::size_t end);
+
+std::size_t compose_transforms_scalar(const Vec3Span& t, const QuatSpan& q, const Vec3Span& s, Mat4f* matrices, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const F32 x2 = q.x[i] * 2.0f;
+        const F32 y2 = q.y[i] * 2.0f;
+        const F32 z2 = q.z[i] * 2.0f;
+
+        const F32 xx = q.x[i] * x2, yy = q.y[i] * y2, zz = q.z[i] * z2;
+        const F32 xy = q.x[i] * y2, xz = q.x[i] * z2, yz = q.y[i] * z2;
+        const F32 wx = q.w[i] * x2, wy = q.w[i] * y2, wz = q.w[i] * z2;
+
+        matrices[i][0] = Vec4f((1.0f - (yy + zz)) * s.x[i], (xy + wz) * s.x[i], (xz - wy) * s.x[i], 0.0f);
+        matrices[i][1] = Vec4f((xy - wz) * s.y[i], (1.0f - (xx + zz)) * s.y[i], (yz + wx) * s.y[i], 0.0f);
+        matrices[i][2] = Vec4f((xz + wy) * s.z[i], (yz - wx) * s.z[i], (1.0f - (xx + yy)) * s.z[i], 0.0f);
+        matrices[i][3] = Vec4f(t.x[i], t.y[i], t.z[i], 1.0f);
+    }
+
+    return end;
+}
+
+std::size_t transform_points_scalar(const Mat4f& m, const Vec3Span& p, const Vec3SpanOut& r, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const F32 x = p.x[i], y = p.y[i], z = p.z[i];
+
+        r.x[i] = m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0];
+        r.y[i] = m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1];
+        r.z[i] = m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2];
+    }
+
+    return end;
+}
+
+// Arvo, the new half extent is the absolute linear part applied to the old one
+std::size_t transform_aabbs_scalar(const Mat4f& m, const Vec3Span& c, const Vec3Span& e, const Vec3SpanOut& rc, const Vec3SpanOut& re, std::size_t begin, std::size_t end)
+{
+    transform_points_scalar(m, c, rc, begin, end);
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const F32 x = e.x[i], y = e.y[i], z = e.z[i];
+
+        re.x[i] = std::abs(m[0][0]) * x + std::abs(m[1][0]) * y + std::abs(m[2][0]) * z;
+        re.y[i] = std::abs(m[0][1]) * x + std::abs(m[1][1]) * y + std::abs(m[2][1]) * z;
+        re.z[i] = std::abs(m[0][2]) * x + std::abs(m[1][2]) * y + std::abs(m[2][2]) * z;
+    }
+
+    return end;
+}
+
+#if CR_ARCH_X86
+
+// Rows of one column for four matrices in, that column of each matrix out
+inline void store_column(Mat4f* matrices, U32 column, __m128 row0, __m128 row1, __m128 row2, __m128 row3)
+{
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    _mm_storeu_ps(&matrices[0][column].x, row0);
+    _mm_storeu_ps(&matrices[1][column].x, row1);
+    _mm_storeu_ps(&matrices[2][column].x, row2);
+    _mm_storeu_ps(&matrices[3][column].x, row3);
+}
+
+std::size_t compose_transforms_sse(const Vec3Span& t, const QuatSpan& q, const Vec3Span& s, Mat4f* matrices, std::size_t begin, std::size_t end)
+{
+    const __m128 one  = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    std::size_t i = begin;
+
+    for (; i + 4 <= end; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(q.x.data() + i);
+        const __m128 y = _mm_loadu_ps(q.y.data() + i);
+        const __m128 z = _mm_loadu_ps(q.z.data() + i);
+        const __m128 w = _mm_loadu_ps(q.w.data() + i);
+
+        const __m128 x2 = _mm_add_ps(x, x);
+        const __m128 y2 = _mm_add_ps(y, y);
+        const __m128 z2 = _mm_add_ps(z, z);
+
+        const __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+        const __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+        const __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+
+        const __m128 sx = _mm_loadu_ps(s.x.data() + i);
+        const __m128 sy = _mm_loadu_ps(s.y.data() + i);
+        const __m128 sz = _mm_loadu_ps(s.z.data() + i);
+
+        Mat4f* destination = matrices + i;
+
+        store_column(destination, 0,
+            _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+            _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+            _mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+            zero);
+
+        store_column(destination, 1,
+            _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+            _mm_mul_ps(_mm_add_ps(yz, wx), sy),
+            zero);
+
+        store_column(destination, 2,
+            _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+            _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+            _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+            zero);
+
+        store_column(destination, 3,
+            _mm_loadu_ps(t.x.data() + i),
+            _mm_loadu_ps(t.y.data() + i),
+            _mm_loadu_ps(t.z.data() + i),
+            one);
+    }
+
+    return i;
+}
+
+std::size_t transform_points_sse(const Mat4f& m, const Vec3Span& p, const Vec3SpanOut& r, std::size_t begin, std::size_t end)
+{
+    __m128 columns[4][3];
+
+    for (U32 column = 0; column < 4; ++column)
+    {
+        for (U32 row = 0; row < 3; ++row)
+        {
+            columns[column][row] = _mm_set1_ps(m[column][row]);
+        }
+    }
+
+    std::size_t i = begin;
+
+    for (; i + 4 <= end; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(p.x.data() + i);
+        const __m128 y = _mm_loadu_ps(p.y.data() + i);
+        const __m128 z = _mm_loadu_ps(p.z.data() + i);
+
+        F32* const results[3] = { r.x.data() + i, r.y.data() + i, r.z.data() + i };
+
+        for (U32 row = 0; row < 3; ++row)
+        {
+            __m128 result = _mm_add_ps(_mm_mul_ps(columns[0][row], x), columns[3][row]);
+            result = _mm_add_ps(_mm_mul_ps(columns[1][row], y), result);
+            result = _mm_add_ps(_mm_mul_ps(columns[2][row], z), result);
+
+            _mm_storeu_ps(results[row], result);
+        }
+    }
+
+    return i;
+}
+
+std::size_t transform_aabbs_sse(const Mat4f& m, const Vec3Span& c, const Vec3Span& e, const Vec3SpanOut& rc, const Vec3SpanOut& re, std::size_t begin, std::size_t end)
+{
+    const std::size_t stop = transform_points_sse(m, c, rc, begin, end);
+
+    __m128 columns[3][3]; // Absolute linear part
+
+    for (U32 column = 0; column < 3; ++column)
+    {
+        for (U32 row = 0; row < 3; ++row)
+        {
+            columns[column][row] = _mm_set1_ps(std::abs(m[column][row]));
+        }
+    }
+
+    for (std::size_t i = begin; i < stop; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(e.x.data() + i);
+        const __m128 y = _mm_loadu_ps(e.y.data() + i);
+        const __m128 z = _mm_loadu_ps(e.z.data() + i);
+
+        F32* const results[3] = { re.x.data() + i, re.y.data() + i, re.z.data() + i };
+
+        for (U32 row = 0; row < 3; ++row)
+        {
+            __m128 result = _mm_mul_ps(columns[0][row], x);
+            result = _mm_add_ps(_mm_mul_ps(columns[1][row], y), result);
+            result = _mm_add_ps(_mm_mul_ps(columns[2][row], z), result);
+
+            _mm_storeu_ps(results[row], result);
+        }
+    }
+
+    return stop;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t compose_transforms_avx2(const Vec3Span& t, const QuatSpan& q, const Vec3Span& s, Mat4f* matrices, std::size_t begin, std::size_t end)
+{
+    const __m256 one  = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    std::size_t i = begin;
+
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(q.x.data() + i);
+        const __m256 y = _mm256_loadu_ps(q.y.data() + i);
+        const __m256 z = _mm256_loadu_ps(q.z.data() + i);
+        const __m256 w = _mm256_loadu_ps(q.w.data() + i);
+
+        const __m256 x2 = _mm256_add_ps(x, x);
+        const __m256 y2 = _mm256_add_ps(y, y);
+        const __m256 z2 = _mm256_add_ps(z, z);
+
+        const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+        const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+        const __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+
+        const __m256 sx = _mm256_loadu_ps(s.x.data() + i);
+        const __m256 sy = _mm256_loadu_ps(s.y.data() + i);
+        const __m256 sz = _mm256_loadu_ps(s.z.data() + i);
+
+        const __m256 columns[4][4] = {
+            {
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx),
+                _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+                _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx),
+                zero,
+            },
+            {
+                _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+                _mm256_mul_ps(_mm256_add_ps(yz, wx), sy),
+                zero,
+            },
+            {
+                _mm256_mul_ps(_mm256_add_ps(xz, wy), sz),
+                _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+                _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz),
+                zero,
+            },
+            {
+                _mm256_loadu_ps(t.x.data() + i),
+                _mm256_loadu_ps(t.y.data() + i),
+                _mm256_loadu_ps(t.z.data() + i),
+                one,
+            },
+        };
+
+        // Transposed four matrices at a time, lower lanes then upper lanes
+        for (U32 column = 0; column < 4; ++column)
+        {
+            const auto& rows = columns[column];
+
+            store_column(matrices + i, column,
+                _mm256_castps256_ps128(rows[0]), _mm256_castps256_ps128(rows[1]),
+                _mm256_castps256_ps128(rows[2]), _mm256_castps256_ps128(rows[3]));
+
+            store_column(matrices + i + 4, column,
+                _mm256_extractf128_ps(rows[0], 1), _mm256_extractf128_ps(rows[1], 1),
+                _mm256_extractf128_ps(rows[2], 1), _mm256_extractf128_ps(rows[3], 1));
+        }
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t transform_points_avx2(const Mat4f& m, const Vec3Span& p, const Vec3SpanOut& r, std::size_t begin, std::size_t end)
+{
+    __m256 columns[4][3];
+
+    for (U32 column = 0; column < 4; ++column)
+    {
+        for (U32 row = 0; row < 3; ++row)
+        {
+            columns[column][row] = _mm256_set1_ps(m[column][row]);
+        }
+    }
+
+    std::size_t i = begin;
+
+    for (; i + 8 <= end; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(p.x.data() + i);
+        const __m256 y = _mm256_loadu_ps(p.y.data() + i);
+        const __m256 z = _mm256_loadu_ps(p.z.data() + i);
+
+        F32* const results[3] = { r.x.data() + i, r.y.data() + i, r.z.data() + i };
+
+        for (U32 row = 0; row < 3; ++row)
+        {
+            __m256 result = _mm256_fmadd_ps(columns[0][row], x, columns[3][row]);
+            result = _mm256_fmadd_ps(columns[1][row], y, result);
+            result = _mm256_fmadd_ps(columns[2][row], z, result);
+
+            _mm256_storeu_ps(results[row], result);
+        }
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2,fma")))
+std::size_t transform_aabbs_avx2(const Mat4f& m, const Vec3Span& c, const Vec3Span& e, const Vec3SpanOut& rc, const Vec3SpanOut& re, std::size_t begin, std::size_t end)
+{
+    const std::size_t stop = transform_points_avx2(m, c, rc, begin, end);
+
+    __m256 columns[3][3]; // Absolute linear part
+
+    for (U32 column = 0; column < 3; ++column)
+    {
+        for (U32 row = 0; row < 3; ++row)
+        {
+            columns[column][row] = _mm256_set1_ps(std::abs(m[column][row]));
+        }
+    }
+
+    for (std::size_t i = begin; i < stop; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(e.x.data() + i);
+        const __m256 y = _mm256_loadu_ps(e.y.data() + i);
+        const __m256 z = _mm256_loadu_ps(e.z.data() + i);
+
+        F32* const results[3] = { re.x.data() + i, re.y.data() + i, re.z.data() + i };
+
+        for (U32 row = 0; row < 3; ++row)
+        {
+            __m256 result = _mm256_mul_ps(columns[0][row], x);
+            result = _mm256_fmadd_ps(columns[1][row], y, result);
+            result = _mm256_fmadd_ps(columns[2][row], z, result);
+
+            _mm256_storeu_ps(results[row], result);
+        }
+    }
+
+    return stop;
+}
+
+#endif // CR_ARCH_X86
+
+struct Kernels
+{
+    ComposeKernel compose_transforms;
+    PointKernel   transform_points;
+    AABBKernel    transform_aabbs;
+    const char*   name;
+};
+
+// Indexed by BatchMathKernel, kernels the build has no code for fall back to scalar
+constexpr Kernels KERNELS[] = {
+    {compose_transforms_scalar, transform_points_scalar, transform_aabbs_scalar, "scalar"},
+#if CR_ARCH_X86
+    {compose_transforms_sse,    transform_points_sse,    transform_aabbs_sse,    "SSE"   },
+    {compose_transforms_avx2,   transform_points_avx2,   transform_aabbs_avx2,   "AVX2"  },
+#else
+    {compose_transforms_scalar, transform_points_scalar, transform_aabbs_scalar, "scalar"},
+    {compose_transforms_scalar, transform_points_scalar, transform_aabbs_scalar, "scalar"},
+#endif
+};
+
+const Kernels*& get_selected_kernels()
+{
+    static const Kernels* kernels = &KERNELS[static_cast<U32>(get_simd_level())];
+
+    return kernels;
+}
+
+const Kernels& get_kernels()
+{
+    return *get_selected_kernels();
+}
+
+} // namespace
+
+void compose_transforms(const Vec3Span& translations, const QuatSpan& rotations, const Vec3Span& scales, std::span<Mat4f> matrices)
+{
+    const std::size_t count = matrices.size();
+
+    CR_ASSERT(translations.x.size() >= count && translations.y.size() >= count && translations.z.size() >= count &&
+              rotations.x.size()    >= count && rotations.y.size()    >= count && rotations.z.size()    >= count && rotations.w.size() >= count &&
+              scales.x.size()       >= count && scales.y.size()       >= count && scales.z.size()       >= count,
+              "Transform components hold fewer than {} elements", count);
+
+    const std::size_t stop = get_kernels().compose_transforms(translations, rotations, scales, matrices.data(), 0, count);
+    compose_transforms_scalar(translations, rotations, scales, matrices.data(), stop, count);
+}
+
+void transform_points(const Mat4f& matrix, const Vec3Span& points, const Vec3SpanOut& results)
+{
+    const std::size_t count = results.x.size();
+
+    CR_ASSERT(results.y.size() >= count && results.z.size() >= count &&
+              points.x.size()  >= count && points.y.size()  >= count && points.z.size() >= count,
+              "Point components hold fewer than {} elements", count);
+
+    const std::size_t stop = get_kernels().transform_points(matrix, points, results, 0, count);
+    transform_points_scalar(matrix, points, results, stop, count);
+}
+
+void transform_aabbs(const Mat4f& matrix, const Vec3Span& centers, const Vec3Span& extents, const Vec3SpanOut& result_centers, const Vec3SpanOut& result_extents)
+{
+    const std::size_t count = result_centers.x.size();
+
+    CR_ASSERT(result_centers.y.size() >= count && result_centers.z.size() >= count &&
+              result_extents.x.size() >= count && result_extents.y.size() >= count && result_extents.z.size() >= count &&
+              centers.x.size()        >= count && centers.y.size()        >= count && centers.z.size()        >= count &&
+              extents.x.size()        >= count && extents.y.size()        >= count && extents.z.size()        >= count,
+              "Box components hold fewer than {} elements", count);
+
+    const std::size_t stop = get_kernels().transform_aabbs(matrix, centers, extents, result_centers, result_extents, 0, count);
+    transform_aabbs_scalar(matrix, centers, extents, result_centers, result_extents, stop, count);
+}
+
+const char* get_batch_math_kernel_name()
+{
+    return get_kernels().name;
+}
+
+bool is_batch_math_kernel_supported(BatchMathKernel kernel)
+{
+    return is_simd_level_supported(kernel);
+}
+
+void set_batch_math_kernel(BatchMathKernel kernel)
+{
+    CR_ASSERT_THROW(is_batch_math_kernel_supported(kernel), "Batch math kernel {} is not supported by this CPU", KERNELS[static_cast<U32>(kernel)].name);
+
+    get_selected_kernels() = &KERNELS[static_cast<U32>(kernel)];
+}
+
+} // namespace Cr
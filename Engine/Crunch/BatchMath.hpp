@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/Math.hpp"
+#include "Crunch/CPU.hpp"
+
+// Transform kernels over structure of arrays inputs, vectorized with the widest instruction set the CPU supports
+// (see get_simd_level()). Every component span of an input holds at least as many elements as the output. Results
+// match the GLM scalar functions up to floating point rounding.
+
+namespace Cr
+{
+    struct Vec3Span
+    {
+        std::span<const F32> x, y, z;
+    };
+
+    struct Vec3SpanOut
+    {
+        std::span<F32> x, y, z;
+    };
+
+    struct QuatSpan
+    {
+        std::span<const F32> x, y, z, w; // Normalized
+    };
+
+    // matrices[i] = translate(translations[i]) * mat4_cast(rotations[i]) * scale(scales[i])
+    void compose_transforms(const Vec3Span& translations, const QuatSpan& rotations, const Vec3Span& scales, std::span<Mat4f> matrices);
+
+    // Points with an implicit w of 1, results[i] = matrix * points[i]
+    void transform_points(const Mat4f& matrix, const Vec3Span& points, const Vec3SpanOut& results);
+
+    // Axis aligned boxes as center and half extent, results bound the transformed boxes
+    void transform_aabbs(const Mat4f& matrix, const Vec3Span& centers, const Vec3Span& extents, const Vec3SpanOut& result_centers, const Vec3SpanOut& result_extents);
+
+    // Kernels exist for every level, the wider ones process four or eight elements per iteration
+    using BatchMathKernel = SIMDLevel;
+
+    // Name of the kernels selected for this CPU
+    [[nodiscard]] const char* get_batch_math_kernel_name();
+
+    [[nodiscard]] bool is_batch_math_kernel_supported(BatchMathKernel kernel);
+
+    // Replaces the kernels selected for this CPU, for tests and benchmarks comparing instruction sets. Not
+    // synchronized with batch math running on other threads.
+    void set_batch_math_kernel(BatchMathKernel kernel);
+}
@@ -0,0 +1,42 @@
+#include "Crunch/CPU.hpp"
+
+namespace Cr
+{
+
+SIMDLevel get_simd_level()
+{
+    static const SIMDLevel level = []()
+    {
+#if CR_ARCH_X86
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return SIMDLevel::AVX2;
+        }
+
+        return SIMDLevel::SSE;
+#else
+        return SIMDLevel::Scalar;
+#endif
+    }();
+
+    return level;
+}
+
+bool is_simd_level_supported(SIMDLevel level)
+{
+    return static_cast<U32>(level) <= static_cast<U32>(get_simd_level());
+}
+
+const char* to_string(SIMDLevel level)
+{
+    switch (level)
+    {
+        case SIMDLevel::Scalar: return "scalar";
+        case SIMDLevel::SSE:    return "SSE";
+        case SIMDLevel::AVX2:   return "AVX2";
+    }
+
+    return "unknown";
+}
+
+} // namespace Cr
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+
+namespace Cr
+{
+
+// Instruction sets the SIMD kernels are written for, from narrowest to widest. A CPU supporting one level supports
+// every level below it.
+enum class SIMDLevel
+{
+    Scalar,
+    SSE,  // Four lanes, always available on x86
+    AVX2, // Eight lanes, with FMA
+};
+
+// Widest level of this CPU, queried once
+[[nodiscard]] SIMDLevel get_simd_level();
+
+[[nodiscard]] bool is_simd_level_supported(SIMDLevel level);
+
+[[nodiscard]] const char* to_string(SIMDLevel level);
+
+} // namespace Cr
@@ -15,6 +15,13 @@
 #include "Crunch/Log.hpp"
 #include "Crunch/Assert.hpp"
 
+// SIMD kernels are selected at runtime, x86 always has SSE2 and may have AVX2
+#if defined(__x86_64__) || defined(__i386__)
+    #define CR_ARCH_X86 1
+#else
+    #define CR_ARCH_X86 0
+#endif
+
 namespace Cr
 {
 
@@ -1,9 +1,19 @@
 #include "Crunch/Filesystem.hpp"
 
 #include <fstream>
-#include <iterator>
 #include <cstring>
 
+#if defined(__unix__) || defined(__APPLE__)
+    #define CR_HAS_MMAP 1
+
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #define CR_HAS_MMAP 0
+#endif
+
 namespace Cr
 {
 
@@ -12,11 +22,128 @@ std::vector<U8> read_binary_file(const std::filesystem::path& path)
     std::ifstream file;
 
     file.exceptions(std::ifstream::badbit);
-    file.open(path, std::ifstream::binary);
+    file.open(path, std::ifstream::binary | std::ifstream::ate);
 
     CR_ASSERT_THROW(file.is_open(), "Failed to open {}: {}", path.string(), std::strerror(errno));
 
-    return {std::istreambuf_iterator<char>(file), {}};
+    // Sized up front and read in one call
+    std::vector<U8> data(static_cast<std::size_t>(file.tellg()));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    CR_ASSERT_THROW(file.gcount() == static_cast<std::streamsize>(data.size()), "Failed to read {}", path.string());
+
+    return data;
+}
+
+void write_binary_file(const std::filesystem::path& path, std::span<const U8> data)
+{
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream file;
+
+        file.exceptions(std::ofstream::badbit);
+        file.open(temporary, std::ofstream::binary | std::ofstream::trunc);
+
+        CR_ASSERT_THROW(file.is_open(), "Failed to open {}: {}", temporary.string(), std::strerror(errno));
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::filesystem::rename(temporary, path);
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path, FileAccess access)
+{
+#if CR_HAS_MMAP
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    CR_ASSERT_THROW(file >= 0, "Failed to open {}: {}", path.string(), std::strerror(errno));
+    CR_DEFER { ::close(file); }; // The mapping keeps its own reference to the file
+
+    struct stat info {};
+    CR_ASSERT_THROW(::fstat(file, &info) == 0, "Failed to stat {}: {}", path.string(), std::strerror(errno));
+
+    // Empty mappings are rejected, an empty file is an empty span
+    if (info.st_size == 0) { return; }
+
+    void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+    CR_ASSERT_THROW(mapping != MAP_FAILED, "Failed to map {}: {}", path.string(), std::strerror(errno));
+
+    m_data = static_cast<const U8*>(mapping);
+    m_size = static_cast<U64>(info.st_size);
+
+    // Hints only, failures are harmless
+    if (access == FileAccess::Sequential)
+    {
+        (void)::madvise(mapping, m_size, MADV_SEQUENTIAL);
+        (void)::madvise(mapping, m_size, MADV_WILLNEED); // Read ahead starts now instead of on the first fault
+    }
+    else
+    {
+        (void)::madvise(mapping, m_size, MADV_RANDOM);
+    }
+#else
+    (void)access;
+
+    m_fallback = read_binary_file(path);
+    m_data     = m_fallback.data();
+    m_size     = m_fallback.size();
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if CR_HAS_MMAP
+    if (m_data != nullptr)
+    {
+        ::munmap(const_cast<U8*>(m_data), m_size);
+    }
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data    (std::exchange(other.m_data, nullptr))
+    , m_size    (std::exchange(other.m_size, 0))
+    , m_fallback(std::move(other.m_fallback))
+{}
+
+MappedFile& MappedFile::operator = (MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        std::swap(m_data,     other.m_data);
+        std::swap(m_size,     other.m_size);
+        std::swap(m_fallback, other.m_fallback);
+    }
+    return *this;
+}
+
+void MappedFile::prefetch(U64 offset, U64 size) const
+{
+    CR_ASSERT(offset + size <= m_size, "Prefetch of [{}, {}) past the end of a {} byte file", offset, offset + size, m_size);
+
+#if CR_HAS_MMAP
+    if (size == 0) { return; }
+
+    // madvise takes page aligned addresses, the mapping itself starts on a page
+    const U64 page_size = static_cast<U64>(::sysconf(_SC_PAGESIZE));
+    const U64 begin     = offset & ~(page_size - 1);
+
+    (void)::madvise(const_cast<U8*>(m_data) + begin, offset + size - begin, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)size;
+#endif
 }
 
 } // namespace Cr
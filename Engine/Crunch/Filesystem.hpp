@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Crunch.hpp"
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
 
 #include <filesystem>
 
@@ -9,4 +10,42 @@ namespace Cr
 
 std::vector<U8> read_binary_file(const std::filesystem::path& path);
 
+// Writes to a temporary next to the destination and renames it over, readers never see a partial file
+void write_binary_file(const std::filesystem::path& path, std::span<const U8> data);
+
+// How a mapped file is going to be read, passed on to the kernel read ahead
+enum class FileAccess
+{
+    Sequential, // Read front to back once, pages are read ahead aggressively and dropped early
+    Random,     // Scattered reads, no read ahead
+};
+
+// Read only view of a whole file. Pages are brought in by the kernel on first access and shared with the page cache,
+// the contents are never copied into process memory. Platforms without mmap read the file into memory instead.
+//
+// The data starts page aligned, which satisfies the alignment of SPIR-V words and KTX headers.
+class MappedFile : public NoCopy
+{
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& path, FileAccess access = FileAccess::Sequential);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator = (MappedFile&& other) noexcept;
+
+        [[nodiscard]] std::span<const U8> get_data() const { return { m_data, m_size }; }
+
+        [[nodiscard]] constexpr U64 size() const { return m_size; }
+
+        // Starts reading the range in the background ahead of its use
+        void prefetch(U64 offset, U64 size) const;
+
+    private:
+        const U8* m_data = nullptr;
+        U64       m_size = 0;
+
+        std::vector<U8> m_fallback; // Owns the data when it could not be mapped
+};
+
 } // namespace Cr
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+
+#include <type_traits>
+
+namespace Cr
+{
+
+static constexpr U64 HASH_SEED = 0xCBF29CE484222325ull;
+
+// FNV-1a, stable across runs and platforms so hashes can be persisted
+[[nodiscard]] constexpr U64 hash_bytes(std::span<const U8> bytes, U64 seed = HASH_SEED)
+{
+    U64 hash = seed;
+
+    for (U8 byte : bytes)
+    {
+        hash ^= byte;
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+[[nodiscard]] constexpr U64 hash_combine(U64 seed, U64 value)
+{
+    return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+}
+
+// Hashes the object representation, only meaningful for types without padding
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+[[nodiscard]] U64 hash_value(const T& value, U64 seed = HASH_SEED)
+{
+    return hash_bytes({reinterpret_cast<const U8*>(&value), sizeof(T)}, seed);
+}
+
+} // namespace Cr
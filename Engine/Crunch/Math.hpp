@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Crunch.hpp"
+#include "Crunch/Crunch.hpp"
 
 #include <cmath>
 
@@ -18,6 +18,8 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <glm/gtc/matrix_access.hpp>
+
 // Lightly wrap GLM if hit by a sudden urge to get rid of it.
 
 namespace Cr
@@ -46,4 +48,23 @@ namespace Cr
     constexpr Mat3f MAT3F_ID {1.0f};
 
     constexpr F32 PI = glm::pi<F32>();
+
+    // Left, right, bottom, top, near, far as (normal, distance) with inward unit normals, a point p is inside
+    // a plane when dot(normal, p) + distance >= 0. Near is taken at clip z = -w, conservative for both depth ranges.
+    inline std::array<Vec4f, 6> get_frustum_planes(const Mat4f& projected_view)
+    {
+        const Vec4f x = glm::row(projected_view, 0);
+        const Vec4f y = glm::row(projected_view, 1);
+        const Vec4f z = glm::row(projected_view, 2);
+        const Vec4f w = glm::row(projected_view, 3);
+
+        std::array<Vec4f, 6> planes { w + x, w - x, w + y, w - y, w + z, w - z };
+
+        for (auto& plane : planes)
+        {
+            plane /= glm::length(Vec3f(plane));
+        }
+
+        return planes;
+    }
 }
@@ -0,0 +1,108 @@
+#include "Crunch/Memory.hpp"
+
+#include <new>
+
+namespace Cr
+{
+
+LinearArena::LinearArena(std::size_t block_size) : m_block_size(block_size)
+{
+    CR_ASSERT(block_size > 0, "Arena block size must be non-zero");
+}
+
+LinearArena::LinearArena(std::span<std::byte> buffer, std::size_t block_size) : LinearArena(block_size)
+{
+    m_blocks.push_back({
+        .data  = buffer.data(),
+        .size  = buffer.size(),
+        .owned = false,
+    });
+}
+
+LinearArena::~LinearArena()
+{
+    for (const Block& block : m_blocks)
+    {
+        if (block.owned)
+        {
+            ::operator delete(block.data);
+        }
+    }
+}
+
+void LinearArena::reset()
+{
+    m_block  = 0;
+    m_offset = 0;
+}
+
+std::size_t LinearArena::get_used() const
+{
+    std::size_t used = m_offset;
+
+    for (std::size_t i = 0; i < m_block && i < m_blocks.size(); ++i)
+    {
+        used += m_blocks[i].size;
+    }
+
+    return used;
+}
+
+std::size_t LinearArena::get_capacity() const
+{
+    std::size_t capacity = 0;
+
+    for (const Block& block : m_blocks)
+    {
+        capacity += block.size;
+    }
+
+    return capacity;
+}
+
+void* LinearArena::do_allocate(std::size_t size, std::size_t alignment)
+{
+    // Blocks that cannot fit the allocation are skipped, their tail stays unused until the next reset
+    for (;; ++m_block, m_offset = 0)
+    {
+        if (m_block == m_blocks.size())
+        {
+            const std::size_t block_size = std::max(m_block_size, size + alignment);
+
+            m_blocks.push_back({
+                .data  = static_cast<std::byte*>(::operator new(block_size)),
+                .size  = block_size,
+                .owned = true,
+            });
+        }
+
+        const Block& block = m_blocks[m_block];
+
+        const std::uintptr_t base    = reinterpret_cast<std::uintptr_t>(block.data);
+        const std::size_t    aligned = ((base + m_offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1)) - base;
+
+        if (aligned + size <= block.size)
+        {
+            m_offset = aligned + size;
+            return block.data + aligned;
+        }
+    }
+}
+
+FrameArena::FrameArena(U32 frame_count, std::size_t block_size)
+{
+    CR_ASSERT(frame_count > 0, "Frame arenas need at least one frame");
+
+    for (U32 i = 0; i < frame_count; ++i)
+    {
+        m_arenas.push_back(create_unique<LinearArena>(block_size));
+    }
+}
+
+void FrameArena::begin_frame(U32 frame_index)
+{
+    m_frame_index = frame_index % static_cast<U32>(m_arenas.size());
+    m_arenas[m_frame_index]->reset();
+}
+
+} // namespace Cr
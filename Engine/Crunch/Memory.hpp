@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include <memory_resource>
+#include <type_traits>
+
+namespace Cr
+{
+
+// Bump allocator over a list of blocks. Allocations are never freed one by one, reset() rewinds to the first block
+// and keeps every block for reuse so a steady workload stops allocating after warming up. It is a
+// std::pmr::memory_resource, containers use it through std::pmr::polymorphic_allocator.
+//
+// Not thread safe, use one arena per thread.
+class LinearArena : public std::pmr::memory_resource, public NoCopy, public NoMove
+{
+    public:
+        static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        explicit LinearArena(std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        // Allocates from buffer first, typically on the stack, then from heap blocks once it is full
+        explicit LinearArena(std::span<std::byte> buffer, std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        ~LinearArena() override;
+
+        // Value initialized, lives until the next reset()
+        template<typename T>
+            requires std::is_trivially_destructible_v<T>
+        [[nodiscard]] std::span<T> allocate_array(std::size_t count);
+
+        void reset();
+
+        [[nodiscard]] std::size_t get_used()     const;
+        [[nodiscard]] std::size_t get_capacity() const;
+
+    private:
+        struct Block
+        {
+            std::byte*  data;
+            std::size_t size;
+            bool        owned;
+        };
+
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void  do_deallocate(void*, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::vector<Block> m_blocks;
+
+        std::size_t m_block_size = 0;
+        std::size_t m_block      = 0; // Block being allocated from
+        std::size_t m_offset     = 0; // Into m_blocks[m_block]
+};
+
+// One arena per frame, begin_frame() resets the arena of the frame about to be recorded. Scratch data allocated while
+// recording a frame stays valid until the same frame index comes around again.
+class FrameArena : public NoCopy, public NoMove
+{
+    public:
+        FrameArena() = delete;
+        explicit FrameArena(U32 frame_count = 2, std::size_t block_size = LinearArena::DEFAULT_BLOCK_SIZE);
+        ~FrameArena() = default;
+
+        void begin_frame(U32 frame_index);
+
+        [[nodiscard]] LinearArena& get() { return *m_arenas[m_frame_index]; }
+
+    private:
+        std::vector<Unique<LinearArena>> m_arenas;
+
+        U32 m_frame_index = 0;
+};
+
+template<typename T>
+    requires std::is_trivially_destructible_v<T>
+std::span<T> LinearArena::allocate_array(std::size_t count)
+{
+    T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+
+    std::uninitialized_value_construct_n(data, count);
+
+    return {data, count};
+}
+
+} // namespace Cr
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include <type_traits>
+
+namespace Cr
+{
+
+// Index into a Pool<T> slot plus the generation the slot had when the handle was made, a handle goes stale as soon
+// as its value is removed even if the slot is reused later
+template<typename T>
+struct Handle
+{
+    static constexpr U32 INVALID_INDEX = ~0u;
+
+    U32 index      = INVALID_INDEX;
+    U32 generation = 0;
+
+    [[nodiscard]] constexpr bool is_valid() const { return index != INVALID_INDEX; }
+
+    constexpr bool operator == (const Handle& other) const = default;
+};
+
+// Values are packed in one array for iteration, handles resolve through a slot table in O(1). Removing swaps the
+// last value into the hole, so references and iteration order only hold until the next insertion or removal.
+template<typename T>
+class Pool : public NoCopy
+{
+    public:
+        Pool() = default;
+        ~Pool() = default;
+
+        template<typename... Args>
+        [[nodiscard]] Handle<T> emplace(Args&&... arguments);
+
+        // Moves the value out of the pool and invalidates the handle
+        [[nodiscard]] T take(Handle<T> handle);
+
+        [[nodiscard]] bool contains(Handle<T> handle) const;
+
+        [[nodiscard]] T&       get(Handle<T> handle);
+        [[nodiscard]] const T& get(Handle<T> handle) const;
+
+        [[nodiscard]] std::span<T>       get_values()       { return m_values; }
+        [[nodiscard]] std::span<const T> get_values() const { return m_values; }
+
+        [[nodiscard]] U32 size() const { return static_cast<U32>(m_values.size()); }
+
+        void clear();
+
+    private:
+        struct Slot
+        {
+            U32 value      = Handle<T>::INVALID_INDEX; // Into m_values, invalid while free
+            U32 generation = 0;
+        };
+
+        std::vector<T>    m_values;
+        std::vector<U32>  m_value_slots; // Slot of every value
+        std::vector<Slot> m_slots;
+        std::vector<U32>  m_free_slots;
+};
+
+template<typename T>
+template<typename... Args>
+Handle<T> Pool<T>::emplace(Args&&... arguments)
+{
+    U32 slot;
+
+    if (m_free_slots.empty())
+    {
+        slot = static_cast<U32>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    else
+    {
+        slot = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+
+    m_values.emplace_back(std::forward<Args>(arguments)...);
+    m_value_slots.push_back(slot);
+
+    m_slots[slot].value = static_cast<U32>(m_values.size() - 1);
+
+    return { slot, m_slots[slot].generation };
+}
+
+template<typename T>
+T Pool<T>::take(Handle<T> handle)
+{
+    CR_ASSERT(contains(handle), "Stale or invalid handle {}:{}", handle.index, handle.generation);
+
+    Slot& slot = m_slots[handle.index];
+
+    const U32 value = slot.value;
+    const U32 last  = static_cast<U32>(m_values.size() - 1);
+
+    T taken = std::move(m_values[value]);
+
+    if (value != last)
+    {
+        m_values[value]      = std::move(m_values[last]);
+        m_value_slots[value] = m_value_slots[last];
+
+        m_slots[m_value_slots[value]].value = value;
+    }
+
+    m_values.pop_back();
+    m_value_slots.pop_back();
+
+    slot.value = Handle<T>::INVALID_INDEX;
+    ++slot.generation;
+
+    m_free_slots.push_back(handle.index);
+
+    return taken;
+}
+
+template<typename T>
+bool Pool<T>::contains(Handle<T> handle) const
+{
+    return handle.index < m_slots.size() &&
+           m_slots[handle.index].generation == handle.generation &&
+           m_slots[handle.index].value != Handle<T>::INVALID_INDEX;
+}
+
+template<typename T>
+T& Pool<T>::get(Handle<T> handle)
+{
+    CR_ASSERT(contains(handle), "Stale or invalid handle {}:{}", handle.index, handle.generation);
+
+    return m_values[m_slots[handle.index].value];
+}
+
+template<typename T>
+const T& Pool<T>::get(Handle<T> handle) const
+{
+    CR_ASSERT(contains(handle), "Stale or invalid handle {}:{}", handle.index, handle.generation);
+
+    return m_values[m_slots[handle.index].value];
+}
+
+template<typename T>
+void Pool<T>::clear()
+{
+    for (U32 slot : m_value_slots)
+    {
+        m_slots[slot].value = Handle<T>::INVALID_INDEX;
+        ++m_slots[slot].generation;
+
+        m_free_slots.push_back(slot);
+    }
+
+    m_values.clear();
+    m_value_slots.clear();
+}
+
+} // namespace Cr
@@ -0,0 +1,395 @@
+#include "Graphics/AssetLoader.hpp"
+
+#include <ktx.h>
+
+#include <cstring>
+
+namespace Cr::Graphics
+{
+
+namespace
+{
+
+struct TranscodeTarget
+{
+    ktx_transcode_fmt_e format;
+    VkFormat            vk_format;      // What libktx stores for linear sources
+    VkFormat            srgb_vk_format; // And for sRGB sources
+};
+
+constexpr TranscodeTarget BC7       { KTX_TTF_BC7_RGBA,      VK_FORMAT_BC7_UNORM_BLOCK,           VK_FORMAT_BC7_SRGB_BLOCK           };
+constexpr TranscodeTarget BC3       { KTX_TTF_BC3_RGBA,      VK_FORMAT_BC3_UNORM_BLOCK,           VK_FORMAT_BC3_SRGB_BLOCK           };
+constexpr TranscodeTarget BC1       { KTX_TTF_BC1_RGB,       VK_FORMAT_BC1_RGB_UNORM_BLOCK,       VK_FORMAT_BC1_RGB_SRGB_BLOCK       };
+constexpr TranscodeTarget ASTC      { KTX_TTF_ASTC_4x4_RGBA, VK_FORMAT_ASTC_4x4_UNORM_BLOCK,      VK_FORMAT_ASTC_4x4_SRGB_BLOCK      };
+constexpr TranscodeTarget ETC2_RGBA { KTX_TTF_ETC2_RGBA,     VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK };
+constexpr TranscodeTarget ETC2_RGB  { KTX_TTF_ETC1_RGB,      VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,   VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK   };
+
+// Best first per [UASTC][alpha]. ETC1S only carries BC1 quality, so opaque ETC1S takes BC1 at half the size of
+// BC7, UASTC keeps its quality in BC7 or ASTC.
+constexpr std::array<std::array<TranscodeTarget, 4>, 4> TRANSCODE_PREFERENCES {{
+    {{ BC1, BC7, ETC2_RGB,  ASTC      }}, // ETC1S
+    {{ BC7, BC3, ETC2_RGBA, ASTC      }}, // ETC1S with alpha
+    {{ BC7, ASTC, BC1,      ETC2_RGB  }}, // UASTC
+    {{ BC7, ASTC, BC3,      ETC2_RGBA }}, // UASTC with alpha
+}};
+
+// Whether the Basis payload carries a channel the transcoder writes to alpha, from the data format descriptor.
+// ETC1S keeps it in a second slice, AAA or GGG for two channel data, UASTC names it in its one channel id.
+bool has_alpha(ktxTexture2* texture)
+{
+    const U32* block   = texture->pDfd + 1; // Basic descriptor block, after the total size
+    const U32  samples = KHR_DFDSAMPLECOUNT(block);
+
+    for (U32 sample = 0; sample < samples; ++sample)
+    {
+        const U32 channel = KHR_DFDSVAL(block, sample, CHANNELID);
+
+        if (ktxTexture2_GetColorModel_e(texture) == KHR_DF_MODEL_UASTC)
+        {
+            if (channel == KHR_DF_CHANNEL_UASTC_RGBA || channel == KHR_DF_CHANNEL_UASTC_RRRG) { return true; }
+        }
+        else if (channel == KHR_DF_CHANNEL_ETC1S_AAA || channel == KHR_DF_CHANNEL_ETC1S_GGG)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Level index of a KTX2 file, level 0 first right after the 80 byte header. Offsets are from the start of the file.
+struct LevelIndexEntry
+{
+    U64 byte_offset;
+    U64 byte_length;
+    U64 uncompressed_byte_length;
+};
+
+constexpr std::size_t KTX2_LEVEL_INDEX_OFFSET = 80;
+
+LevelIndexEntry get_level_index_entry(std::span<const U8> file, U32 level)
+{
+    const std::size_t offset = KTX2_LEVEL_INDEX_OFFSET + level * sizeof(LevelIndexEntry);
+
+    LevelIndexEntry entry;
+
+    CR_ASSERT_THROW(offset + sizeof(entry) <= file.size(), "KTX2 level index of level {} is out of the file", level);
+    std::memcpy(&entry, file.data() + offset, sizeof(entry));
+
+    CR_ASSERT_THROW(entry.byte_offset + entry.byte_length <= file.size(), "KTX2 level {} is out of the file", level);
+
+    return entry;
+}
+
+} // namespace
+
+AssetLoader::Request::~Request()
+{
+    if (texture != nullptr)
+    {
+        ktxTexture_Destroy(ktxTexture(texture));
+    }
+}
+
+AssetLoader::AssetLoader(Vulkan::API& vk, Core::JobSystem& jobs, U32 queue_depth)
+    : m_vk(vk)
+    , m_jobs(jobs)
+    , m_reader(jobs, queue_depth)
+{
+    constexpr VkFormatFeatureFlags required_features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+
+    // sRGB support is queried on its own, devices are free to sample only one of the two
+    for (std::size_t i = 0; i < m_transcode_formats.size(); ++i)
+    {
+        const bool srgb = i % 2 == 1;
+
+        m_transcode_formats[i] = KTX_TTF_RGBA32; // Always samplable
+
+        for (const TranscodeTarget& target : TRANSCODE_PREFERENCES[i / 2])
+        {
+            if (m_vk.supports_format(srgb ? target.srgb_vk_format : target.vk_format, required_features))
+            {
+                m_transcode_formats[i] = target.format;
+                break;
+            }
+        }
+    }
+}
+
+AssetLoader::~AssetLoader()
+{
+    // Decodes write into their requests, reads are waited for by the reader
+    m_jobs.wait(m_decoding);
+}
+
+AssetID AssetLoader::load_texture(const std::filesystem::path& path)
+{
+    return load(path, AssetType::Texture, 0);
+}
+
+AssetID AssetLoader::load_shader_module(const std::filesystem::path& path, VkShaderStageFlags stage)
+{
+    return load(path, AssetType::ShaderModule, stage);
+}
+
+AssetID AssetLoader::load(const std::filesystem::path& path, AssetType type, VkShaderStageFlags stage)
+{
+    const AssetID id = m_reader.read(path);
+
+    auto request = create_unique<Request>();
+
+    request->type  = type;
+    request->stage = stage;
+    request->path  = path;
+
+    m_requests.emplace(id, std::move(request));
+
+    return id;
+}
+
+void AssetLoader::update()
+{
+    for (auto& read : m_reader.poll())
+    {
+        Request& request = *m_requests.at(read.id);
+
+        // Failed reads skip decoding and report back right away
+        if (read.error != 0)
+        {
+            request.error = std::make_exception_ptr(std::runtime_error(std::format("Failed to read {}: {}", request.path.string(), std::strerror(read.error))));
+
+            std::lock_guard lock { m_mutex };
+            m_decoded.push_back(read.id);
+
+            continue;
+        }
+
+        request.data = std::move(read.data);
+
+        // The request stays put until update() has seen it decoded
+        m_jobs.run([this, id = read.id, &request]()
+        {
+            try
+            {
+                decode(request);
+            }
+            catch (...)
+            {
+                request.error = std::current_exception();
+            }
+
+            std::lock_guard lock { m_mutex };
+            m_decoded.push_back(id);
+        }, &m_decoding);
+    }
+
+    std::vector<AssetID> decoded;
+
+    {
+        std::lock_guard lock { m_mutex };
+        decoded.swap(m_decoded);
+    }
+
+    // Every decoded asset is finished before the first error is rethrown, none of them are lost
+    std::exception_ptr error;
+
+    for (const AssetID id : decoded)
+    {
+        const auto node = m_requests.extract(id);
+        Request& request = *node.mapped();
+
+        if (request.error)
+        {
+            if (!error) { error = request.error; }
+            continue;
+        }
+
+        m_completed.push_back(finish(id, request));
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void AssetLoader::wait_for_idle()
+{
+    while (true)
+    {
+        update();
+
+        if (m_requests.empty()) { break; }
+
+        // Blocks on the earliest stage with work left, the workers keep decoding meanwhile
+        if (m_reader.get_pending_count() > 0)
+        {
+            m_reader.wait();
+        }
+        else
+        {
+            m_jobs.wait(m_decoding);
+        }
+    }
+}
+
+void AssetLoader::decode(Request& request)
+{
+    switch (request.type)
+    {
+        case AssetType::Texture:
+        {
+            // Only the header, plain levels are staged straight from the file contents by finish()
+            const KTX_error_code result = ktxTexture2_CreateFromMemory(request.data.data(), request.data.size(), KTX_TEXTURE_CREATE_NO_FLAGS, &request.texture);
+
+            CR_ASSERT_THROW(result == KTX_SUCCESS, "Failed to load {}: {}", request.path.string(), ktxErrorString(result));
+
+            const bool transcode = ktxTexture2_NeedsTranscoding(request.texture);
+
+            if (!transcode && request.texture->supercompressionScheme == KTX_SS_NONE)
+            {
+                return; // Keeps the file contents
+            }
+
+            // Supercompressed levels are inflated into memory owned by the texture, the file is not needed after
+            const KTX_error_code loaded = ktxTexture_LoadImageData(ktxTexture(request.texture), nullptr, 0);
+
+            CR_ASSERT_THROW(loaded == KTX_SUCCESS, "Failed to load the levels of {}: {}", request.path.string(), ktxErrorString(loaded));
+
+            // Basis payloads are transcoded here, off the frame loop thread. The texture takes the vkFormat of the
+            // target, sRGB when the source was.
+            if (transcode)
+            {
+                const bool uastc = ktxTexture2_GetColorModel_e(request.texture) == KHR_DF_MODEL_UASTC;
+                const bool alpha = has_alpha(request.texture);
+                const bool srgb  = ktxTexture2_GetOETF_e(request.texture) == KHR_DF_TRANSFER_SRGB;
+
+                const auto format = static_cast<ktx_transcode_fmt_e>(m_transcode_formats[(uastc ? 4 : 0) + (alpha ? 2 : 0) + (srgb ? 1 : 0)]);
+
+                const KTX_error_code transcoded = ktxTexture2_TranscodeBasis(request.texture, format, 0);
+
+                CR_ASSERT_THROW(transcoded == KTX_SUCCESS, "Failed to transcode {}: {}", request.path.string(), ktxErrorString(transcoded));
+            }
+
+            break;
+        }
+        case AssetType::ShaderModule:
+        {
+            // Module creation only touches the device, which Vulkan allows from any thread
+            request.shader_module = m_vk.create_shader_module(request.data, request.stage);
+            break;
+        }
+    }
+
+    // The texture holds its own decoded texels and the module its own copy of the code
+    request.data = {};
+}
+
+LoadedAsset AssetLoader::finish(AssetID id, Request& request)
+{
+    LoadedAsset asset {
+        .id   = id,
+        .type = request.type,
+    };
+
+    switch (request.type)
+    {
+        case AssetType::Texture:
+        {
+            ktxTexture* texture = ktxTexture(request.texture);
+
+            const VkFormat   format = static_cast<VkFormat>(request.texture->vkFormat);
+            const VkExtent3D extent = { texture->baseWidth, texture->baseHeight, texture->baseDepth };
+
+            // Files with only their first level get the rest generated on the GPU, block compressed formats can
+            // not be rendered to and keep the one level
+            const U32               full_levels = Vulkan::Texture::get_full_mip_levels(extent);
+            const VkImageUsageFlags mip_usage   = m_vk.get_mip_generator().get_usage(format);
+            const bool              generate    = texture->numLevels == 1 && full_levels > 1 && mip_usage != 0;
+
+            asset.texture = m_vk.create_texture({
+                .format       = format,
+                .extent       = extent,
+                .mip_levels   = generate ? full_levels : texture->numLevels,
+                .array_layers = texture->numLayers,
+                .cubemap      = texture->isCubemap,
+                .usage        = generate ? mip_usage : 0,
+            });
+
+            // Levels that needed no decoding are still where the file put them, the staging copy reads them from
+            // the file contents directly
+            const bool from_file = texture->pData == nullptr;
+
+            std::span<const U8> data;
+            U64                 data_offset = 0; // Of data in the file
+
+            if (from_file)
+            {
+                // Levels are stored smallest first, the staged range starts at the last level and ends with the first
+                const LevelIndexEntry first = get_level_index_entry(request.data, 0);
+                const LevelIndexEntry last  = get_level_index_entry(request.data, texture->numLevels - 1);
+
+                data_offset = last.byte_offset;
+                data        = std::span<const U8>(request.data).subspan(data_offset, first.byte_offset + first.byte_length - data_offset);
+            }
+            else
+            {
+                data = { ktxTexture_GetData(texture), ktxTexture_GetDataSize(texture) };
+            }
+
+            // One region per level, the layers and faces of a level follow each other in the ktx data
+            std::vector<VkBufferImageCopy> regions;
+            regions.reserve(texture->numLevels);
+
+            for (U32 level = 0; level < texture->numLevels; ++level)
+            {
+                ktx_size_t offset = 0;
+
+                if (from_file)
+                {
+                    offset = get_level_index_entry(request.data, level).byte_offset - data_offset;
+                }
+                else
+                {
+                    (void)ktxTexture_GetImageOffset(texture, level, 0, 0, &offset);
+                }
+
+                regions.push_back({
+                    .bufferOffset      = offset,
+                    .bufferRowLength   = 0,
+                    .bufferImageHeight = 0,
+                    .imageSubresource  = {
+                        .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel       = level,
+                        .baseArrayLayer = 0,
+                        .layerCount     = texture->numLayers * texture->numFaces,
+                    },
+                    .imageExtent       = {
+                        .width  = std::max(texture->baseWidth  >> level, 1u),
+                        .height = std::max(texture->baseHeight >> level, 1u),
+                        .depth  = std::max(texture->baseDepth  >> level, 1u),
+                    },
+                });
+            }
+
+            // Every level goes out in one staged copy, the file contents and ktx data can be freed once it is recorded
+            m_vk.get_uploader().copy_to_texture(data.data(), data.size(), m_vk.get(asset.texture), regions);
+
+            if (generate)
+            {
+                m_vk.generate_mips(asset.texture);
+            }
+
+            break;
+        }
+        case AssetType::ShaderModule:
+        {
+            asset.shader_module = std::move(request.shader_module);
+            break;
+        }
+    }
+
+    return asset;
+}
+
+} // namespace Cr::Graphics
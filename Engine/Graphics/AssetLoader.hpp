@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include "Core/FileReader.hpp"
+
+#include "Graphics/Vulkan/API.hpp"
+
+#include <exception>
+
+struct ktxTexture2;
+
+namespace Cr::Graphics
+{
+
+using AssetID = Core::FileReader::ReadID;
+
+enum class AssetType
+{
+    Texture,      // KTX2
+    ShaderModule, // SPIR-V
+};
+
+struct LoadedAsset
+{
+    AssetID   id   = 0;
+    AssetType type = AssetType::Texture;
+
+    Vulkan::TextureHandle        texture;       // Usable from the next begin_frame on
+    Unique<Vulkan::ShaderModule> shader_module;
+};
+
+// Streams assets in three overlapping stages: files are read by the FileReader, decoded on the job system and
+// created on the GPU by update(), whose texture copies go out with the next end_frame. Finished assets are handed
+// back through take_completed().
+//
+// Basis compressed textures (ETC1S and UASTC) are transcoded by the workers to the best block compressed format
+// the device samples, BC7 or BC1 on desktop GPUs, falling back to ASTC, ETC2 and finally uncompressed RGBA.
+// Uncompressed textures stored without mips get their full chain generated by the GPU along with the upload.
+// Must be driven from the thread that runs the frame loop and created the job system.
+class AssetLoader : public NoCopy, public NoMove
+{
+    public:
+        AssetLoader() = delete;
+        AssetLoader(Vulkan::API& vk, Core::JobSystem& jobs, U32 queue_depth = 64);
+        ~AssetLoader(); // Waits for pending loads and drops them
+
+        [[nodiscard]] AssetID load_texture(const std::filesystem::path& path);
+        [[nodiscard]] AssetID load_shader_module(const std::filesystem::path& path, VkShaderStageFlags stage);
+
+        // Moves finished reads on to the workers and decoded assets on to the GPU, never blocks. Read and decode
+        // errors are rethrown here.
+        void update();
+
+        // Assets finished by update() since the last call, in completion order
+        [[nodiscard]] std::vector<LoadedAsset> take_completed() { return std::exchange(m_completed, {}); }
+
+        // Runs update() until every requested asset has completed
+        void wait_for_idle();
+
+        [[nodiscard]] U32 get_pending_count() const { return static_cast<U32>(m_requests.size()); }
+
+    private:
+        struct Request
+        {
+            ~Request(); // Frees the decoded texture when it never made it to the GPU
+
+            AssetType             type  = AssetType::Texture;
+            VkShaderStageFlags    stage = 0;
+            std::filesystem::path path;
+
+            std::vector<U8> data; // File contents until decoded, or staged for textures stored without compression
+
+            // Decoded
+            ktxTexture2*                 texture = nullptr;
+            Unique<Vulkan::ShaderModule> shader_module;
+            std::exception_ptr           error;
+        };
+
+        [[nodiscard]] AssetID load(const std::filesystem::path& path, AssetType type, VkShaderStageFlags stage);
+
+        // Runs on a worker
+        void decode(Request& request);
+
+        // Creates the GPU resource and records its upload
+        [[nodiscard]] LoadedAsset finish(AssetID id, Request& request);
+
+        Vulkan::API&     m_vk;
+        Core::JobSystem& m_jobs;
+
+        Core::FileReader m_reader;
+
+        std::unordered_map<AssetID, Unique<Request>> m_requests;
+
+        // ktx_transcode_fmt_e for Basis textures by [UASTC][alpha][sRGB], the best block format the device can sample
+        std::array<U32, 8> m_transcode_formats {};
+
+        Core::JobCounter     m_decoding;
+        std::mutex           m_mutex;
+        std::vector<AssetID> m_decoded; // Filled by the workers
+
+        std::vector<LoadedAsset> m_completed;
+};
+
+} // namespace Cr::Graphics
@@ -0,0 +1,283 @@
+#include "Graphics/Culling.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <bit>
+#include <limits>
+
+#if CR_ARCH_X86
+    #include <immintrin.h>
+#endif
+
+namespace Cr::Graphics
+{
+
+namespace
+{
+
+using Planes = std::array<Vec4f, 6>;
+
+struct Spheres
+{
+    const F32* x;
+    const F32* y;
+    const F32* z;
+    const F32* radius;
+};
+
+// Tests [begin, end) and writes the indices of the visible spheres to visible, returns how many were written.
+// Bounds are multiples of FrustumCuller::LANES.
+using CullKernel = U32 (*)(const Planes& planes, const Spheres& spheres, U32 begin, U32 end, U32* visible);
+
+U32 cull_scalar(const Planes& planes, const Spheres& spheres, U32 begin, U32 end, U32* visible)
+{
+    U32 count = 0;
+
+    for (U32 i = begin; i < end; ++i)
+    {
+        bool inside = true;
+
+        for (const auto& plane : planes)
+        {
+            const F32 distance = plane.x * spheres.x[i] + plane.y * spheres.y[i] + plane.z * spheres.z[i] + plane.w;
+
+            inside &= distance >= -spheres.radius[i];
+        }
+
+        // Branchless append, the slot is overwritten when not visible
+        visible[count] = i;
+        count += inside;
+    }
+
+    return count;
+}
+
+#if CR_ARCH_X86
+
+U32 cull_sse(const Planes& planes, const Spheres& spheres, U32 begin, U32 end, U32* visible)
+{
+    __m128 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+
+    for (U32 p = 0; p < 6; ++p)
+    {
+        plane_x[p] = _mm_set1_ps(planes[p].x);
+        plane_y[p] = _mm_set1_ps(planes[p].y);
+        plane_z[p] = _mm_set1_ps(planes[p].z);
+        plane_w[p] = _mm_set1_ps(planes[p].w);
+    }
+
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    U32 count = 0;
+
+    for (U32 i = begin; i < end; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(spheres.x + i);
+        const __m128 y = _mm_loadu_ps(spheres.y + i);
+        const __m128 z = _mm_loadu_ps(spheres.z + i);
+
+        const __m128 negative_radius = _mm_xor_ps(_mm_loadu_ps(spheres.radius + i), sign);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (U32 p = 0; p < 6; ++p)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(plane_x[p], x), plane_w[p]);
+            distance = _mm_add_ps(_mm_mul_ps(plane_y[p], y), distance);
+            distance = _mm_add_ps(_mm_mul_ps(plane_z[p], z), distance);
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+        }
+
+        for (U32 mask = static_cast<U32>(_mm_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+        {
+            visible[count++] = i + static_cast<U32>(std::countr_zero(mask));
+        }
+    }
+
+    return count;
+}
+
+__attribute__((target("avx2,fma")))
+U32 cull_avx2(const Planes& planes, const Spheres& spheres, U32 begin, U32 end, U32* visible)
+{
+    __m256 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+
+    for (U32 p = 0; p < 6; ++p)
+    {
+        plane_x[p] = _mm256_set1_ps(planes[p].x);
+        plane_y[p] = _mm256_set1_ps(planes[p].y);
+        plane_z[p] = _mm256_set1_ps(planes[p].z);
+        plane_w[p] = _mm256_set1_ps(planes[p].w);
+    }
+
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    U32 count = 0;
+
+    for (U32 i = begin; i < end; i += 8)
+    {
+        const __m256 x = _mm256_loadu_ps(spheres.x + i);
+        const __m256 y = _mm256_loadu_ps(spheres.y + i);
+        const __m256 z = _mm256_loadu_ps(spheres.z + i);
+
+        const __m256 negative_radius = _mm256_xor_ps(_mm256_loadu_ps(spheres.radius + i), sign);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (U32 p = 0; p < 6; ++p)
+        {
+            __m256 distance = _mm256_fmadd_ps(plane_x[p], x, plane_w[p]);
+            distance = _mm256_fmadd_ps(plane_y[p], y, distance);
+            distance = _mm256_fmadd_ps(plane_z[p], z, distance);
+
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negative_radius, _CMP_GE_OQ));
+        }
+
+        for (U32 mask = static_cast<U32>(_mm256_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+        {
+            visible[count++] = i + static_cast<U32>(std::countr_zero(mask));
+        }
+    }
+
+    return count;
+}
+
+#endif // CR_ARCH_X86
+
+struct Kernel
+{
+    CullKernel  function;
+    const char* name;
+};
+
+// Indexed by SIMDLevel, levels the build has no code for fall back to scalar
+constexpr Kernel KERNELS[] = {
+    {cull_scalar, "scalar"},
+#if CR_ARCH_X86
+    {cull_sse,    "SSE"   },
+    {cull_avx2,   "AVX2"  },
+#else
+    {cull_scalar, "scalar"},
+    {cull_scalar, "scalar"},
+#endif
+};
+
+const Kernel*& get_selected_kernel()
+{
+    static const Kernel* kernel = &KERNELS[static_cast<U32>(get_simd_level())];
+
+    return kernel;
+}
+
+const Kernel& get_kernel()
+{
+    return *get_selected_kernel();
+}
+
+} // namespace
+
+U32 FrustumCuller::add(Vec3f center, F32 radius)
+{
+    if (m_count == m_radius.size())
+    {
+        const std::size_t padded = m_radius.size() + LANES;
+
+        m_center_x.resize(padded, 0.0f);
+        m_center_y.resize(padded, 0.0f);
+        m_center_z.resize(padded, 0.0f);
+        m_radius.resize(padded, -std::numeric_limits<F32>::infinity());
+    }
+
+    const U32 index = m_count++;
+    set(index, center, radius);
+
+    return index;
+}
+
+void FrustumCuller::set(U32 index, Vec3f center, F32 radius)
+{
+    CR_ASSERT(index < m_count, "Bounding sphere index {} out of range", index);
+
+    m_center_x[index] = center.x;
+    m_center_y[index] = center.y;
+    m_center_z[index] = center.z;
+    m_radius[index]   = radius;
+}
+
+void FrustumCuller::clear()
+{
+    m_center_x.clear();
+    m_center_y.clear();
+    m_center_z.clear();
+    m_radius.clear();
+
+    m_count = 0;
+}
+
+void FrustumCuller::cull(const Mat4f& projected_view, std::vector<U32>& visible) const
+{
+    const Planes  planes  = get_frustum_planes(projected_view);
+    const Spheres spheres = {m_center_x.data(), m_center_y.data(), m_center_z.data(), m_radius.data()};
+
+    const U32 padded = static_cast<U32>(m_radius.size());
+
+    visible.resize(padded);
+    visible.resize(get_kernel().function(planes, spheres, 0, padded, visible.data()));
+}
+
+void FrustumCuller::cull(const Mat4f& projected_view, std::vector<U32>& visible, Core::JobSystem& jobs, U32 batch_size) const
+{
+    const Planes  planes  = get_frustum_planes(projected_view);
+    const Spheres spheres = {m_center_x.data(), m_center_y.data(), m_center_z.data(), m_radius.data()};
+
+    const U32 padded = static_cast<U32>(m_radius.size());
+
+    batch_size = std::max(LANES, (batch_size + LANES - 1) / LANES * LANES);
+
+    const U32 batch_count = (padded + batch_size - 1) / batch_size;
+
+    // Every batch compacts into its own range of the output, the ranges are then packed together in order
+    std::vector<U32> batch_visible(batch_count);
+    visible.resize(padded);
+
+    const CullKernel kernel = get_kernel().function;
+
+    jobs.parallel_for(padded, batch_size, [&](U32 begin, U32 end)
+    {
+        batch_visible[begin / batch_size] = kernel(planes, spheres, begin, end, visible.data() + begin);
+    });
+
+    U32 count = 0;
+
+    for (U32 batch = 0; batch < batch_count; ++batch)
+    {
+        const auto first       = visible.begin() + std::size_t(batch) * batch_size;
+        const auto destination = visible.begin() + count;
+
+        // Ranges only ever move left, they stay in place as long as every earlier sphere was visible. std::copy does
+        // not allow the destination to start inside the source.
+        if (destination != first)
+        {
+            std::copy(first, first + batch_visible[batch], destination);
+        }
+
+        count += batch_visible[batch];
+    }
+
+    visible.resize(count);
+}
+
+const char* FrustumCuller::get_kernel_name()
+{
+    return get_kernel().name;
+}
+
+void FrustumCuller::set_kernel(SIMDLevel level)
+{
+    CR_ASSERT_THROW(is_simd_level_supported(level), "Culling kernel {} is not supported by this CPU", to_string(level));
+
+    get_selected_kernel() = &KERNELS[static_cast<U32>(level)];
+}
+
+} // namespace Cr::Graphics
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/Math.hpp"
+#include "Crunch/ClassUtility.hpp"
+#include "Crunch/CPU.hpp"
+
+namespace Cr::Core { class JobSystem; }
+
+namespace Cr::Graphics
+{
+
+// Bounding spheres kept as structure of arrays and tested against the view frustum up to eight at a time, with the
+// kernel of get_simd_level(). Spheres are identified by their insertion index.
+class FrustumCuller : public NoCopy
+{
+    public:
+        static constexpr U32 LANES = 8; // Arrays are padded to the widest kernel
+
+        FrustumCuller() = default;
+        ~FrustumCuller() = default;
+
+        [[nodiscard]] U32 add(Vec3f center, F32 radius);
+        void set(U32 index, Vec3f center, F32 radius);
+        void clear();
+
+        // Indices of every sphere intersecting the frustum of projected_view in increasing order, replaces visible
+        void cull(const Mat4f& projected_view, std::vector<U32>& visible) const;
+
+        // Same as above, split across the job system in batches of batch_size spheres
+        void cull(const Mat4f& projected_view, std::vector<U32>& visible, Core::JobSystem& jobs, U32 batch_size = 16 * 1024) const;
+
+        [[nodiscard]] U32 size() const { return m_count; }
+
+        // Name of the kernel selected for this CPU
+        [[nodiscard]] static const char* get_kernel_name();
+
+        // Replaces the kernel selected for this CPU, for tests and benchmarks comparing instruction sets. Not
+        // synchronized with culls running on other threads.
+        static void set_kernel(SIMDLevel level);
+
+    private:
+        std::vector<F32> m_center_x;
+        std::vector<F32> m_center_y;
+        std::vector<F32> m_center_z;
+        std::vector<F32> m_radius; // Padding lanes hold -infinity and are never visible
+
+        U32 m_count = 0;
+};
+
+} // namespace Cr::Graphics
@@ -25,12 +25,49 @@ enum class ShaderStage : U32
     FRAGMENT,
 };
 
-// Has a 128-bytes minimum support
+// Has a 128-bytes minimum support, shared by every shader
 struct PushConstantObject
 {
     alignas(16) Mat4f model; // 64-bytes
+
+    // Descriptor heap indices
+    U32 frame_buffer_index;
+    U32 texture_index;
+};
+
+static_assert(sizeof(PushConstantObject) <= 128);
+
+// GPU driven rendering, mirrors the std430 structures of the culling and indirect shaders
+
+struct GPUMesh
+{
+    U32 index_count;
+    U32 first_index;
+    I32 vertex_offset;
+    U32 padding;
 };
 
+struct GPUInstance
+{
+    Mat4f model;
+    Vec4f bounds; // Local bounding sphere, center and radius
+
+    U32 mesh_index;
+    U32 texture_index;
+    U32 padding[2];
+};
+
+static_assert(sizeof(GPUMesh)     == 16);
+static_assert(sizeof(GPUInstance) == 96);
+
+// Affine transform compressed to its first three rows, the last one is always (0, 0, 0, 1)
+struct GPUTransform
+{
+    Vec4f rows[3];
+};
+
+static_assert(sizeof(GPUTransform) == 48);
+
 struct UniformBufferObject
 {
     alignas(16) Mat4f projected_view;
@@ -17,32 +17,58 @@ SPIRVReflection::SPIRVReflection(std::span<const U8> spirv_binary)
 
 SPIRVReflection::~SPIRVReflection() = default; // Workaround for forward declaration of type in std::unique_ptr 
 
-std::vector<SpvReflectInterfaceVariable*> SPIRVReflection::get_inputs() const
+std::pmr::vector<SpvReflectInterfaceVariable*> SPIRVReflection::get_inputs(std::pmr::memory_resource* memory) const
 {
     U32 count;
     auto result = m_reflection->EnumerateInputVariables(&count, nullptr);
     SPV_ASSERT_THROW(result, "Failed to get SPIRV input variable count: {}", to_string(result));
 
-    std::vector<SpvReflectInterfaceVariable*> variables(count);
+    std::pmr::vector<SpvReflectInterfaceVariable*> variables(count, memory);
     result = m_reflection->EnumerateInputVariables(&count, variables.data());
     SPV_ASSERT_THROW(result, "Failed to enumerate SPIRV input variables: {}", to_string(result));
 
     return variables;
 }
 
-std::vector<SpvReflectDescriptorSet*> SPIRVReflection::get_descriptor_sets() const
+std::pmr::vector<SpvReflectDescriptorSet*> SPIRVReflection::get_descriptor_sets(std::pmr::memory_resource* memory) const
 {
     U32 count;
     auto result = m_reflection->EnumerateDescriptorSets(&count, nullptr);
     SPV_ASSERT_THROW(result, "Failed to get SPIRV descriptor set count: {}", to_string(result));
 
-    std::vector<SpvReflectDescriptorSet*> sets(count);
+    std::pmr::vector<SpvReflectDescriptorSet*> sets(count, memory);
     result = m_reflection->EnumerateDescriptorSets(&count, sets.data());
     SPV_ASSERT_THROW(result, "Failed to enumerate SPIRV descriptor sets: {}", to_string(result));
 
     return sets;
 }
 
+std::pmr::vector<SpvReflectDescriptorBinding*> SPIRVReflection::get_descriptor_bindings(std::pmr::memory_resource* memory) const
+{
+    U32 count;
+    auto result = m_reflection->EnumerateDescriptorBindings(&count, nullptr);
+    SPV_ASSERT_THROW(result, "Failed to get SPIRV descriptor binding count: {}", to_string(result));
+
+    std::pmr::vector<SpvReflectDescriptorBinding*> bindings(count, memory);
+    result = m_reflection->EnumerateDescriptorBindings(&count, bindings.data());
+    SPV_ASSERT_THROW(result, "Failed to enumerate SPIRV descriptor bindings: {}", to_string(result));
+
+    return bindings;
+}
+
+std::pmr::vector<SpvReflectBlockVariable*> SPIRVReflection::get_push_constant_blocks(std::pmr::memory_resource* memory) const
+{
+    U32 count;
+    auto result = m_reflection->EnumeratePushConstantBlocks(&count, nullptr);
+    SPV_ASSERT_THROW(result, "Failed to get SPIRV push constant block count: {}", to_string(result));
+
+    std::pmr::vector<SpvReflectBlockVariable*> blocks(count, memory);
+    result = m_reflection->EnumeratePushConstantBlocks(&count, blocks.data());
+    SPV_ASSERT_THROW(result, "Failed to enumerate SPIRV push constant blocks: {}", to_string(result));
+
+    return blocks;
+}
+
 static constexpr const char* to_string(SpvReflectResult result)
 {
     switch(result)
@@ -2,6 +2,7 @@
 
 #include "Graphics/Graphics.hpp"
 #include "Crunch/ClassUtility.hpp"
+#include "Crunch/Memory.hpp"
 
 #include <spirv_reflect.h>
 
@@ -14,8 +15,11 @@ class SPIRVReflection : public NoCopy
         SPIRVReflection(std::span<const U8> spirv_binary);
         ~SPIRVReflection();
 
-        std::vector<SpvReflectDescriptorSet*>     get_descriptor_sets() const;
-        std::vector<SpvReflectInterfaceVariable*> get_inputs() const;
+        // Results are allocated from memory, pass a scratch arena when they do not outlive the caller
+        std::pmr::vector<SpvReflectDescriptorSet*>     get_descriptor_sets     (std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
+        std::pmr::vector<SpvReflectDescriptorBinding*> get_descriptor_bindings (std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
+        std::pmr::vector<SpvReflectBlockVariable*>     get_push_constant_blocks(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
+        std::pmr::vector<SpvReflectInterfaceVariable*> get_inputs              (std::pmr::memory_resource* memory = std::pmr::get_default_resource()) const;
 
     private:
         Unique<spv_reflect::ShaderModule> m_reflection;
@@ -10,6 +10,7 @@
 #include <optional>
 #include <algorithm>
 #include <limits>
+#include <thread>
 
 namespace Cr::Graphics::Vulkan
 {
@@ -22,19 +23,92 @@ struct SwapChainSupportDetails
     std::vector<VkPresentModeKHR> present_modes;
 };
 
+static SwapChainSupportDetails get_swap_chain_support(VkPhysicalDevice device, VkSurfaceKHR surface)
+{
+    SwapChainSupportDetails details {};
+
+    VK_ASSERT_THROW(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities), "Failed to fetch physical device surface capabilities");
+
+    U32 format_count;
+    VK_ASSERT_THROW(vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &format_count, nullptr), "Failed to get physical device surface format count");
+
+    if (format_count > 0)
+    {
+        details.formats.resize(format_count);
+        VK_ASSERT_THROW(vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &format_count, details.formats.data()), "Failed to get physical device surface formats");
+    }
+
+    U32 present_mode_count;
+    VK_ASSERT_THROW(vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &present_mode_count, nullptr), "Failed to get physical device surface present_mode count");
+
+    if (present_mode_count > 0)
+    {
+        details.present_modes.resize(present_mode_count);
+        VK_ASSERT_THROW(vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &present_mode_count, details.present_modes.data()), "Failed to get physical device surface present_modes");
+    }
+
+    return details;
+}
+
+// Higher is preferred, CPU implementations (lavapipe, swiftshader) are accepted as a last resort
+static constexpr U32 get_device_type_rank(VkPhysicalDeviceType type)
+{
+    switch (type)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU   : return 4;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU : return 3;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU    : return 2;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU            : return 1;
+        default: return 0;
+    }
+}
+
+static constexpr const char* PIPELINE_CACHE_PATH = "Cache/pipeline_cache.bin";
+
+// First family supporting every required flag and none of the excluded ones
+static std::optional<U32> find_queue_family(std::span<const VkQueueFamilyProperties> families, VkQueueFlags required, VkQueueFlags excluded)
+{
+    for (U32 index = 0; index < families.size(); ++index)
+    {
+        const VkQueueFlags flags = families[index].queueFlags;
+
+        if ((flags & required) == required && (flags & excluded) == 0 && families[index].queueCount > 0)
+        {
+            return index;
+        }
+    }
+
+    return std::nullopt;
+}
+
 API::API(const Core::Window& surface_context, bool debug)
+    : API(&surface_context, {}, debug)
+{
+}
+
+API::API(VkExtent2D offscreen_extent, bool debug)
+    : API(nullptr, offscreen_extent, debug)
+{
+}
+
+API::API(const Core::Window* surface_context, VkExtent2D extent, bool debug)
 {
     U32 version;
     VK_ASSERT_THROW(vkEnumerateInstanceVersion(&version), "Failed to get Vulkan version");
 
     CR_ASSERT_THROW(version >= VK_VERSION_1_3, "Not a supported vulkan version");
 
-    U32 glfw_extension_count;
-    const char** glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
-
-    std::vector<const char*> instance_extensions(glfw_extensions, glfw_extensions + glfw_extension_count);
+    std::vector<const char*> instance_extensions;
     std::vector<const char*> validation_layers;
 
+    if (surface_context != nullptr)
+    {
+        U32 glfw_extension_count;
+        const char** glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+
+        instance_extensions.assign(glfw_extensions, glfw_extensions + glfw_extension_count);
+    }
+
     if (debug == true)
     {
         instance_extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -104,42 +178,86 @@ API::API(const Core::Window& surface_context, bool debug)
         m_debug_messenger = nullptr;
     }
 
-    VK_ASSERT_THROW(glfwCreateWindowSurface(m_instance, surface_context.get_native(), nullptr, &m_surface), "Failed to create Vulkan surface");
+    if (surface_context != nullptr)
+    {
+        VK_ASSERT_THROW(glfwCreateWindowSurface(m_instance, surface_context->get_native(), nullptr, &m_surface), "Failed to create Vulkan surface");
+    }
 
-    // Physical device
+    std::vector<const char*> device_extensions(Extensions::DEVICE_EXTENSION_LIST.begin(), Extensions::DEVICE_EXTENSION_LIST.end());
 
+    if (m_surface)
+    {
+        device_extensions.insert(device_extensions.end(), Extensions::PRESENTATION_EXTENSION_LIST.begin(), Extensions::PRESENTATION_EXTENSION_LIST.end());
+    }
+
+    // Physical device
 
     // Should maybe pack these and other useful information some GPU info structure
-    U32 queue_family_index;
-    SwapChainSupportDetails swap_chain_details{};
+    U32 queue_family_index = 0;
+    U32 selected_rank = 0;
+
+    // Queue family lists of every candidate, rewound per device
+    std::array<std::byte, 1024> scratch_buffer;
+    LinearArena scratch { scratch_buffer };
 
     m_physical_device = nullptr;
     for (auto device : get_physical_devices(m_instance))
     {
+        scratch.reset();
+
         // Confirm properties and features
 
         VkPhysicalDeviceProperties properties;
         vkGetPhysicalDeviceProperties(device, &properties);
 
-        if (properties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ||
+        const U32 rank = get_device_type_rank(properties.deviceType);
+
+        if (rank <= selected_rank ||
             properties.apiVersion <  VK_VERSION_1_3)
             continue;
 
-        VkPhysicalDeviceFeatures features;
-        vkGetPhysicalDeviceFeatures(device, &features);
+        VkPhysicalDeviceVulkan12Features vulkan12_features {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        };
 
-        if (features.samplerAnisotropy != VK_TRUE)
+        VkPhysicalDeviceFeatures2 features {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &vulkan12_features,
+        };
+
+        vkGetPhysicalDeviceFeatures2(device, &features);
+
+        if (features.features.samplerAnisotropy != VK_TRUE)
             continue;
 
-        // Confirm queue families
-        // TODO Query for dedicated families
-        
+        // Bindless descriptor heap
+        if (vulkan12_features.runtimeDescriptorArray                        != VK_TRUE ||
+            vulkan12_features.descriptorBindingPartiallyBound               != VK_TRUE ||
+            vulkan12_features.descriptorBindingSampledImageUpdateAfterBind  != VK_TRUE ||
+            vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind != VK_TRUE ||
+            vulkan12_features.descriptorBindingStorageImageUpdateAfterBind  != VK_TRUE ||
+            vulkan12_features.descriptorBindingUpdateUnusedWhilePending     != VK_TRUE ||
+            vulkan12_features.shaderSampledImageArrayNonUniformIndexing     != VK_TRUE ||
+            vulkan12_features.shaderStorageBufferArrayNonUniformIndexing    != VK_TRUE)
+            continue;
+
+        // GPU driven rendering, culled commands point their firstInstance at the instance data
+        if (features.features.multiDrawIndirect         != VK_TRUE ||
+            features.features.drawIndirectFirstInstance != VK_TRUE ||
+            vulkan12_features.drawIndirectCount          != VK_TRUE)
+            continue;
+
+        // Confirm queue families, dedicated ones are looked up once the device is selected
+
         U32 family_index = 0;
         std::optional<U32> suitable_family;
-        for (const auto& property : get_physical_device_queue_properties(device))
+        for (const auto& property : get_physical_device_queue_properties(device, &scratch))
         {
-            VkBool32 supports_presentation = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, family_index, m_surface, &supports_presentation);
+            VkBool32 supports_presentation = true;
+            if (m_surface)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, family_index, m_surface, &supports_presentation);
+            }
 
             if ((property.queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
                 (property.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
@@ -159,7 +277,7 @@ API::API(const Core::Window& surface_context, bool debug)
         auto extension_properties = get_physical_device_extension_properties(device);
 
         U32 extensions_found = 0;
-        for (const char* extension : Extensions::DEVICE_EXTENSION_LIST)
+        for (const char* extension : device_extensions)
         {
             for (const auto& property : extension_properties)
             {
@@ -171,33 +289,19 @@ API::API(const Core::Window& surface_context, bool debug)
             }
         }
 
-        if (extensions_found != Extensions::DEVICE_EXTENSION_LIST.size()) { continue; }
+        if (extensions_found != device_extensions.size()) { continue; }
 
         // Confirm Swap chain support
-        VK_ASSERT_THROW(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, m_surface, &swap_chain_details.capabilities), "Failed to fetch physical device surface capabilities");
-
-        U32 format_count;
-        VK_ASSERT_THROW(vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &format_count, nullptr), "Failed to get physical device surface format count");
-        
-        if (format_count > 0)
+        if (m_surface)
         {
-            swap_chain_details.formats.resize(format_count);
-            VK_ASSERT_THROW(vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &format_count, swap_chain_details.formats.data()), "Failed to get physical device surface formats");
-        }
+            const auto swap_chain_details = get_swap_chain_support(device, m_surface);
 
-        U32 present_mode_count;
-        VK_ASSERT_THROW(vkGetPhysicalDeviceSurfacePresentModesKHR(device, m_surface, &present_mode_count, nullptr), "Failed to get physical device surface present_mode count");
-        
-        if (present_mode_count > 0)
-        {
-            swap_chain_details.present_modes.resize(present_mode_count);
-            VK_ASSERT_THROW(vkGetPhysicalDeviceSurfacePresentModesKHR(device, m_surface, &present_mode_count, swap_chain_details.present_modes.data()), "Failed to get physical device surface present_modes");
+            if (swap_chain_details.formats.empty() || swap_chain_details.present_modes.empty()) { continue; }
         }
 
-        if (swap_chain_details.formats.empty() || swap_chain_details.present_modes.empty()) { continue; }
-
         m_physical_device = device;
         queue_family_index = suitable_family.value();
+        selected_rank = rank;
     }
     
     CR_ASSERT_THROW(m_physical_device != nullptr, "No suitable Vulkan device found.");
@@ -205,33 +309,109 @@ API::API(const Core::Window& surface_context, bool debug)
     vkGetPhysicalDeviceFeatures(m_physical_device, &m_physical_device_features);
     vkGetPhysicalDeviceProperties(m_physical_device, &m_physical_device_properties);
 
-    CR_INFO("Suitable device: %s", m_physical_device_properties.deviceName);
+    CR_INFO("Suitable device: {}", m_physical_device_properties.deviceName);
+
+    // Dedicated families let uploads and compute overlap graphics work. Transfer prefers a pure DMA family, then
+    // an async compute family, compute prefers any family without graphics.
+
+    scratch.reset();
+    const auto queue_families = get_physical_device_queue_properties(m_physical_device, &scratch);
+
+    const std::optional<U32> compute_family  = find_queue_family(queue_families, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+    const std::optional<U32> transfer_family = find_queue_family(queue_families, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+
+    struct QueueLocation { U32 family; U32 index; };
+
+    std::vector<VkDeviceQueueCreateInfo> queue_info_list;
+
+    // Hands out the next queue of a family, callers make sure the family has enough of them
+    auto request_queue = [&](U32 family) -> QueueLocation
+    {
+        for (auto& info : queue_info_list)
+        {
+            if (info.queueFamilyIndex == family)
+            {
+                return { family, info.queueCount++ };
+            }
+        }
 
-    F32 queue_priority = 1.0f;
-    std::array queue_info_list {
-        VkDeviceQueueCreateInfo {
+        queue_info_list.push_back({
             .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-            .queueFamilyIndex = queue_family_index,
+            .queueFamilyIndex = family,
             .queueCount       = 1,
-            .pQueuePriorities = &queue_priority,
-        },
+        });
+
+        return { family, 0 };
     };
 
+    const QueueLocation graphics_queue = request_queue(queue_family_index);
+
+    std::optional<QueueLocation> compute_queue;
+    std::optional<QueueLocation> transfer_queue;
+
+    if (compute_family.has_value())
+    {
+        compute_queue = request_queue(compute_family.value());
+    }
+
+    if (transfer_family.has_value())
+    {
+        transfer_queue = request_queue(transfer_family.value());
+    }
+    else if (compute_family.has_value() && queue_families[compute_family.value()].queueCount > 1)
+    {
+        transfer_queue = request_queue(compute_family.value()); // Second async compute queue, uploads use it otherwise
+    }
+
+    // All queues get the same priority, the array only has to cover the largest request
+    std::vector<F32> queue_priorities;
+    for (const auto& info : queue_info_list)
+    {
+        queue_priorities.resize(std::max<std::size_t>(queue_priorities.size(), info.queueCount), 1.0f);
+    }
+
+    for (auto& info : queue_info_list)
+    {
+        info.pQueuePriorities = queue_priorities.data();
+    }
+
     // Logical device
 
-    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_feature {};
-    dynamic_rendering_feature.sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
-    dynamic_rendering_feature.pNext            = nullptr;
-    dynamic_rendering_feature.dynamicRendering = VK_TRUE;
+    // Dynamic rendering replaces render passes, synchronization2 backs queue submissions
+    VkPhysicalDeviceVulkan13Features vulkan13_features {};
+    vulkan13_features.sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    vulkan13_features.pNext            = nullptr;
+    vulkan13_features.dynamicRendering = VK_TRUE;
+    vulkan13_features.synchronization2 = VK_TRUE;
+
+    // Core since 1.2, queues hand work to each other through timeline semaphores
+    VkPhysicalDeviceVulkan12Features vulkan12_features {};
+    vulkan12_features.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12_features.pNext             = &vulkan13_features;
+    vulkan12_features.timelineSemaphore = VK_TRUE;
+
+    // Bindless descriptor heap, arrays indexed by shaders and written while in use
+    vulkan12_features.descriptorIndexing                            = VK_TRUE;
+    vulkan12_features.runtimeDescriptorArray                        = VK_TRUE;
+    vulkan12_features.descriptorBindingPartiallyBound               = VK_TRUE;
+    vulkan12_features.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+    vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    vulkan12_features.descriptorBindingStorageImageUpdateAfterBind  = VK_TRUE;
+    vulkan12_features.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+    vulkan12_features.shaderSampledImageArrayNonUniformIndexing     = VK_TRUE;
+    vulkan12_features.shaderStorageBufferArrayNonUniformIndexing    = VK_TRUE;
+
+    // GPU driven rendering, draw counts written by compute passes
+    vulkan12_features.drawIndirectCount = VK_TRUE;
 
     VkDeviceCreateInfo logical_device_info{};
     logical_device_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     logical_device_info.pQueueCreateInfos       = queue_info_list.data();
     logical_device_info.queueCreateInfoCount    = static_cast<U32>(queue_info_list.size());
-    logical_device_info.ppEnabledExtensionNames = Extensions::DEVICE_EXTENSION_LIST.data();
-    logical_device_info.enabledExtensionCount   = static_cast<U32>(Extensions::DEVICE_EXTENSION_LIST.size());
+    logical_device_info.ppEnabledExtensionNames = device_extensions.data();
+    logical_device_info.enabledExtensionCount   = static_cast<U32>(device_extensions.size());
     logical_device_info.pEnabledFeatures        = &m_physical_device_features;
-    logical_device_info.pNext                   = &dynamic_rendering_feature;
+    logical_device_info.pNext                   = &vulkan12_features;
 
     if (debug)
     {
@@ -243,7 +423,22 @@ API::API(const Core::Window& surface_context, bool debug)
 
     (void)Extensions::bind_device_extension_functions(m_device);
 
-    m_queue = Queue(m_device, queue_family_index, 0);
+    m_queue = Queue(m_device, graphics_queue.family, graphics_queue.index);
+
+    if (compute_queue.has_value())
+    {
+        m_compute_queue = Queue(m_device, compute_queue->family, compute_queue->index);
+    }
+
+    if (transfer_queue.has_value())
+    {
+        m_transfer_queue = Queue(m_device, transfer_queue->family, transfer_queue->index);
+    }
+
+    CR_INFO("Queue families: graphics {}, compute {}, transfer {}",
+        m_queue.get_family_index(),
+        get_command_queue(VK_QUEUE_COMPUTE_BIT).get_family_index(),
+        get_command_queue(VK_QUEUE_TRANSFER_BIT).get_family_index());
 
     // Create Vulkan Memory Allocator
 
@@ -255,6 +450,65 @@ API::API(const Core::Window& surface_context, bool debug)
 
     VK_ASSERT_THROW(vmaCreateAllocator(&allocator_info, &m_allocator), "Failed to initialize VmaAllocator");
 
+    m_pipeline_cache = PipelineCache(m_device, m_physical_device_properties, PIPELINE_CACHE_PATH);
+    m_layout_cache   = create_unique<Vulkan::LayoutCache>(m_device);
+    m_sampler_cache  = create_unique<Vulkan::SamplerCache>(m_device, m_physical_device_properties.limits);
+
+    m_descriptor_heap = create_unique<Vulkan::DescriptorHeap>(m_device, m_physical_device, *m_layout_cache);
+
+    m_uploader = create_unique<Vulkan::Uploader>(m_allocator, get_command_queue(VK_QUEUE_TRANSFER_BIT), m_queue.get_family_index());
+
+    std::array<Vulkan::Queue*, DeletionQueue::MAX_QUEUES> queues { &m_queue };
+    U32 queue_count = 1;
+
+    for (Vulkan::Queue* queue : { &m_compute_queue, &m_transfer_queue })
+    {
+        if (queue->is_valid()) { queues[queue_count++] = queue; }
+    }
+
+    m_deletion_queue = create_unique<Vulkan::DeletionQueue>(std::span(queues.data(), queue_count));
+
+    m_mip_generator = create_unique<Vulkan::MipGenerator>(m_allocator, m_physical_device, *m_descriptor_heap, *m_deletion_queue);
+
+    if (surface_context != nullptr)
+    {
+        create_swap_chain(*surface_context);
+    }
+    else
+    {
+        create_offscreen_targets(extent);
+    }
+
+    // Create command buffers and sync objects
+
+    // TODO SWAP CHAIN COMMAND BUFFERS
+
+    VkSemaphoreCreateInfo semaphore_info {};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_info.pNext = nullptr;
+    semaphore_info.flags = 0;
+
+    m_recording_thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+    {
+        VK_ASSERT_THROW((vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_image_available_semaphore[frame]) |
+                         vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_render_finished_semaphore[frame])), "Failed to create synchronization objects");
+
+        m_command_pools[frame].reserve(m_recording_thread_count);
+        for (U32 thread = 0; thread < m_recording_thread_count; ++thread)
+        {
+            m_command_pools[frame].emplace_back(m_device, m_queue.get_family_index());
+        }
+    }
+
+    CR_INFO("Vulkan initialized");
+}
+
+void API::create_swap_chain(const Core::Window& surface_context)
+{
+    const auto swap_chain_details = get_swap_chain_support(m_physical_device, m_surface);
+
     // Select swap chain format
 
     VkSurfaceFormatKHR surface_format;
@@ -367,53 +621,78 @@ API::API(const Core::Window& surface_context, bool debug)
         
         VK_ASSERT_THROW(vkCreateImageView(m_device, &image_info, nullptr, &m_swap_image_views[i]), "Failed to create swap chain image view");
     }
+}
+
+void API::create_offscreen_targets(VkExtent2D extent)
+{
+    // Prefer the same format a swap chain would get so pipelines stay interchangeable
+    constexpr VkFormatFeatureFlags required_features = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT;
 
-//    // Create descriptor pool (Shader uniform buffers)
+    m_swap_format = VK_FORMAT_UNDEFINED;
+    for (VkFormat format : { VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM })
+    {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(m_physical_device, format, &properties);
 
-    std::array<VkDescriptorPoolSize, 2> descriptor_pool_size {
-        VkDescriptorPoolSize {
-            .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount = 128,
-        },
-        VkDescriptorPoolSize {
-            .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 128,
+        if ((properties.optimalTilingFeatures & required_features) == required_features)
+        {
+            m_swap_format = format;
+            break;
         }
-    };
+    }
 
-    VkDescriptorPoolCreateInfo descriptor_pool_info{};
-    descriptor_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descriptor_pool_info.pNext = nullptr;
-    descriptor_pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descriptor_pool_info.maxSets = 128;
-    descriptor_pool_info.poolSizeCount = descriptor_pool_size.size();
-    descriptor_pool_info.pPoolSizes    = descriptor_pool_size.data();
+    CR_ASSERT_THROW(m_swap_format != VK_FORMAT_UNDEFINED, "No suitable offscreen render target format");
+    CR_ASSERT_THROW(extent.width > 0 && extent.height > 0, "Invalid offscreen extent {}x{}", extent.width, extent.height);
 
-    VK_ASSERT_THROW(vkCreateDescriptorPool(m_device, &descriptor_pool_info, nullptr, &m_descriptor_pool), "Failed to create descriptor pool");
+    m_swap_extent = extent;
 
-    // Create command buffers and sync objects
+    m_swap_images.resize(FRAMES_IN_FLIGHT);
+    m_swap_image_views.resize(FRAMES_IN_FLIGHT);
+    m_offscreen_allocations.resize(FRAMES_IN_FLIGHT);
 
-    // TODO SWAP CHAIN COMMAND BUFFERS
+    for (std::size_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+    {
+        VkImageCreateInfo image_info {
+            .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType     = VK_IMAGE_TYPE_2D,
+            .format        = m_swap_format,
+            .extent        = { extent.width, extent.height, 1 },
+            .mipLevels     = 1,
+            .arrayLayers   = 1,
+            .samples       = VK_SAMPLE_COUNT_1_BIT,
+            .tiling        = VK_IMAGE_TILING_OPTIMAL,
+            .usage         = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
 
-    VkSemaphoreCreateInfo semaphore_info {};
-    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    semaphore_info.pNext = nullptr;
-    semaphore_info.flags = 0;
+        VmaAllocationCreateInfo allocation_info {
+            .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+            .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        };
 
-    VkFenceCreateInfo fence_info {};
-    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fence_info.pNext = nullptr;
-    fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        VK_ASSERT_THROW(vmaCreateImage(m_allocator, &image_info, &allocation_info, &m_swap_images[frame], &m_offscreen_allocations[frame], nullptr), "Failed to create offscreen render target");
+
+        VkImageViewCreateInfo view_info {
+            .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image            = m_swap_images[frame],
+            .viewType         = VK_IMAGE_VIEW_TYPE_2D,
+            .format           = m_swap_format,
+            .components       = {}, // Default rgb
+            .subresourceRange = {
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel   = 0,
+                .levelCount     = 1,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+        };
 
-    for (std::size_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
-    {
-        VK_ASSERT_THROW((vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_image_available_semaphore[frame]) |
-                         vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_render_finished_semaphore[frame]) |
-                         vkCreateFence(    m_device, &fence_info,     nullptr, &m_in_flight_fence[frame])), "Failed to create synchronization objects");
-        m_command_buffer[frame] = m_queue.create_command_buffer();
-    }
+        VK_ASSERT_THROW(vkCreateImageView(m_device, &view_info, nullptr, &m_swap_image_views[frame]), "Failed to create offscreen render target view");
 
-    CR_INFO("Vulkan initialized");
+        // Formats above are all 4 bytes per texel
+        m_readback_buffer[frame] = create_unique<Vulkan::Buffer>(m_allocator, VK_BUFFER_USAGE_TRANSFER_DST_BIT, U64(extent.width) * extent.height * 4, Vulkan::HostAccess::Random);
+    }
 }
 
 API::~API()
@@ -422,12 +701,17 @@ API::~API()
     {
         vkDeviceWaitIdle(m_device);
 
-        // TODO Most of this is really stupid and should be moved to pools or other lifetime management methods
+        // Pooled resources hold heap slots, allocations and pipelines destroyed further down
+        m_deletion_queue->flush();
 
-        for (auto fence : m_in_flight_fence)
-        {
-            vkDestroyFence(m_device, fence, nullptr);
-        }
+        m_meshes.clear();
+        m_shaders.clear();
+        m_textures.clear();
+        m_buffers.clear();
+
+        m_mip_generator = {};
+
+        // TODO Most of this is really stupid and should be moved to pools or other lifetime management methods
 
         for (auto semaphore : m_image_available_semaphore)
         {
@@ -439,7 +723,19 @@ API::~API()
             vkDestroySemaphore(m_device, semaphore, nullptr);
         }
 
-        vkDestroyDescriptorPool(m_device, m_descriptor_pool, nullptr);
+        try
+        {
+            m_pipeline_cache.save();
+        }
+        catch (const std::exception& e)
+        {
+            CR_WARN("Failed to save pipeline cache: {}", e.what()); // Only costs compile time on the next launch
+        }
+
+        m_pipeline_cache  = {};
+        m_descriptor_heap = {};
+        m_layout_cache    = {};
+        m_sampler_cache   = {};
 
         for (auto image_view : m_swap_image_views)
         {
@@ -448,10 +744,20 @@ API::~API()
 
         vkDestroySwapchainKHR(m_device, m_swap_chain, nullptr);
 
+        for (std::size_t i = 0; i < m_offscreen_allocations.size(); ++i)
+        {
+            vmaDestroyImage(m_allocator, m_swap_images[i], m_offscreen_allocations[i]);
+        }
+
+        m_readback_buffer = {};
+        m_uploader = {};
+
         vmaDestroyAllocator(m_allocator);
 
-        m_command_buffer = {};
-        m_queue = {}; // TODO temporary fix for lack of RAII destruction order...
+        m_command_pools = {};
+        m_queue          = {}; // TODO temporary fix for lack of RAII destruction order...
+        m_compute_queue  = {};
+        m_transfer_queue = {};
 
         vkDestroyDevice(m_device, nullptr);
     }
@@ -471,15 +777,54 @@ API::~API()
     }
 }
 
+bool API::supports_format(VkFormat format, VkFormatFeatureFlags features) const
+{
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(m_physical_device, format, &properties);
+
+    return (properties.optimalTilingFeatures & features) == features;
+}
+
 [[nodiscard]] Vulkan::Queue& API::get_command_queue(VkQueueFlags features)
 {
-    (void)features;
-    return m_queue; // TODO Handling of multiple specialized queues, use one for now
+    // Most specialized queue able to do the work, graphics families can do everything
+    if (features & VK_QUEUE_GRAPHICS_BIT)
+    {
+        return m_queue;
+    }
+
+    if (features == VK_QUEUE_TRANSFER_BIT && m_transfer_queue.is_valid())
+    {
+        return m_transfer_queue;
+    }
+
+    if (m_compute_queue.is_valid())
+    {
+        return m_compute_queue;
+    }
+
+    return m_queue;
 }
 
-[[nodiscard]] Unique<Vulkan::Buffer> API::create_buffer(VkBufferCreateFlags usage, U64 size)
+[[nodiscard]] BufferHandle API::create_buffer(VkBufferCreateFlags usage, U64 size, Vulkan::HostAccess access)
 {
-    return create_unique<Vulkan::Buffer>(m_allocator, usage, size); // TODO implement resource pooling
+    return m_buffers.emplace(m_allocator, usage, size, access, m_descriptor_heap.get());
+}
+
+[[nodiscard]] MeshHandle API::create_mesh(const void* vertices, U64 vertices_size, std::span<const U32> indices)
+{
+    const U64 indices_size = indices.size_bytes();
+
+    const Mesh mesh {
+        .vertex_buffer = create_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, vertices_size),
+        .index_buffer  = create_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT  | VK_BUFFER_USAGE_TRANSFER_DST_BIT, indices_size),
+        .index_count   = static_cast<U32>(indices.size()),
+    };
+
+    m_uploader->copy_to_buffer(vertices,       vertices_size, get(mesh.vertex_buffer), 0);
+    m_uploader->copy_to_buffer(indices.data(), indices_size,  get(mesh.index_buffer),  0);
+
+    return m_meshes.emplace(mesh);
 }
 
 [[nodiscard]] Unique<Vulkan::ShaderModule> API::create_shader_module(std::span<const U8> spirv, VkShaderStageFlags stage)
@@ -487,31 +832,152 @@ API::~API()
     return create_unique<Vulkan::ShaderModule>(m_device, spirv, stage); // TODO implement resource pooling
 }
 
-[[nodiscard]] Unique<Vulkan::Shader> API::create_shader(VkPipelineBindPoint usage, std::span<const Vulkan::ShaderModule* const> modules)
+[[nodiscard]] ShaderHandle API::create_shader(VkPipelineBindPoint usage, std::span<const Vulkan::ShaderModule* const> modules)
 {
-    return create_unique<Vulkan::Shader>(m_device, m_swap_format, usage, modules); // TODO implement resource pooling
+    return m_shaders.emplace(m_device, *m_layout_cache, *m_descriptor_heap, m_pipeline_cache.get_native(), m_swap_format, usage, modules);
 }
 
-[[nodiscard]] Unique<Vulkan::Texture> API::create_texture(VkFormat format, VkExtent3D extent)
+[[nodiscard]] Unique<Vulkan::ShaderCompiler> API::create_shader_compiler(Core::JobSystem& jobs)
 {
-    return create_unique<Vulkan::Texture>(m_allocator, format, extent); // TODO implement resource pooling
+    return create_unique<Vulkan::ShaderCompiler>(m_device, *m_layout_cache, *m_descriptor_heap, m_pipeline_cache.get_native(), m_swap_format, jobs);
 }
 
-Vulkan::CommandBuffer& API::begin_frame()
+[[nodiscard]] Unique<Vulkan::IndirectBatch> API::create_indirect_batch(U32 max_instances, U32 max_meshes)
+{
+    return create_unique<Vulkan::IndirectBatch>(m_allocator, *m_descriptor_heap, max_instances, max_meshes);
+}
+
+[[nodiscard]] Unique<Vulkan::InstanceStream> API::create_instance_stream(U32 capacity)
+{
+    return create_unique<Vulkan::InstanceStream>(m_allocator, *m_descriptor_heap, FRAMES_IN_FLIGHT, capacity);
+}
+
+[[nodiscard]] TextureHandle API::create_texture(VkFormat format, VkExtent3D extent)
 {
-    VkFence fence = m_in_flight_fence[m_frame_index];
+    return m_textures.emplace(m_allocator, format, extent, m_sampler_cache->get_sampler({}), m_descriptor_heap.get());
+}
+
+[[nodiscard]] TextureHandle API::create_texture(const Vulkan::TextureDescription& description)
+{
+    return m_textures.emplace(m_allocator, description, m_sampler_cache->get_sampler(description.sampler), m_descriptor_heap.get());
+}
+
+void API::generate_mips(TextureHandle texture)
+{
+    CR_ASSERT(m_mip_generator->get_usage(get(texture).get_format()) != 0, "Mips of the texture format can not be generated");
+
+    m_mip_requests.push_back({
+        .texture      = texture,
+        .upload_batch = m_uploader->get_flush_count(),
+    });
+}
+
+void API::destroy(BufferHandle handle)
+{
+    m_deletion_queue->push(m_buffers.take(handle));
+}
 
+void API::destroy(TextureHandle handle)
+{
+    m_deletion_queue->push(m_textures.take(handle));
+}
+
+void API::destroy(ShaderHandle handle)
+{
+    m_deletion_queue->push(m_shaders.take(handle));
+}
+
+void API::destroy(MeshHandle handle)
+{
+    const Mesh mesh = m_meshes.take(handle);
+
+    destroy(mesh.vertex_buffer);
+    destroy(mesh.index_buffer);
+}
+
+void API::draw(Vulkan::CommandBuffer& cmd, MeshHandle handle, U32 instance_count, U32 first_instance)
+{
+    const Mesh& mesh = get(handle);
+
+    cmd.bind_vertex_buffer(get(mesh.vertex_buffer));
+    cmd.bind_index_buffer(get(mesh.index_buffer), VK_INDEX_TYPE_UINT32);
+    cmd.draw_indexed(mesh.index_count, instance_count, 0, 0, first_instance);
+}
+
+Vulkan::CommandBuffer& API::begin_frame()
+{
     VkSemaphore image_available = m_image_available_semaphore[m_frame_index];
 
-    VK_ASSERT_THROW(vkWaitForFences(m_device, 1, &fence, VK_TRUE, std::numeric_limits<U64>::max()), "Failed while waiting for fences");
-    VK_ASSERT_THROW(vkResetFences(  m_device, 1, &fence), "Failed to reset renderloop fence");
+    // Frame pacing, blocks only while FRAMES_IN_FLIGHT frames are still queued up
+    m_queue.wait(m_frame_ticket[m_frame_index]);
+
+    if (is_headless())
+    {
+        m_image_index = m_frame_index;
+    }
+    else
+    {
+        VK_ASSERT_THROW(vkAcquireNextImageKHR(m_device, m_swap_chain, std::numeric_limits<U64>::max(), image_available, nullptr, &m_image_index), "Failed to acquire next image");
+    }
+
+    // Frame has retired, recycle every buffer recorded for it at once
+    for (auto& pool : m_command_pools[m_frame_index])
+    {
+        pool.reset();
+    }
+
+    m_frame_arena.begin_frame(m_frame_index);
+
+    m_deletion_queue->collect();
 
-    VK_ASSERT_THROW(vkAcquireNextImageKHR(m_device, m_swap_chain, std::numeric_limits<U64>::max(), image_available, nullptr, &m_image_index), "Failed to acquire next image");
+    m_frame_contents       = VK_SUBPASS_CONTENTS_INLINE;
+    m_frame_rendering      = false;
+    m_frame_command_buffer = &m_command_pools[m_frame_index][0].allocate(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
-    auto& cmd = *m_command_buffer[m_frame_index];
+    auto& cmd = *m_frame_command_buffer;
 
     cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
+    // Take ownership of everything uploaded since the last frame
+    m_frame_upload_value = m_uploader->acquire(cmd);
+
+    // Bound once, shaders index it through push constants
+    cmd.bind_descriptor_heap(*m_descriptor_heap, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    cmd.bind_descriptor_heap(*m_descriptor_heap, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    // Fill the mip chains of textures whose first level came with the acquired uploads, all in one batch and before
+    // anything of the frame samples them. Requests recorded after the last flush wait for the next frame.
+    if (!m_mip_requests.empty())
+    {
+        std::vector<Vulkan::Texture*> textures;
+
+        std::erase_if(m_mip_requests, [this, &textures](const MipRequest& request)
+        {
+            if (request.upload_batch >= m_uploader->get_flush_count()) { return false; }
+
+            if (m_textures.contains(request.texture))
+            {
+                textures.push_back(&get(request.texture));
+            }
+
+            return true;
+        });
+
+        m_mip_generator->generate(cmd, textures);
+    }
+
+    return cmd;
+}
+
+void API::begin_rendering(VkSubpassContents contents)
+{
+    CR_ASSERT(m_frame_command_buffer != nullptr && !m_frame_rendering, "Rendering begins once per frame, after begin_frame");
+
+    auto& cmd = *m_frame_command_buffer;
+
+    m_frame_contents  = contents;
+    m_frame_rendering = true;
+
     {
         VkImageMemoryBarrier image_memory_barrier
         {
@@ -550,54 +1016,153 @@ Vulkan::CommandBuffer& API::begin_frame()
 
     VkRenderingInfoKHR render_info{};
     render_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    render_info.flags = (contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS) ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
     render_info.renderArea = {{}, m_swap_extent};
     render_info.layerCount = 1;
     render_info.colorAttachmentCount = 1;
     render_info.pColorAttachments = &render_attachment_info;
 
     cmd.begin_rendering(render_info);
+}
+
+Vulkan::CommandBuffer& API::begin_secondary(U32 thread_index)
+{
+    CR_ASSERT(m_frame_contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS, "Rendering was not begun for secondary command buffers");
+    CR_ASSERT_THROW(thread_index < m_recording_thread_count, "Recording thread index {} out of range", thread_index);
+
+    auto& cmd = m_command_pools[m_frame_index][thread_index].allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    const VkCommandBufferInheritanceRenderingInfo rendering_info {
+        .sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .colorAttachmentCount    = 1,
+        .pColorAttachmentFormats = &m_swap_format,
+        .rasterizationSamples    = VK_SAMPLE_COUNT_1_BIT,
+    };
+
+    const VkCommandBufferInheritanceInfo inheritance {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = &rendering_info,
+    };
+
+    cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, inheritance);
+
+    // Neither bound descriptor sets nor dynamic state are inherited from the primary
+    cmd.bind_descriptor_heap(*m_descriptor_heap, VK_PIPELINE_BIND_POINT_GRAPHICS);
+
+    cmd.set_viewport(0, F32(m_swap_extent.height), F32(m_swap_extent.width), -F32(m_swap_extent.height)); // For inverted viewport
+    cmd.set_scissor(0, 0, m_swap_extent.width, m_swap_extent.height);
 
     return cmd;
 }
 
-//void API::draw(MeshID mesh_id, ShaderID shader_id, const PushConstantObject& push_constants)
-//{
-//    const VkCommandBuffer command_buffer = m_command_buffer[m_current_frame];
-//
-//    ShaderPipeline& pipeline = m_shader_pool[shader_id];
-//
-//    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.handle);
-//
-//    auto& mesh_context = m_mesh_list[mesh_id];
-//
-//    VkBuffer vertex_buffer = m_buffer_pool[mesh_context.vertex_buffer_id].handle;
-//    VkBuffer index_buffer  = m_buffer_pool[mesh_context.index_buffer_id].handle;
-//
-//    VkDeviceSize offset[] = {0};
-//
-//    vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, offset); 
-//    vkCmdBindIndexBuffer(command_buffer, index_buffer, 0, VK_INDEX_TYPE_UINT32);
-//
-//    vkCmdPushConstants(command_buffer, pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantObject), &push_constants);
-//
-//    VkDescriptorSet descriptor_set = pipeline.descriptor_set_list[m_current_frame];
-//
-//    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout, 0, 1, &descriptor_set, 0, nullptr);
-//
-//    vkCmdDrawIndexed(command_buffer, mesh_context.index_count, 1, 0, 0, 0);
-//}
-
 void API::end_frame()
 {
-    VkFence fence = m_in_flight_fence[m_frame_index];
-
     VkSemaphore image_available = m_image_available_semaphore[m_frame_index];
     VkSemaphore render_finished = m_render_finished_semaphore[m_frame_index];
 
-    auto& cmd = m_command_buffer[m_frame_index];
+    auto* cmd = m_frame_command_buffer;
+
+    CR_ASSERT(m_frame_rendering, "Frame ended without begin_rendering");
+
+    // Only waits on the transfer queue when the frame acquired uploads
+    std::pmr::vector<SemaphoreSubmit> waits { &m_frame_arena.get() };
+
+    if (m_frame_upload_value != 0)
+    {
+        waits.push_back(m_uploader->get_queue().get_wait(m_frame_upload_value, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+    }
+
+    if (m_frame_contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+    {
+        std::pmr::vector<VkCommandBuffer> secondaries { &m_frame_arena.get() };
+
+        for (const auto& pool : m_command_pools[m_frame_index])
+        {
+            for (const auto& secondary : pool.get_allocated(VK_COMMAND_BUFFER_LEVEL_SECONDARY))
+            {
+                secondary->end();
+                secondaries.push_back(secondary->get_native());
+            }
+        }
+
+        if (!secondaries.empty())
+        {
+            cmd->execute_commands(secondaries);
+        }
+    }
 
     Extensions::cmd_end_rendering(cmd->get_native());
 
+    if (is_headless())
+    {
+        VkImageMemoryBarrier image_memory_barrier
+        {
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext               = nullptr,
+            .srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout           = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = m_swap_images[m_image_index],
+            .subresourceRange
+            {
+                .aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel    = 0,
+                .levelCount      = 1,
+                .baseArrayLayer  = 0,
+                .layerCount      = 1,
+            },
+        };
+
+        cmd->pipeline_barrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, {&image_memory_barrier, 1});
+
+        const VkBufferImageCopy copy {
+            .bufferOffset      = 0,
+            .bufferRowLength   = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource  = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .layerCount = 1,
+            },
+            .imageExtent       = { m_swap_extent.width, m_swap_extent.height, 1 },
+        };
+
+        cmd->copy_image_to_buffer(m_swap_images[m_image_index], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *m_readback_buffer[m_frame_index], {&copy, 1});
+
+        // Waiting on the frame ticket only orders the host after the submission, the copy still has to be made
+        // visible to host reads
+        const VkBufferMemoryBarrier readback_barrier {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_HOST_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = m_readback_buffer[m_frame_index]->get_native(),
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        };
+
+        cmd->pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, {}, {&readback_barrier, 1}, {});
+
+        cmd->end();
+
+        m_uploader->flush();
+
+        m_frame_ticket[m_frame_index] = m_queue.submit({&cmd->get_native(), 1}, waits);
+
+        m_last_submitted_frame = m_frame_index;
+
+        m_deletion_queue->close_frame();
+
+        if (++m_frame_index == FRAMES_IN_FLIGHT)
+        {
+            m_frame_index = 0;
+        }
+        return;
+    }
+
     VkImageMemoryBarrier image_memory_barrier
     {
         .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -625,20 +1190,13 @@ void API::end_frame()
 
     // Submit commands
 
-    VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-    VkSubmitInfo submit_info {
-        .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount   = 1,
-        .pWaitSemaphores      = &image_available,
-        .pWaitDstStageMask    = &wait_stage,
-        .commandBufferCount   = 1,
-        .pCommandBuffers      = &cmd->get_native(),
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores    = &render_finished,
-    };
+    m_uploader->flush(); // Copies recorded during the frame start right away on the transfer queue
+
+    waits.push_back({ image_available, 0, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT });
+
+    const SemaphoreSubmit signal { render_finished, 0, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT };
 
-    m_queue.submit({&submit_info, 1}, fence); 
+    m_frame_ticket[m_frame_index] = m_queue.submit({&cmd->get_native(), 1}, waits, {&signal, 1});
 
     //  Present image 
 
@@ -654,12 +1212,28 @@ void API::end_frame()
 
     VK_ASSERT_THROW(vkQueuePresentKHR(m_queue.get_native(), &present_info), "Failed to present");
 
+    m_deletion_queue->close_frame();
+
     if (++m_frame_index == FRAMES_IN_FLIGHT)
     {
         m_frame_index = 0;
     }
 }
 
+void API::read_frame(std::span<U8> destination)
+{
+    CR_ASSERT_THROW(is_headless(), "Frame readback is only supported by headless API");
+
+    const U64 frame_size = U64(m_swap_extent.width) * m_swap_extent.height * 4;
+    CR_ASSERT_THROW(destination.size() >= frame_size, "Frame readback destination too small: {} < {}", destination.size(), frame_size);
+
+    CR_ASSERT_THROW(m_frame_ticket[m_last_submitted_frame] != 0, "Frame readback before the first frame was submitted");
+
+    m_queue.wait(m_frame_ticket[m_last_submitted_frame]);
+
+    m_readback_buffer[m_last_submitted_frame]->get_data(destination.data(), frame_size, 0);
+}
+
 //void API::image_destroy(ImageID image_id)
 //{
 //    Image& image = m_image_pool[image_id];
@@ -6,8 +6,21 @@
 #include "Graphics/Vulkan/Texture.hpp"
 #include "Graphics/Vulkan/Queue.hpp"
 #include "Graphics/Vulkan/CommandBuffer.hpp"
+#include "Graphics/Vulkan/CommandPool.hpp"
 #include "Graphics/Vulkan/ShaderModule.hpp"
 #include "Graphics/Vulkan/Shader.hpp"
+#include "Graphics/Vulkan/ShaderCompiler.hpp"
+#include "Graphics/Vulkan/Uploader.hpp"
+#include "Graphics/Vulkan/PipelineCache.hpp"
+#include "Graphics/Vulkan/LayoutCache.hpp"
+#include "Graphics/Vulkan/SamplerCache.hpp"
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
+#include "Graphics/Vulkan/IndirectBatch.hpp"
+#include "Graphics/Vulkan/InstanceStream.hpp"
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+#include "Graphics/Vulkan/MipGenerator.hpp"
+
+#include "Crunch/Pool.hpp"
 
 namespace Cr::Core { class Window; }
 
@@ -15,27 +28,119 @@ namespace Cr::Graphics::Vulkan {
 
 static constexpr U32 FRAMES_IN_FLIGHT = 3;
 
+struct Mesh;
+
+using BufferHandle  = Handle<Vulkan::Buffer>;
+using TextureHandle = Handle<Vulkan::Texture>;
+using ShaderHandle  = Handle<Vulkan::Shader>;
+using MeshHandle    = Handle<Vulkan::Mesh>;
+
+// Indexed geometry in its own vertex and index buffers
+struct Mesh
+{
+    BufferHandle vertex_buffer;
+    BufferHandle index_buffer;
+    U32          index_count = 0;
+};
+
 
 class API
 {
     public:
         API() = delete;
         API(const Core::Window& surface_context, bool debug = true);
+        API(VkExtent2D offscreen_extent, bool debug = true); // Headless, renders into offscreen images
         ~API();
 
-        [[nodiscard]] Unique<Vulkan::Buffer>       create_buffer(VkBufferCreateFlags usage, U64 size);
-        [[nodiscard]] Unique<Vulkan::Texture>      create_texture(VkFormat format, VkExtent3D extent);
+        // Textures and storage buffers get a stable index in the descriptor heap, see get_descriptor_index()
+        [[nodiscard]] BufferHandle  create_buffer(VkBufferCreateFlags usage, U64 size, Vulkan::HostAccess access = Vulkan::HostAccess::None);
+        [[nodiscard]] TextureHandle create_texture(VkFormat format, VkExtent3D extent);
+        [[nodiscard]] TextureHandle create_texture(const Vulkan::TextureDescription& description);
+
+        // Shared by everything asking for the same description, lives as long as the API
+        [[nodiscard]] VkSampler get_sampler(const Vulkan::SamplerDescription& description) { return m_sampler_cache->get_sampler(description); }
+
+        // Fills levels 1 and up from level 0, which must have been copied by the uploader already. Recorded by the
+        // begin_frame that acquires the copy, the texture is sampled with every level from then on. The texture needs
+        // the usage of get_mip_generator().get_usage() for its format.
+        void generate_mips(TextureHandle texture);
+
+        // Vertex data is uploaded as is, its layout has to match the shaders drawing the mesh
+        [[nodiscard]] MeshHandle create_mesh(const void* vertices, U64 vertices_size, std::span<const U32> indices);
+
+        [[nodiscard]] Unique<Vulkan::IndirectBatch>  create_indirect_batch(U32 max_instances, U32 max_meshes);
+        [[nodiscard]] Unique<Vulkan::InstanceStream> create_instance_stream(U32 capacity); // Capacity per frame in flight
 
         [[nodiscard]] Unique<Vulkan::ShaderModule> create_shader_module(std::span<const U8> spirv, VkShaderStageFlags stage);
-        [[nodiscard]] Unique<Vulkan::Shader>       create_shader(VkPipelineBindPoint usage, std::span<const Vulkan::ShaderModule* const> modules);
+        [[nodiscard]] ShaderHandle                 create_shader(VkPipelineBindPoint usage, std::span<const Vulkan::ShaderModule* const> modules);
+
+        // Asynchronous and deduplicated alternative to create_shader, compiles on the job system
+        [[nodiscard]] Unique<Vulkan::ShaderCompiler> create_shader_compiler(Core::JobSystem& jobs);
+
+        // Pooled resources resolve in O(1), references hold until the next create or destroy of the same kind
+        [[nodiscard]] Vulkan::Buffer&  get(BufferHandle  handle) { return m_buffers.get(handle);  }
+        [[nodiscard]] Vulkan::Texture& get(TextureHandle handle) { return m_textures.get(handle); }
+        [[nodiscard]] Vulkan::Shader&  get(ShaderHandle  handle) { return m_shaders.get(handle);  }
+        [[nodiscard]] const Mesh&      get(MeshHandle    handle) { return m_meshes.get(handle);   }
+
+        // Handles go stale right away, the resources live on until every submission that could use them completes
+        void destroy(BufferHandle  handle);
+        void destroy(TextureHandle handle);
+        void destroy(ShaderHandle  handle);
+        void destroy(MeshHandle    handle); // Along with its buffers
+
+        // Same for resources owned outside the pools, e.g. an indirect batch or shader replaced at runtime
+        template<typename T>
+        void destroy(Unique<T>&& resource) { m_deletion_queue->push(std::move(resource)); }
+
+        // For resources only used by known submissions, such as compute or transfer work outside of frames
+        [[nodiscard]] Vulkan::DeletionQueue& get_deletion_queue() { return *m_deletion_queue; }
+
+        // Inside rendering, binds the mesh buffers and draws every index
+        void draw(Vulkan::CommandBuffer& cmd, MeshHandle mesh, U32 instance_count = 1, U32 first_instance = 0);
 
         [[nodiscard]] Vulkan::Queue& get_command_queue(VkQueueFlags family);
 
+        // Whether optimally tiled images of the format support every feature
+        [[nodiscard]] bool supports_format(VkFormat format, VkFormatFeatureFlags features) const;
+
+        // Uploads run on the transfer queue, they are flushed by end_frame and usable from the next begin_frame on
+        [[nodiscard]] Vulkan::Uploader& get_uploader() { return *m_uploader; }
+
+        // Set its downsampling shader to generate mips with compute instead of blits
+        [[nodiscard]] Vulkan::MipGenerator& get_mip_generator() { return *m_mip_generator; }
+
+        // Frame commands start outside of rendering so compute and transfer passes can be recorded first
         [[nodiscard]] Vulkan::CommandBuffer& begin_frame();
+                                        void begin_rendering(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
                                         void end_frame();
 
+        // Rendering must have begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Thread index is the caller's
+        // Core::JobSystem::get_thread_index(). Buffers are ended and executed in thread order by end_frame.
+        [[nodiscard]] Vulkan::CommandBuffer& begin_secondary(U32 thread_index);
+
+        [[nodiscard]] constexpr U32 get_recording_thread_count() const { return m_recording_thread_count; }
+
+        // Frame in flight being recorded, in [0, FRAMES_IN_FLIGHT)
+        [[nodiscard]] constexpr U32 get_frame_index() const { return m_frame_index; }
+
+        // Scratch memory of the frame being recorded, rewound by begin_frame once the frame index comes around again
+        [[nodiscard]] LinearArena& get_frame_arena() { return m_frame_arena.get(); }
+
+        // Headless only, waits for the last submitted frame and copies its pixels out
+        void read_frame(std::span<U8> destination);
+
+        [[nodiscard]] constexpr bool       is_headless()      const { return m_surface == VK_NULL_HANDLE; }
+        [[nodiscard]] constexpr VkFormat   get_frame_format() const { return m_swap_format; }
+        [[nodiscard]] constexpr VkExtent2D get_frame_extent() const { return m_swap_extent; }
+
     // TEMP
     //private:
+        API(const Core::Window* surface_context, VkExtent2D extent, bool debug);
+
+        void create_swap_chain(const Core::Window& surface_context);
+        void create_offscreen_targets(VkExtent2D extent);
+
         static VKAPI_ATTR VkBool32 VKAPI_CALL debug_callback(
             VkDebugUtilsMessageSeverityFlagBitsEXT severity,
             VkDebugUtilsMessageTypeFlagsEXT type,
@@ -56,9 +161,17 @@ class API
         VkDevice     m_device    = VK_NULL_HANDLE;
         VmaAllocator m_allocator = VK_NULL_HANDLE;
 
-        VkDescriptorPool m_descriptor_pool = VK_NULL_HANDLE;
+        Vulkan::PipelineCache m_pipeline_cache {}; // Saved back to disk on destruction
 
-        Vulkan::Queue m_queue {};
+        Unique<Vulkan::LayoutCache>    m_layout_cache;
+        Unique<Vulkan::SamplerCache>   m_sampler_cache;   // Shared by every texture, outlives them and the heap
+        Unique<Vulkan::DescriptorHeap> m_descriptor_heap; // Bound by begin_frame and begin_secondary
+
+        Vulkan::Queue m_queue          {}; // Graphics and presentation
+        Vulkan::Queue m_compute_queue  {}; // Left invalid without a dedicated family
+        Vulkan::Queue m_transfer_queue {}; // Left invalid without a dedicated family
+
+        Unique<Vulkan::Uploader> m_uploader;
 
         // SWAP CHAIN
 
@@ -71,9 +184,45 @@ class API
 
         std::vector<VkImage>     m_swap_images;
         std::vector<VkImageView> m_swap_image_views;
-        std::array<Unique<Vulkan::CommandBuffer>, FRAMES_IN_FLIGHT> m_command_buffer {};
 
-        std::array<VkFence,     FRAMES_IN_FLIGHT> m_in_flight_fence {};
+        // HEADLESS, one offscreen target and readback buffer per frame in flight
+
+        std::vector<VmaAllocation> m_offscreen_allocations;
+        std::array<Unique<Vulkan::Buffer>, FRAMES_IN_FLIGHT> m_readback_buffer {};
+
+        U32 m_last_submitted_frame = 0;
+
+
+        // One pool per recording thread per frame, reset together once the frame has retired
+        U32 m_recording_thread_count = 0;
+        std::array<std::vector<Vulkan::CommandPool>, FRAMES_IN_FLIGHT> m_command_pools {};
+
+        Vulkan::CommandBuffer* m_frame_command_buffer = nullptr;
+        VkSubpassContents      m_frame_contents       = VK_SUBPASS_CONTENTS_INLINE;
+        bool                   m_frame_rendering      = false;
+        U64                    m_frame_upload_value   = 0; // Upload ticket the frame waits on, 0 for none
+
+        FrameArena m_frame_arena { FRAMES_IN_FLIGHT };
+
+        // RESOURCES
+
+        Pool<Vulkan::Buffer>  m_buffers;
+        Pool<Vulkan::Texture> m_textures;
+        Pool<Vulkan::Shader>  m_shaders;
+        Pool<Vulkan::Mesh>    m_meshes;
+
+        Unique<Vulkan::DeletionQueue> m_deletion_queue; // Tracks every valid queue, collected by begin_frame
+
+        struct MipRequest
+        {
+            TextureHandle texture;
+            U64           upload_batch = 0; // Uploader batch holding the copy of level 0
+        };
+
+        Unique<Vulkan::MipGenerator> m_mip_generator;
+        std::vector<MipRequest>      m_mip_requests; // Generated by begin_frame once their batch has been flushed
+
+        std::array<U64,         FRAMES_IN_FLIGHT> m_frame_ticket {}; // Graphics queue ticket of the last submission per frame
         std::array<VkSemaphore, FRAMES_IN_FLIGHT> m_image_available_semaphore {};
         std::array<VkSemaphore, FRAMES_IN_FLIGHT> m_render_finished_semaphore {};
 
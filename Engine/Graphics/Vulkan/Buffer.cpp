@@ -1,9 +1,10 @@
 #include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
 
 namespace Cr::Graphics::Vulkan
 {
 
-Buffer::Buffer(VmaAllocator allocator, VkBufferUsageFlags usage, U64 size)
+Buffer::Buffer(VmaAllocator allocator, VkBufferUsageFlags usage, U64 size, HostAccess access, Vulkan::DescriptorHeap* heap)
     : m_allocator(allocator)
 {
     VkBufferCreateInfo buffer_info
@@ -19,40 +20,71 @@ Buffer::Buffer(VmaAllocator allocator, VkBufferUsageFlags usage, U64 size)
         .usage = VMA_MEMORY_USAGE_AUTO,
     };
 
-    if (buffer_info.usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT))
+    switch (access)
     {
-        allocation_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |  VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        case HostAccess::None:
+            break;
+        case HostAccess::SequentialWrite:
+            allocation_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
+        case HostAccess::Random:
+            allocation_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
     }
 
-    VkResult result = vmaCreateBuffer(m_allocator, &buffer_info, &allocation_info, &m_handle, &m_allocation, nullptr);
+    VmaAllocationInfo allocation_result {};
+
+    VkResult result = vmaCreateBuffer(m_allocator, &buffer_info, &allocation_info, &m_handle, &m_allocation, &allocation_result);
     VK_ASSERT_THROW(result, "Failed to construct Vulkan buffer");
+
+    m_mapped = allocation_result.pMappedData;
+
+    if (heap && (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+    {
+        m_heap             = heap;
+        m_descriptor_index = m_heap->register_buffer(m_handle);
+    }
 }
 
 Buffer::Buffer(Buffer&& other) noexcept
-    : m_handle    (std::exchange(other.m_handle,     nullptr))
-    , m_allocation(std::exchange(other.m_allocation, nullptr))
-    , m_allocator (std::exchange(other.m_allocator,  nullptr))
+    : m_handle          (std::exchange(other.m_handle,           nullptr))
+    , m_allocation      (std::exchange(other.m_allocation,       nullptr))
+    , m_allocator       (std::exchange(other.m_allocator,        nullptr))
+    , m_mapped          (std::exchange(other.m_mapped,           nullptr))
+    , m_heap            (std::exchange(other.m_heap,             nullptr))
+    , m_descriptor_index(std::exchange(other.m_descriptor_index, DescriptorHeap::INVALID_INDEX))
 {}
 
 Buffer& Buffer::operator = (Buffer&& other) noexcept
 {
     if (this != &other)
     {
-        std::swap(m_handle,     other.m_handle);
-        std::swap(m_allocation, other.m_allocation);
-        std::swap(m_allocator,  other.m_allocator);
+        std::swap(m_handle,           other.m_handle);
+        std::swap(m_allocation,       other.m_allocation);
+        std::swap(m_allocator,        other.m_allocator);
+        std::swap(m_mapped,           other.m_mapped);
+        std::swap(m_heap,             other.m_heap);
+        std::swap(m_descriptor_index, other.m_descriptor_index);
     }
     return *this;
 }
 
 Buffer::~Buffer()
 {
+    if (m_heap)
+    {
+        m_heap->release_buffer(m_descriptor_index);
+        m_heap             = nullptr;
+        m_descriptor_index = DescriptorHeap::INVALID_INDEX;
+    }
+
     if (m_handle)
     {
         vmaDestroyBuffer(m_allocator, m_handle, m_allocation);
         m_allocator  = nullptr;
         m_handle     = nullptr;
         m_allocation = nullptr;
+        m_mapped     = nullptr;
     }
 }
 
@@ -62,4 +94,16 @@ void Buffer::set_data(const void* begin, U64 size, U64 offset)
     VK_ASSERT_THROW(result, "Failure to copy data into Vulkan buffer host memory: {}", to_string(result));
 }
 
+void Buffer::get_data(void* destination, U64 size, U64 offset) const
+{
+    VkResult result = vmaCopyAllocationToMemory(m_allocator, m_allocation, offset, destination, size);
+    VK_ASSERT_THROW(result, "Failure to copy data from Vulkan buffer host memory: {}", to_string(result));
+}
+
+void Buffer::flush(U64 offset, U64 size)
+{
+    VkResult result = vmaFlushAllocation(m_allocator, m_allocation, offset, size);
+    VK_ASSERT_THROW(result, "Failure to flush Vulkan buffer host memory: {}", to_string(result));
+}
+
 } // namespace Cr::Graphics::Vulkan
@@ -8,25 +8,49 @@
 namespace Cr::Graphics::Vulkan
 {
 
+class DescriptorHeap;
+
+// How the host touches the memory of a buffer, picks the memory type and whether the buffer stays mapped
+enum class HostAccess
+{
+    None,            // Device local, filled through the uploader or by the device
+    SequentialWrite, // Mapped, written front to back by the host and read by the device, possibly write combined
+    Random,          // Mapped and cached, read back by the host after device writes
+};
+
 class Buffer : public NoCopy
 {
     public:
         Buffer() = default;
-        Buffer(VmaAllocator allocator, VkBufferUsageFlags usage, U64 size);
+        // Storage buffers are registered in the heap when given one, the index stays valid for the lifetime of the buffer
+        Buffer(VmaAllocator allocator, VkBufferUsageFlags usage, U64 size, HostAccess access = HostAccess::None, Vulkan::DescriptorHeap* heap = nullptr);
         ~Buffer();
 
         Buffer(Buffer&& other) noexcept;
         Buffer& operator = (Buffer&& other) noexcept;
 
         void set_data(const void* data, U64 size, U64 offset);
+        void get_data(void* data, U64 size, U64 offset) const;
+
+        // Makes host writes through the mapping visible to the device, no-op on coherent memory
+        void flush(U64 offset, U64 size);
+
+        [[nodiscard]] constexpr void* get_mapped() const { return m_mapped; } // Null for HostAccess::None
 
         [[nodiscard]] constexpr const VkBuffer& get_native() const { return m_handle; }
 
+        [[nodiscard]] constexpr U32 get_descriptor_index() const { return m_descriptor_index; } // Into the heap buffer array
+
     private:
         VkBuffer m_handle {};
 
         VmaAllocation m_allocation {};
         VmaAllocator  m_allocator  {};
+
+        void* m_mapped {};
+
+        Vulkan::DescriptorHeap* m_heap {};
+        U32                     m_descriptor_index = ~0u;
 };
 
 } // namespace Cr::Graphics::Vulkan
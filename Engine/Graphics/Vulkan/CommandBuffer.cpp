@@ -1,6 +1,7 @@
 #include "Graphics/Vulkan/CommandBuffer.hpp"
 
 #include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
 #include "Graphics/Vulkan/Shader.hpp"
 #include "Graphics/Vulkan/Texture.hpp"
 
@@ -9,11 +10,11 @@
 namespace Cr::Graphics::Vulkan
 {
 
-CommandBuffer::CommandBuffer(VkDevice device, VkCommandPool pool) : m_handle(), m_source_pool(pool), m_device(device) {
+CommandBuffer::CommandBuffer(VkDevice device, VkCommandPool pool, VkCommandBufferLevel level) : m_handle(), m_source_pool(pool), m_device(device) {
     VkCommandBufferAllocateInfo info {
         .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .commandPool        = m_source_pool,
-        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .level              = level,
         .commandBufferCount = 1,
     };
     VK_ASSERT_THROW(vkAllocateCommandBuffers(m_device, &info, &m_handle), "Failed to allocate command buffer");
@@ -53,6 +54,16 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags usage)
     VK_ASSERT_THROW(vkBeginCommandBuffer(m_handle, &info), "Failed to allocate command buffer");
 }
 
+void CommandBuffer::begin(VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo& inheritance)
+{
+    VkCommandBufferBeginInfo info {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags            = usage,
+        .pInheritanceInfo = &inheritance,
+    };
+    VK_ASSERT_THROW(vkBeginCommandBuffer(m_handle, &info), "Failed to begin secondary command buffer");
+}
+
 void CommandBuffer::end()
 {
     VK_ASSERT_THROW(vkEndCommandBuffer(m_handle), "Failed to end command buffer");
@@ -73,6 +84,11 @@ void CommandBuffer::end_rendering()
     Extensions::cmd_end_rendering(m_handle);
 }
 
+void CommandBuffer::execute_commands(std::span<const VkCommandBuffer> secondaries)
+{
+    vkCmdExecuteCommands(m_handle, secondaries.size(), secondaries.data());
+}
+
 void CommandBuffer::pipeline_barrier(VkPipelineStageFlags             source,
                                      VkPipelineStageFlags             destination,
                                      VkDependencyFlags                dependencies,
@@ -98,6 +114,21 @@ void CommandBuffer::copy_buffer_to_texture(const Vulkan::Buffer& source, Vulkan:
     vkCmdCopyBufferToImage(m_handle, source.get_native(), destination.get_native(), layout, regions.size(), regions.data());
 }
 
+void CommandBuffer::copy_image_to_buffer(VkImage source, VkImageLayout layout, Vulkan::Buffer& destination, std::span<const VkBufferImageCopy> regions)
+{
+    vkCmdCopyImageToBuffer(m_handle, source, layout, destination.get_native(), regions.size(), regions.data());
+}
+
+void CommandBuffer::blit_image(VkImage source, VkImageLayout source_layout, VkImage destination, VkImageLayout destination_layout, std::span<const VkImageBlit> regions, VkFilter filter)
+{
+    vkCmdBlitImage(m_handle, source, source_layout, destination, destination_layout, regions.size(), regions.data(), filter);
+}
+
+void CommandBuffer::fill_buffer(Vulkan::Buffer& destination, U64 offset, U64 size, U32 value)
+{
+    vkCmdFillBuffer(m_handle, destination.get_native(), offset, size, value);
+}
+
 void CommandBuffer::bind_shader(const Vulkan::Shader& shader)
 {
     vkCmdBindPipeline(m_handle, shader.get_bind_point(), shader.get_native());
@@ -114,14 +145,27 @@ void CommandBuffer::bind_index_buffer(const Vulkan::Buffer& buffer, VkIndexType
     vkCmdBindIndexBuffer(m_handle, buffer.get_native(), 0, index_type);
 }
 
-void CommandBuffer::bind_descriptor_set(const Vulkan::Shader& shader, const VkDescriptorSet& descriptor_set)
+void CommandBuffer::bind_descriptor_set(const Vulkan::Shader& shader, U32 set, const VkDescriptorSet& descriptor_set)
+{
+    CR_ASSERT(set != DescriptorHeap::SET, "Set {} is reserved for the descriptor heap", set);
+
+    vkCmdBindDescriptorSets(m_handle, shader.get_bind_point(), shader.get_pipeline_layout(), set, 1, &descriptor_set, 0, nullptr);
+}
+
+void CommandBuffer::bind_descriptor_heap(const Vulkan::DescriptorHeap& heap, VkPipelineBindPoint bind_point)
 {
-    vkCmdBindDescriptorSets(m_handle, shader.get_bind_point(), shader.get_pipeline_layout(), 0, 1, &descriptor_set, 0, nullptr);
+    // Compatible with every shader layout, stays bound across bind_shader calls
+    vkCmdBindDescriptorSets(m_handle, bind_point, heap.get_pipeline_layout(), DescriptorHeap::SET, 1, &heap.get_native(), 0, nullptr);
 }
 
 void CommandBuffer::push_constants(const Vulkan::Shader& shader, const PushConstantObject& push_constants)
 {
-    vkCmdPushConstants(m_handle, shader.get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantObject), &push_constants);
+    this->push_constants(shader, &push_constants, sizeof(PushConstantObject));
+}
+
+void CommandBuffer::push_constants(const Vulkan::Shader& shader, const void* data, U32 size, U32 offset)
+{
+    vkCmdPushConstants(m_handle, shader.get_pipeline_layout(), shader.get_push_constant_stages(), offset, size, data);
 }
 
 void CommandBuffer::draw_indexed(U32 index_count, U32 instance_count, U32 first_index, I32 vertex_offset, U32 first_instance)
@@ -129,6 +173,18 @@ void CommandBuffer::draw_indexed(U32 index_count, U32 instance_count, U32 first_
     vkCmdDrawIndexed(m_handle, index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
+void CommandBuffer::draw_indexed_indirect_count(const Vulkan::Buffer& commands,     U64 offset,
+                                                const Vulkan::Buffer& count_buffer, U64 count_offset,
+                                                U32 max_draw_count, U32 stride)
+{
+    vkCmdDrawIndexedIndirectCount(m_handle, commands.get_native(), offset, count_buffer.get_native(), count_offset, max_draw_count, stride);
+}
+
+void CommandBuffer::dispatch(U32 group_count_x, U32 group_count_y, U32 group_count_z)
+{
+    vkCmdDispatch(m_handle, group_count_x, group_count_y, group_count_z);
+}
+
 void CommandBuffer::set_viewport(F32 x, F32 y, F32 width, F32 height)
 {
     VkViewport viewport {
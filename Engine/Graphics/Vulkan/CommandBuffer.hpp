@@ -9,6 +9,7 @@ namespace Cr::Graphics::Vulkan
 {
 
 class Buffer;
+class DescriptorHeap;
 class Shader;
 class Texture;
 
@@ -16,7 +17,7 @@ class CommandBuffer : public NoCopy
 {
     public:
         CommandBuffer() = default;
-        CommandBuffer(VkDevice device, VkCommandPool pool);
+        CommandBuffer(VkDevice device, VkCommandPool pool, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
         ~CommandBuffer();
 
         CommandBuffer(CommandBuffer&& other) noexcept;
@@ -25,12 +26,15 @@ class CommandBuffer : public NoCopy
         [[nodiscard]] constexpr VkCommandBuffer& get_native() { return m_handle; }
 
         void begin(VkCommandBufferUsageFlags usage);
+        void begin(VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo& inheritance);
         void reset(VkCommandBufferResetFlags flags);
         void end();
 
         void begin_rendering(VkRenderingInfo rendering_info);
         void end_rendering();
 
+        void execute_commands(std::span<const VkCommandBuffer> secondaries);
+
         void pipeline_barrier(VkPipelineStageFlags                   source,
                               VkPipelineStageFlags                   destination,
                               VkDependencyFlags                      dependencies,
@@ -40,16 +44,31 @@ class CommandBuffer : public NoCopy
 
         void copy_buffer(const Vulkan::Buffer& source, Vulkan::Buffer& destination, std::span<const VkBufferCopy> regions);
         void copy_buffer_to_texture(const Vulkan::Buffer& source, Vulkan::Texture& destination, VkImageLayout layout, std::span<const VkBufferImageCopy> regions);
+        void copy_image_to_buffer(VkImage source, VkImageLayout layout, Vulkan::Buffer& destination, std::span<const VkBufferImageCopy> regions);
+
+        // Graphics queues only, source and destination may be different levels of the same image
+        void blit_image(VkImage source, VkImageLayout source_layout, VkImage destination, VkImageLayout destination_layout, std::span<const VkImageBlit> regions, VkFilter filter);
+
+        void fill_buffer(Vulkan::Buffer& destination, U64 offset, U64 size, U32 value);
 
         void bind_shader(const Vulkan::Shader& shader);
         void bind_vertex_buffer(const Vulkan::Buffer& buffer);
         void bind_index_buffer(const Vulkan::Buffer& buffer, VkIndexType index_type);
-        void bind_descriptor_set(const Vulkan::Shader& shader, const VkDescriptorSet& descriptor_set);
+        void bind_descriptor_set(const Vulkan::Shader& shader, U32 set, const VkDescriptorSet& descriptor_set);
+        void bind_descriptor_heap(const Vulkan::DescriptorHeap& heap, VkPipelineBindPoint bind_point);
 
         void push_constants(const Vulkan::Shader& shader, const PushConstantObject& push_constants);
+        void push_constants(const Vulkan::Shader& shader, const void* data, U32 size, U32 offset = 0);
 
         void draw_indexed(U32 index_count, U32 instance_count, U32 first_index, I32 vertex_offset, U32 first_instance);
 
+        // Reads up to max_draw_count VkDrawIndexedIndirectCommand, the actual count is a U32 read from count_buffer
+        void draw_indexed_indirect_count(const Vulkan::Buffer& commands,     U64 offset,
+                                         const Vulkan::Buffer& count_buffer, U64 count_offset,
+                                         U32 max_draw_count, U32 stride = sizeof(VkDrawIndexedIndirectCommand));
+
+        void dispatch(U32 group_count_x, U32 group_count_y = 1, U32 group_count_z = 1);
+
         void set_viewport(F32 x, F32 y, F32 width, F32 height); 
         void set_scissor(I32 x, I32 y, I32 width, I32 height);
 
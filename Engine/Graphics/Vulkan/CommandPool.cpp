@@ -0,0 +1,87 @@
+#include "Graphics/Vulkan/CommandPool.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+CommandPool::CommandPool(VkDevice device, U32 family_index)
+    : m_device(device)
+{
+    VkCommandPoolCreateInfo pool_info {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = family_index,
+    };
+
+    VK_ASSERT_THROW(vkCreateCommandPool(m_device, &pool_info, nullptr, &m_handle), "Failed to create a Vulkan command pool");
+}
+
+CommandPool::~CommandPool()
+{
+    if (m_handle)
+    {
+        // Buffers free themselves back to the pool, so they have to go first
+        m_primary.clear();
+        m_secondary.clear();
+
+        vkDestroyCommandPool(m_device, m_handle, nullptr);
+        m_handle = {};
+        m_device = {};
+    }
+}
+
+CommandPool::CommandPool(CommandPool&& other) noexcept
+    : m_handle        (std::exchange(other.m_handle, nullptr))
+    , m_primary       (std::move(other.m_primary))
+    , m_secondary     (std::move(other.m_secondary))
+    , m_primary_used  (std::exchange(other.m_primary_used, 0))
+    , m_secondary_used(std::exchange(other.m_secondary_used, 0))
+    , m_device        (std::exchange(other.m_device, nullptr))
+{}
+
+CommandPool& CommandPool::operator = (CommandPool&& other) noexcept
+{
+    if (this != &other)
+    {
+        std::swap(m_handle,         other.m_handle);
+        std::swap(m_primary,        other.m_primary);
+        std::swap(m_secondary,      other.m_secondary);
+        std::swap(m_primary_used,   other.m_primary_used);
+        std::swap(m_secondary_used, other.m_secondary_used);
+        std::swap(m_device,         other.m_device);
+    }
+    return *this;
+}
+
+Vulkan::CommandBuffer& CommandPool::allocate(VkCommandBufferLevel level)
+{
+    const bool is_primary = (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    auto& buffers = is_primary ? m_primary      : m_secondary;
+    U32&  used    = is_primary ? m_primary_used : m_secondary_used;
+
+    if (used == buffers.size())
+    {
+        buffers.push_back(create_unique<Vulkan::CommandBuffer>(m_device, m_handle, level));
+    }
+
+    return *buffers[used++];
+}
+
+std::span<const Unique<Vulkan::CommandBuffer>> CommandPool::get_allocated(VkCommandBufferLevel level) const
+{
+    if (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+    {
+        return { m_primary.data(), m_primary_used };
+    }
+    return { m_secondary.data(), m_secondary_used };
+}
+
+void CommandPool::reset()
+{
+    VK_ASSERT_THROW(vkResetCommandPool(m_device, m_handle, 0), "Failed to reset command pool");
+
+    m_primary_used   = 0;
+    m_secondary_used = 0;
+}
+
+} // namespace Cr::Graphics::Vulkan
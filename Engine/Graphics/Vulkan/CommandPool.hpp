@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+#include "Graphics/Vulkan/CommandBuffer.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+// Command buffers are recycled in bulk by resetting the whole pool, not one by one.
+// Like the underlying VkCommandPool, a pool must only be used from one thread at a time.
+class CommandPool : public NoCopy
+{
+    public:
+        CommandPool() = default;
+        CommandPool(VkDevice device, U32 family_index);
+        ~CommandPool();
+
+        CommandPool(CommandPool&& other) noexcept;
+        CommandPool& operator = (CommandPool&& other) noexcept;
+
+        // Valid until the next reset, buffers from earlier cycles are reused before allocating new ones
+        [[nodiscard]] Vulkan::CommandBuffer& allocate(VkCommandBufferLevel level);
+
+        // Buffers handed out since the last reset
+        [[nodiscard]] std::span<const Unique<Vulkan::CommandBuffer>> get_allocated(VkCommandBufferLevel level) const;
+
+        void reset();
+
+        [[nodiscard]] constexpr VkCommandPool get_native() const { return m_handle; }
+
+    private:
+        VkCommandPool m_handle {};
+
+        std::vector<Unique<Vulkan::CommandBuffer>> m_primary;
+        std::vector<Unique<Vulkan::CommandBuffer>> m_secondary;
+
+        U32 m_primary_used   = 0;
+        U32 m_secondary_used = 0;
+
+        VkDevice m_device {};
+};
+
+} // namespace Cr::Graphics::Vulkan
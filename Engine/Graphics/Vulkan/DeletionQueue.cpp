@@ -0,0 +1,76 @@
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+#include "Graphics/Vulkan/Queue.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+DeletionQueue::DeletionQueue(std::span<Vulkan::Queue* const> queues)
+{
+    CR_ASSERT_THROW(queues.size() <= MAX_QUEUES, "Deletion queue tracks at most {} queues, got {}", MAX_QUEUES, queues.size());
+
+    for (Vulkan::Queue* queue : queues)
+    {
+        m_queues[m_queue_count++] = queue;
+    }
+}
+
+void DeletionQueue::close_frame()
+{
+    if (m_open_entries.empty()) { return; }
+
+    Tickets tickets {};
+
+    for (U32 i = 0; i < m_queue_count; ++i)
+    {
+        tickets[i] = m_queues[i]->get_last_submitted();
+    }
+
+    for (auto& resource : m_open_entries)
+    {
+        m_entries.push_back({ tickets, std::move(resource) });
+    }
+
+    m_open_entries.clear();
+}
+
+void DeletionQueue::collect()
+{
+    if (m_entries.empty()) { return; }
+
+    // One semaphore query per queue, not per resource
+    Tickets completed {};
+
+    for (U32 i = 0; i < m_queue_count; ++i)
+    {
+        completed[i] = m_queues[i]->poll();
+    }
+
+    std::erase_if(m_entries, [&](const Entry& entry)
+    {
+        for (U32 i = 0; i < m_queue_count; ++i)
+        {
+            if (entry.tickets[i] > completed[i]) { return false; }
+        }
+
+        return true;
+    });
+}
+
+void DeletionQueue::flush()
+{
+    m_entries.clear();
+    m_open_entries.clear();
+}
+
+U32 DeletionQueue::get_queue_slot(const Vulkan::Queue& queue) const
+{
+    U32 slot = 0;
+
+    while (slot < m_queue_count && m_queues[slot] != &queue) { ++slot; }
+
+    CR_ASSERT_THROW(slot < m_queue_count, "Queue of family {} is not tracked by the deletion queue", queue.get_family_index());
+
+    return slot;
+}
+
+} // namespace Cr::Graphics::Vulkan
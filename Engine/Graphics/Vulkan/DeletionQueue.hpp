@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+class Queue;
+
+// Owns released resources until the device is done with them. Every resource holds one ticket per tracked queue
+// and is destroyed by collect() once all of them have completed, so nothing ever waits for the device to go idle.
+//
+// Resources pushed without a ticket may still be used by work not yet submitted, they are stamped with the last
+// submission of every queue by the next close_frame().
+class DeletionQueue : public NoCopy, public NoMove
+{
+    public:
+        static constexpr U32 MAX_QUEUES = 3;
+
+        DeletionQueue() = delete;
+        explicit DeletionQueue(std::span<Vulkan::Queue* const> queues); // Must outlive the deletion queue
+        ~DeletionQueue() = default;
+
+        // Destroyed once the queue completes the ticket
+        template<typename T>
+        void push(const Vulkan::Queue& queue, U64 ticket, T&& resource);
+
+        // Destroyed once the submissions up to the next close_frame() complete
+        template<typename T>
+        void push(T&& resource);
+
+        // Call after submitting a frame
+        void close_frame();
+
+        // Destroys every resource whose tickets have completed, never blocks
+        void collect();
+
+        // Destroys everything right away, the device must be idle
+        void flush();
+
+        [[nodiscard]] U32 size() const { return static_cast<U32>(m_entries.size() + m_open_entries.size()); }
+
+    private:
+        struct Resource
+        {
+            virtual ~Resource() = default;
+        };
+
+        template<typename T>
+        struct Holder final : Resource
+        {
+            explicit Holder(T&& resource) : resource(std::move(resource)) {}
+
+            T resource;
+        };
+
+        using Tickets = std::array<U64, MAX_QUEUES>; // By tracked queue, 0 when the queue is not waited on
+
+        struct Entry
+        {
+            Tickets          tickets {};
+            Unique<Resource> resource;
+        };
+
+        [[nodiscard]] U32 get_queue_slot(const Vulkan::Queue& queue) const;
+
+        std::array<Vulkan::Queue*, MAX_QUEUES> m_queues {};
+        U32 m_queue_count = 0;
+
+        std::vector<Entry>            m_entries;
+        std::vector<Unique<Resource>> m_open_entries; // Waiting for close_frame()
+};
+
+template<typename T>
+void DeletionQueue::push(const Vulkan::Queue& queue, U64 ticket, T&& resource)
+{
+    static_assert(!std::is_lvalue_reference_v<T>, "Resources are moved into the deletion queue");
+
+    Entry& entry = m_entries.emplace_back();
+
+    entry.tickets[get_queue_slot(queue)] = ticket;
+    entry.resource = create_unique<Holder<T>>(std::move(resource));
+}
+
+template<typename T>
+void DeletionQueue::push(T&& resource)
+{
+    static_assert(!std::is_lvalue_reference_v<T>, "Resources are moved into the deletion queue");
+
+    m_open_entries.push_back(create_unique<Holder<T>>(std::move(resource)));
+}
+
+} // namespace Cr::Graphics::Vulkan
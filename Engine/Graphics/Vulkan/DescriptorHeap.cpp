@@ -0,0 +1,267 @@
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
+#include "Graphics/Vulkan/LayoutCache.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+// Upper bounds, lowered to what the device supports for update after bind descriptors
+static constexpr U32 MAX_TEXTURES = 1u << 16;
+static constexpr U32 MAX_BUFFERS  = 1u << 14;
+static constexpr U32 MAX_IMAGES   = 1u << 12; // Transient views for compute writes, e.g. mip generation
+
+DescriptorHeap::DescriptorHeap(VkDevice device, VkPhysicalDevice physical_device, Vulkan::LayoutCache& layouts)
+    : m_device(device)
+{
+    // Capacities
+
+    VkPhysicalDeviceVulkan12Properties vulkan12_properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES,
+    };
+
+    VkPhysicalDeviceProperties2 properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &vulkan12_properties,
+    };
+
+    vkGetPhysicalDeviceProperties2(physical_device, &properties);
+
+    // Combined image samplers count against both the sampler and the sampled image limits
+    m_textures.capacity = std::min({
+        MAX_TEXTURES,
+        vulkan12_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+        vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        vulkan12_properties.maxDescriptorSetUpdateAfterBindSamplers,
+        vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+    });
+
+    m_buffers.capacity = std::min({
+        MAX_BUFFERS,
+        vulkan12_properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+        vulkan12_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+    });
+
+    m_images.capacity = std::min({
+        MAX_IMAGES,
+        vulkan12_properties.maxDescriptorSetUpdateAfterBindStorageImages,
+        vulkan12_properties.maxPerStageDescriptorUpdateAfterBindStorageImages,
+    });
+
+    // Every array is visible to every stage, their sum has to fit the per stage resource limit
+    const U32 stage_resources = vulkan12_properties.maxPerStageUpdateAfterBindResources;
+    if (m_textures.capacity + m_buffers.capacity + m_images.capacity > stage_resources)
+    {
+        m_images.capacity   = std::min(m_images.capacity, stage_resources / 16);
+        m_buffers.capacity  = std::min(m_buffers.capacity, stage_resources / 4);
+        m_textures.capacity = std::min(m_textures.capacity, stage_resources - m_buffers.capacity - m_images.capacity);
+    }
+
+    CR_ASSERT_THROW(m_textures.capacity > 0 && m_buffers.capacity > 0 && m_images.capacity > 0, "Device does not support update after bind descriptors");
+
+    // Layouts
+
+    const std::array bindings {
+        VkDescriptorSetLayoutBinding {
+            .binding         = TEXTURE_BINDING,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = m_textures.capacity,
+            .stageFlags      = VK_SHADER_STAGE_ALL,
+        },
+        VkDescriptorSetLayoutBinding {
+            .binding         = BUFFER_BINDING,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = m_buffers.capacity,
+            .stageFlags      = VK_SHADER_STAGE_ALL,
+        },
+        VkDescriptorSetLayoutBinding {
+            .binding         = IMAGE_BINDING,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = m_images.capacity,
+            .stageFlags      = VK_SHADER_STAGE_ALL,
+        },
+    };
+
+    // Unregistered slots are never written, registration may happen while the set is in use
+    const VkDescriptorBindingFlags binding_flag = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                  VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                  VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+    const std::array binding_flags { binding_flag, binding_flag, binding_flag };
+
+    m_set_layout = layouts.get_descriptor_set_layout(bindings, binding_flags, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT);
+
+    const VkPushConstantRange push_constant_range = get_push_constant_range();
+
+    m_pipeline_layout = layouts.get_pipeline_layout({&m_set_layout, 1}, {&push_constant_range, 1});
+
+    // Set
+
+    const std::array pool_sizes {
+        VkDescriptorPoolSize {
+            .type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = m_textures.capacity,
+        },
+        VkDescriptorPoolSize {
+            .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = m_buffers.capacity,
+        },
+        VkDescriptorPoolSize {
+            .type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = m_images.capacity,
+        },
+    };
+
+    const VkDescriptorPoolCreateInfo pool_info {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets       = 1,
+        .poolSizeCount = static_cast<U32>(pool_sizes.size()),
+        .pPoolSizes    = pool_sizes.data(),
+    };
+
+    VkResult result = vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_pool);
+    VK_ASSERT_THROW(result, "Failed to create bindless descriptor pool: {}", to_string(result));
+
+    const VkDescriptorSetAllocateInfo set_info {
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool     = m_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts        = &m_set_layout,
+    };
+
+    result = vkAllocateDescriptorSets(m_device, &set_info, &m_set);
+    VK_ASSERT_THROW(result, "Failed to allocate bindless descriptor set: {}", to_string(result));
+
+    CR_INFO("Bindless descriptor heap: {} textures, {} storage buffers, {} storage images", m_textures.capacity, m_buffers.capacity, m_images.capacity);
+}
+
+DescriptorHeap::~DescriptorHeap()
+{
+    if (m_pool)
+    {
+        vkDestroyDescriptorPool(m_device, m_pool, nullptr); // Frees the set
+        m_pool = {};
+        m_set  = {};
+    }
+}
+
+U32 DescriptorHeap::allocate(Slots& slots, const char* name)
+{
+    if (!slots.free.empty())
+    {
+        const U32 index = slots.free.back();
+        slots.free.pop_back();
+        return index;
+    }
+
+    CR_ASSERT_THROW(slots.next < slots.capacity, "Bindless descriptor heap is out of {} slots ({})", name, slots.capacity);
+
+    return slots.next++;
+}
+
+U32 DescriptorHeap::register_texture(VkImageView view, VkSampler sampler, VkImageLayout layout)
+{
+    const VkDescriptorImageInfo image_info {
+        .sampler     = sampler,
+        .imageView   = view,
+        .imageLayout = layout,
+    };
+
+    std::lock_guard lock(m_mutex);
+
+    const U32 index = allocate(m_textures, "texture");
+
+    const VkWriteDescriptorSet write {
+        .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet          = m_set,
+        .dstBinding      = TEXTURE_BINDING,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .pImageInfo      = &image_info,
+    };
+
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+
+    return index;
+}
+
+U32 DescriptorHeap::register_buffer(VkBuffer buffer, U64 offset, U64 range)
+{
+    const VkDescriptorBufferInfo buffer_info {
+        .buffer = buffer,
+        .offset = offset,
+        .range  = range,
+    };
+
+    std::lock_guard lock(m_mutex);
+
+    const U32 index = allocate(m_buffers, "storage buffer");
+
+    const VkWriteDescriptorSet write {
+        .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet          = m_set,
+        .dstBinding      = BUFFER_BINDING,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pBufferInfo     = &buffer_info,
+    };
+
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+
+    return index;
+}
+
+U32 DescriptorHeap::register_image(VkImageView view)
+{
+    const VkDescriptorImageInfo image_info {
+        .sampler     = VK_NULL_HANDLE,
+        .imageView   = view,
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+    };
+
+    std::lock_guard lock(m_mutex);
+
+    const U32 index = allocate(m_images, "storage image");
+
+    const VkWriteDescriptorSet write {
+        .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet          = m_set,
+        .dstBinding      = IMAGE_BINDING,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .pImageInfo      = &image_info,
+    };
+
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+
+    return index;
+}
+
+void DescriptorHeap::release_texture(U32 index)
+{
+    // The stale descriptor stays in place, partially bound arrays only require used slots to be valid
+    std::lock_guard lock(m_mutex);
+
+    CR_ASSERT(index < m_textures.next, "Releasing unregistered texture index {}", index);
+    m_textures.free.push_back(index);
+}
+
+void DescriptorHeap::release_buffer(U32 index)
+{
+    std::lock_guard lock(m_mutex);
+
+    CR_ASSERT(index < m_buffers.next, "Releasing unregistered storage buffer index {}", index);
+    m_buffers.free.push_back(index);
+}
+
+void DescriptorHeap::release_image(U32 index)
+{
+    std::lock_guard lock(m_mutex);
+
+    CR_ASSERT(index < m_images.next, "Releasing unregistered storage image index {}", index);
+    m_images.free.push_back(index);
+}
+
+} // namespace Cr::Graphics::Vulkan
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+#include <mutex>
+
+namespace Cr::Graphics::Vulkan
+{
+
+class LayoutCache;
+
+// Global bindless descriptor set, one partially bound array per resource type. Resources get a stable index into
+// their array when registered and shaders index the arrays directly, so the set is bound once per command buffer
+// instead of per draw. Every pipeline layout starts with this set and shares the same push constant range, which
+// keeps the binding valid across shader changes. Thread safe.
+class DescriptorHeap : public NoCopy, public NoMove
+{
+    public:
+        static constexpr U32 SET             = 0; // Reserved in every pipeline layout
+        static constexpr U32 TEXTURE_BINDING = 0; // sampler2D textures[]
+        static constexpr U32 BUFFER_BINDING  = 1; // buffer Block {...} buffers[]
+        static constexpr U32 IMAGE_BINDING   = 2; // image2DArray images[], in VK_IMAGE_LAYOUT_GENERAL
+
+        static constexpr U32 PUSH_CONSTANT_SIZE = 128; // Guaranteed minimum, visible to every stage
+
+        static constexpr U32 INVALID_INDEX = ~0u;
+
+        DescriptorHeap() = delete;
+        DescriptorHeap(VkDevice device, VkPhysicalDevice physical_device, Vulkan::LayoutCache& layouts);
+        ~DescriptorHeap();
+
+        // The resource must stay alive until its index is released. Released indices are recycled, the caller must
+        // make sure the GPU is done with the resource first.
+        [[nodiscard]] U32 register_texture(VkImageView view, VkSampler sampler, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        [[nodiscard]] U32 register_buffer(VkBuffer buffer, U64 offset = 0, U64 range = VK_WHOLE_SIZE);
+        [[nodiscard]] U32 register_image(VkImageView view); // Storage image
+
+        void release_texture(U32 index);
+        void release_buffer(U32 index);
+        void release_image(U32 index);
+
+        [[nodiscard]] constexpr const VkDescriptorSet&       get_native()          const { return m_set;             }
+        [[nodiscard]] constexpr const VkDescriptorSetLayout& get_set_layout()      const { return m_set_layout;      }
+        [[nodiscard]] constexpr const VkPipelineLayout&      get_pipeline_layout() const { return m_pipeline_layout; } // Heap set only
+
+        [[nodiscard]] constexpr VkPushConstantRange get_push_constant_range() const { return {VK_SHADER_STAGE_ALL, 0, PUSH_CONSTANT_SIZE}; }
+
+        [[nodiscard]] constexpr U32 get_texture_capacity() const { return m_textures.capacity; }
+        [[nodiscard]] constexpr U32 get_buffer_capacity()  const { return m_buffers.capacity;  }
+        [[nodiscard]] constexpr U32 get_image_capacity()   const { return m_images.capacity;   }
+
+    private:
+        struct Slots
+        {
+            std::vector<U32> free;
+            U32 next     = 0;
+            U32 capacity = 0;
+        };
+
+        [[nodiscard]] static U32 allocate(Slots& slots, const char* name);
+
+        VkDescriptorPool      m_pool            {};
+        VkDescriptorSet       m_set             {};
+        VkDescriptorSetLayout m_set_layout      {}; // Owned by the layout cache
+        VkPipelineLayout      m_pipeline_layout {}; // Owned by the layout cache
+
+        std::mutex m_mutex; // Guards the slots and descriptor writes
+
+        Slots m_textures;
+        Slots m_buffers;
+        Slots m_images;
+
+        VkDevice m_device {};
+};
+
+} // namespace Cr::Graphics::Vulkan
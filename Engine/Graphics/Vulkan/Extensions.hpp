@@ -4,12 +4,17 @@
 
 namespace Cr::Graphics::Vulkan::Extensions
 {    
-    constexpr std::array DEVICE_EXTENSION_LIST
+    inline constexpr std::array DEVICE_EXTENSION_LIST
     {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
     };
 
+    // Only required when presenting to a surface, headless devices can do without
+    inline constexpr std::array PRESENTATION_EXTENSION_LIST
+    {
+        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+    };
+
     VkResult bind_instance_extension_functions(VkInstance instance);
     VkResult bind_device_extension_functions(VkDevice device);
 
@@ -0,0 +1,115 @@
+#include "Graphics/Vulkan/IndirectBatch.hpp"
+#include "Graphics/Vulkan/CommandBuffer.hpp"
+#include "Graphics/Vulkan/Shader.hpp"
+#include "Graphics/Vulkan/Uploader.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+// Mirrors the push constant block of cull.comp
+struct CullConstants
+{
+    std::array<Vec4f, 6> frustum_planes;
+
+    U32 instance_buffer_index;
+    U32 mesh_buffer_index;
+    U32 command_buffer_index;
+    U32 count_buffer_index;
+    U32 instance_count;
+};
+
+static_assert(sizeof(CullConstants) <= 128);
+
+IndirectBatch::IndirectBatch(VmaAllocator allocator, Vulkan::DescriptorHeap& heap, U32 max_instances, U32 max_meshes)
+    : m_instances(allocator, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, U64(max_instances) * sizeof(GPUInstance), HostAccess::None, &heap)
+    , m_meshes   (allocator, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, U64(max_meshes)    * sizeof(GPUMesh),     HostAccess::None, &heap)
+    , m_commands (allocator, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, U64(max_instances) * sizeof(VkDrawIndexedIndirectCommand), HostAccess::None, &heap)
+    , m_count    (allocator, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, sizeof(U32), HostAccess::None, &heap)
+    , m_max_instances(max_instances)
+    , m_max_meshes(max_meshes)
+{
+}
+
+void IndirectBatch::set_meshes(Vulkan::Uploader& uploader, std::span<const GPUMesh> meshes)
+{
+    CR_ASSERT_THROW(meshes.size() <= m_max_meshes, "Indirect batch holds at most {} meshes", m_max_meshes);
+
+    uploader.copy_to_buffer(meshes.data(), meshes.size_bytes(), m_meshes, 0);
+}
+
+void IndirectBatch::set_instances(Vulkan::Uploader& uploader, std::span<const GPUInstance> instances)
+{
+    CR_ASSERT_THROW(instances.size() <= m_max_instances, "Indirect batch holds at most {} instances", m_max_instances);
+
+    uploader.copy_to_buffer(instances.data(), instances.size_bytes(), m_instances, 0);
+
+    m_instance_count = static_cast<U32>(instances.size());
+}
+
+void IndirectBatch::cull(Vulkan::CommandBuffer& cmd, const Vulkan::Shader& cull_shader, const Mat4f& projected_view)
+{
+    CR_ASSERT(cull_shader.get_bind_point() == VK_PIPELINE_BIND_POINT_COMPUTE, "Culling runs on a compute shader");
+
+    // Previous frames may still be reading the commands, only an execution dependency is needed before rewriting them
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, {}, {}, {});
+
+    cmd.fill_buffer(m_count, 0, sizeof(U32), 0);
+
+    const VkBufferMemoryBarrier count_reset {
+        .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer              = m_count.get_native(),
+        .offset              = 0,
+        .size                = VK_WHOLE_SIZE,
+    };
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, {}, {&count_reset, 1}, {});
+
+    const CullConstants constants {
+        .frustum_planes        = get_frustum_planes(projected_view),
+        .instance_buffer_index = m_instances.get_descriptor_index(),
+        .mesh_buffer_index     = m_meshes.get_descriptor_index(),
+        .command_buffer_index  = m_commands.get_descriptor_index(),
+        .count_buffer_index    = m_count.get_descriptor_index(),
+        .instance_count        = m_instance_count,
+    };
+
+    cmd.bind_shader(cull_shader);
+    cmd.push_constants(cull_shader, &constants, sizeof(constants));
+    cmd.dispatch((m_instance_count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE);
+
+    const std::array culled {
+        VkBufferMemoryBarrier {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = m_commands.get_native(),
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        },
+        VkBufferMemoryBarrier {
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer              = m_count.get_native(),
+            .offset              = 0,
+            .size                = VK_WHOLE_SIZE,
+        },
+    };
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, {}, culled, {});
+}
+
+void IndirectBatch::draw(Vulkan::CommandBuffer& cmd)
+{
+    cmd.draw_indexed_indirect_count(m_commands, 0, m_count, 0, m_instance_count);
+}
+
+} // namespace Cr::Graphics::Vulkan
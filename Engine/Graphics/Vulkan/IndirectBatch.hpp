@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+#include "Graphics/Vulkan/Buffer.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+#include "Crunch/Math.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+class CommandBuffer;
+class DescriptorHeap;
+class Shader;
+class Uploader;
+
+// GPU driven draws of instances over meshes sharing one vertex and index buffer. A compute pass culls every
+// instance against the view frustum and appends a VkDrawIndexedIndirectCommand per visible instance, drawn
+// afterwards by a single indirect count call. Each command starts at its instance index, vertex shaders read
+// their instance through gl_InstanceIndex from get_instance_buffer().
+//
+// Buffers are shared between frames in flight, the cull pass waits for the previous indirect draws to finish.
+class IndirectBatch : public NoCopy, public NoMove
+{
+    public:
+        static constexpr U32 CULL_GROUP_SIZE = 64; // local_size_x of cull.comp
+
+        IndirectBatch() = delete;
+        IndirectBatch(VmaAllocator allocator, Vulkan::DescriptorHeap& heap, U32 max_instances, U32 max_meshes);
+        ~IndirectBatch() = default;
+
+        // Replace the contents through the uploader, the copies are usable from the next frame on. Frames drawing
+        // the previous contents must have retired, the uploader does not wait for the graphics queue.
+        void set_meshes   (Vulkan::Uploader& uploader, std::span<const GPUMesh>     meshes);
+        void set_instances(Vulkan::Uploader& uploader, std::span<const GPUInstance> instances);
+
+        // Outside of rendering, cull_shader is the compute pipeline of cull.comp
+        void cull(Vulkan::CommandBuffer& cmd, const Vulkan::Shader& cull_shader, const Mat4f& projected_view);
+
+        // Inside rendering, with the drawing shader and the shared vertex and index buffers bound
+        void draw(Vulkan::CommandBuffer& cmd);
+
+        [[nodiscard]] constexpr const Vulkan::Buffer& get_instance_buffer() const { return m_instances; }
+
+        [[nodiscard]] constexpr U32 get_instance_count() const { return m_instance_count; }
+
+    private:
+        Vulkan::Buffer m_instances;
+        Vulkan::Buffer m_meshes;
+        Vulkan::Buffer m_commands;
+        Vulkan::Buffer m_count;
+
+        U32 m_instance_count = 0;
+        U32 m_max_instances  = 0;
+        U32 m_max_meshes     = 0;
+};
+
+} // namespace Cr::Graphics::Vulkan
@@ -0,0 +1,57 @@
+#include "Graphics/Vulkan/InstanceStream.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+InstanceStream::InstanceStream(VmaAllocator allocator, Vulkan::DescriptorHeap& heap, U32 frame_count, U32 capacity)
+    : m_capacity(capacity)
+{
+    m_buffers.reserve(frame_count);
+
+    for (U32 frame = 0; frame < frame_count; ++frame)
+    {
+        m_buffers.emplace_back(allocator, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, U64(capacity) * sizeof(GPUTransform), HostAccess::SequentialWrite, &heap);
+
+        CR_ASSERT_THROW(m_buffers.back().get_mapped() != nullptr, "Instance stream buffers must be host visible");
+    }
+}
+
+void InstanceStream::begin(U32 frame_index)
+{
+    CR_ASSERT(frame_index < m_buffers.size(), "Frame index {} out of range", frame_index);
+
+    m_frame_index = frame_index;
+    m_count       = 0;
+}
+
+U32 InstanceStream::write(std::span<const Mat4f> transforms)
+{
+    CR_ASSERT_THROW(m_count + transforms.size() <= m_capacity, "Instance stream holds at most {} transforms per frame", m_capacity);
+
+    auto* destination = static_cast<GPUTransform*>(m_buffers[m_frame_index].get_mapped()) + m_count;
+
+    // Column major to rows, sequential writes only as the memory may be write combined
+    for (const auto& transform : transforms)
+    {
+        *destination++ = GPUTransform {{
+            glm::row(transform, 0),
+            glm::row(transform, 1),
+            glm::row(transform, 2),
+        }};
+    }
+
+    const U32 first = m_count;
+    m_count += static_cast<U32>(transforms.size());
+
+    return first;
+}
+
+void InstanceStream::end()
+{
+    if (m_count > 0)
+    {
+        m_buffers[m_frame_index].flush(0, U64(m_count) * sizeof(GPUTransform));
+    }
+}
+
+} // namespace Cr::Graphics::Vulkan
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+#include "Graphics/Vulkan/Buffer.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+#include "Crunch/Math.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+class DescriptorHeap;
+
+// Per frame transforms for instanced draws. Every frame in flight owns a persistently mapped storage buffer that
+// is refilled from scratch each frame, so writing never waits on the GPU. Transforms are stored as GPUTransform,
+// vertex shaders read them with gl_InstanceIndex from the buffer of the frame.
+class InstanceStream : public NoCopy, public NoMove
+{
+    public:
+        InstanceStream() = delete;
+        InstanceStream(VmaAllocator allocator, Vulkan::DescriptorHeap& heap, U32 frame_count, U32 capacity);
+        ~InstanceStream() = default;
+
+        // Starts writing the buffer of the frame, its previous contents must have retired
+        void begin(U32 frame_index);
+
+        // Appends the transforms and returns the first one's index, the first_instance of the draw using them
+        [[nodiscard]] U32 write(std::span<const Mat4f> transforms);
+
+        // Makes the writes of the frame visible to the device
+        void end();
+
+        [[nodiscard]] U32 get_descriptor_index() const { return m_buffers[m_frame_index].get_descriptor_index(); }
+
+        [[nodiscard]] constexpr U32 get_capacity() const { return m_capacity; }
+
+    private:
+        std::vector<Vulkan::Buffer> m_buffers; // One per frame in flight
+
+        U32 m_frame_index = 0;
+        U32 m_count       = 0;
+        U32 m_capacity    = 0;
+};
+
+} // namespace Cr::Graphics::Vulkan
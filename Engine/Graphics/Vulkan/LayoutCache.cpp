@@ -0,0 +1,169 @@
+#include "Graphics/Vulkan/LayoutCache.hpp"
+
+#include "Crunch/Hash.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+bool LayoutCache::PipelineLayoutKey::operator == (const PipelineLayoutKey& other) const
+{
+    return set_layouts == other.set_layouts &&
+           std::ranges::equal(push_constants, other.push_constants, [](const VkPushConstantRange& a, const VkPushConstantRange& b) {
+               return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+           });
+}
+
+std::size_t LayoutCache::KeyHash::operator () (const DescriptorSetLayoutKey& key) const
+{
+    U64 hash = hash_value(key.flags);
+
+    for (const auto& binding : key.bindings)
+    {
+        hash = hash_combine(hash, hash_value(binding.binding));
+        hash = hash_combine(hash, hash_value(binding.type));
+        hash = hash_combine(hash, hash_value(binding.count));
+        hash = hash_combine(hash, hash_value(binding.stages));
+    }
+
+    for (const auto sampler : key.immutable_samplers)
+    {
+        hash = hash_combine(hash, hash_value(sampler));
+    }
+
+    for (const auto binding_flag : key.binding_flags)
+    {
+        hash = hash_combine(hash, hash_value(binding_flag));
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
+std::size_t LayoutCache::KeyHash::operator () (const PipelineLayoutKey& key) const
+{
+    U64 hash = HASH_SEED;
+
+    for (const auto set_layout : key.set_layouts)
+    {
+        hash = hash_combine(hash, hash_value(set_layout));
+    }
+
+    for (const auto& range : key.push_constants)
+    {
+        hash = hash_combine(hash, hash_value(range)); // No padding
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
+LayoutCache::LayoutCache(VkDevice device)
+    : m_device(device)
+{
+}
+
+LayoutCache::~LayoutCache()
+{
+    for (const auto& [key, layout] : m_pipeline_layouts)
+    {
+        vkDestroyPipelineLayout(m_device, layout, nullptr);
+    }
+
+    for (const auto& [key, layout] : m_descriptor_set_layouts)
+    {
+        vkDestroyDescriptorSetLayout(m_device, layout, nullptr);
+    }
+}
+
+VkDescriptorSetLayout LayoutCache::get_descriptor_set_layout(std::span<const VkDescriptorSetLayoutBinding> bindings,
+                                                             std::span<const VkDescriptorBindingFlags>     binding_flags,
+                                                             VkDescriptorSetLayoutCreateFlags              flags)
+{
+    CR_ASSERT(binding_flags.empty() || binding_flags.size() == bindings.size(), "Descriptor binding flags must match the bindings");
+
+    DescriptorSetLayoutKey key {
+        .flags         = flags,
+        .binding_flags = { binding_flags.begin(), binding_flags.end() },
+    };
+
+    key.bindings.reserve(bindings.size());
+
+    for (const auto& binding : bindings)
+    {
+        key.bindings.push_back({
+            .binding            = binding.binding,
+            .type               = binding.descriptorType,
+            .count              = binding.descriptorCount,
+            .stages             = binding.stageFlags,
+            .immutable_samplers = binding.pImmutableSamplers != nullptr,
+        });
+
+        // Immutable samplers come from the sampler cache, their handles identify their contents
+        if (binding.pImmutableSamplers != nullptr)
+        {
+            key.immutable_samplers.insert(key.immutable_samplers.end(), binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+        }
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    if (const auto it = m_descriptor_set_layouts.find(key); it != m_descriptor_set_layouts.end())
+    {
+        return it->second;
+    }
+
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info {
+        .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount  = static_cast<U32>(binding_flags.size()),
+        .pBindingFlags = binding_flags.data(),
+    };
+
+    const VkDescriptorSetLayoutCreateInfo layout_info {
+        .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext        = binding_flags.empty() ? nullptr : &binding_flags_info,
+        .flags        = flags,
+        .bindingCount = static_cast<U32>(bindings.size()),
+        .pBindings    = bindings.data(),
+    };
+
+    VkDescriptorSetLayout layout;
+
+    const VkResult result = vkCreateDescriptorSetLayout(m_device, &layout_info, nullptr, &layout);
+    VK_ASSERT_THROW(result, "Failed to create Vulkan Descriptor Set Layout: {}", to_string(result));
+
+    m_descriptor_set_layouts.emplace(std::move(key), layout);
+
+    return layout;
+}
+
+VkPipelineLayout LayoutCache::get_pipeline_layout(std::span<const VkDescriptorSetLayout> set_layouts, std::span<const VkPushConstantRange> push_constants)
+{
+    PipelineLayoutKey key {
+        .set_layouts    = { set_layouts.begin(),    set_layouts.end()    },
+        .push_constants = { push_constants.begin(), push_constants.end() },
+    };
+
+    std::lock_guard lock(m_mutex);
+
+    if (const auto it = m_pipeline_layouts.find(key); it != m_pipeline_layouts.end())
+    {
+        return it->second;
+    }
+
+    const VkPipelineLayoutCreateInfo layout_info {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = static_cast<U32>(set_layouts.size()),
+        .pSetLayouts            = set_layouts.data(),
+        .pushConstantRangeCount = static_cast<U32>(push_constants.size()),
+        .pPushConstantRanges    = push_constants.data(),
+    };
+
+    VkPipelineLayout layout;
+
+    const VkResult result = vkCreatePipelineLayout(m_device, &layout_info, nullptr, &layout);
+    VK_ASSERT_THROW(result, "Failed to create Vulkan Pipeline Layout: {}", to_string(result));
+
+    m_pipeline_layouts.emplace(std::move(key), layout);
+
+    return layout;
+}
+
+} // namespace Cr::Graphics::Vulkan
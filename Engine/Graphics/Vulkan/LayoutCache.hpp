@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace Cr::Graphics::Vulkan
+{
+
+// Descriptor set and pipeline layouts keyed on their contents, identical layouts are created once
+// and shared by every shader using them. Thread safe, layouts live as long as the cache.
+class LayoutCache : public NoCopy, public NoMove
+{
+    public:
+        LayoutCache() = delete;
+        explicit LayoutCache(VkDevice device);
+        ~LayoutCache();
+
+        // Bindings must be sorted by binding number, binding flags are either empty or one per binding. Immutable
+        // samplers have to come from the SamplerCache, which outlives the layouts.
+        [[nodiscard]] VkDescriptorSetLayout get_descriptor_set_layout(std::span<const VkDescriptorSetLayoutBinding> bindings,
+                                                                      std::span<const VkDescriptorBindingFlags>     binding_flags = {},
+                                                                      VkDescriptorSetLayoutCreateFlags              flags         = 0);
+
+        [[nodiscard]] VkPipelineLayout get_pipeline_layout(std::span<const VkDescriptorSetLayout> set_layouts, std::span<const VkPushConstantRange> push_constants);
+
+    private:
+        struct Binding
+        {
+            U32                binding = 0;
+            VkDescriptorType   type    = VK_DESCRIPTOR_TYPE_SAMPLER;
+            U32                count   = 0;
+            VkShaderStageFlags stages  = 0;
+            bool               immutable_samplers = false;
+
+            [[nodiscard]] bool operator == (const Binding& other) const = default;
+        };
+
+        struct DescriptorSetLayoutKey
+        {
+            VkDescriptorSetLayoutCreateFlags      flags = 0;
+            std::vector<Binding>                  bindings;
+            std::vector<VkSampler>                immutable_samplers; // Of every binding that has them, in order
+            std::vector<VkDescriptorBindingFlags> binding_flags;
+
+            [[nodiscard]] bool operator == (const DescriptorSetLayoutKey& other) const = default;
+        };
+
+        struct PipelineLayoutKey
+        {
+            std::vector<VkDescriptorSetLayout> set_layouts; // From this cache, handles identify their contents
+            std::vector<VkPushConstantRange>   push_constants;
+
+            [[nodiscard]] bool operator == (const PipelineLayoutKey& other) const;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] std::size_t operator () (const DescriptorSetLayoutKey& key) const;
+            [[nodiscard]] std::size_t operator () (const PipelineLayoutKey&      key) const;
+        };
+
+        std::mutex m_mutex;
+
+        std::unordered_map<DescriptorSetLayoutKey, VkDescriptorSetLayout, KeyHash> m_descriptor_set_layouts;
+        std::unordered_map<PipelineLayoutKey,      VkPipelineLayout,      KeyHash> m_pipeline_layouts;
+
+        VkDevice m_device {};
+};
+
+} // namespace Cr::Graphics::Vulkan
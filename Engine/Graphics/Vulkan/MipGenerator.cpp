@@ -0,0 +1,430 @@
+#include "Graphics/Vulkan/MipGenerator.hpp"
+#include "Graphics/Vulkan/CommandBuffer.hpp"
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
+#include "Graphics/Vulkan/Shader.hpp"
+#include "Graphics/Vulkan/Texture.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+namespace
+{
+
+// Mirrors the push constant block of downsample.comp
+struct DownsampleConstants
+{
+    std::array<U32, MipGenerator::MAX_LEVELS_PER_DISPATCH + 1> image_indices; // Source level first
+
+    U32 level_count;
+    U32 counter_buffer_index;
+    U32 counter_offset;
+    U32 group_count;
+};
+
+static_assert(sizeof(DownsampleConstants) <= DescriptorHeap::PUSH_CONSTANT_SIZE);
+
+constexpr VkFormatFeatureFlags BLIT_FEATURES = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+// Heap slots are only recycled once a batch has retired, textures past the budget are blitted instead
+constexpr U32 MAX_BATCH_VIEWS = 1024;
+
+// Storage views of every level of a batch, destroyed once its submission has completed
+struct LevelViews : public NoCopy, public NoMove
+{
+    LevelViews(VkDevice device, Vulkan::DescriptorHeap& heap) : device(device), heap(heap) {}
+
+    ~LevelViews()
+    {
+        for (const U32 index : indices)
+        {
+            heap.release_image(index);
+        }
+
+        for (const VkImageView view : views)
+        {
+            vkDestroyImageView(device, view, nullptr);
+        }
+    }
+
+    VkDevice                device;
+    Vulkan::DescriptorHeap& heap;
+
+    std::vector<VkImageView> views;
+    std::vector<U32>         indices; // Into the heap image array
+};
+
+constexpr U32 get_level_size(U32 size, U32 level) { return std::max(size >> level, 1u); }
+
+// Levels one dispatch writes from source. The second reduction covers a single tile of level 6, sources above
+// 4096 texels only get the first.
+U32 get_dispatch_level_count(const Vulkan::Texture& texture, U32 source)
+{
+    const U32 remaining = texture.get_mip_levels() - 1 - source;
+    const U32 size      = std::max(get_level_size(texture.get_extent().width, source), get_level_size(texture.get_extent().height, source));
+
+    constexpr U32 MAX_SINGLE_TILE_SIZE = MipGenerator::TILE_SIZE * MipGenerator::TILE_SIZE;
+
+    return std::min(remaining, size <= MAX_SINGLE_TILE_SIZE ? MipGenerator::MAX_LEVELS_PER_DISPATCH : MipGenerator::MAX_LEVELS_PER_DISPATCH / 2);
+}
+
+VkImageMemoryBarrier get_level_barrier(const Vulkan::Texture& texture, U32 first_level, U32 level_count,
+                                       VkAccessFlags source_access, VkAccessFlags destination_access,
+                                       VkImageLayout old_layout, VkImageLayout new_layout)
+{
+    return {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask       = source_access,
+        .dstAccessMask       = destination_access,
+        .oldLayout           = old_layout,
+        .newLayout           = new_layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = texture.get_native(),
+        .subresourceRange
+        {
+            .aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel    = first_level,
+            .levelCount      = level_count,
+            .baseArrayLayer  = 0,
+            .layerCount      = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+}
+
+} // namespace
+
+MipGenerator::MipGenerator(VmaAllocator allocator, VkPhysicalDevice physical_device, Vulkan::DescriptorHeap& heap, Vulkan::DeletionQueue& deletion_queue)
+    : m_allocator(allocator)
+    , m_physical_device(physical_device)
+    , m_heap(heap)
+    , m_deletion_queue(deletion_queue)
+{
+    VmaAllocatorInfo allocator_info;
+    vmaGetAllocatorInfo(m_allocator, &allocator_info);
+
+    m_device = allocator_info.device;
+
+    VkPhysicalDeviceFeatures features;
+    vkGetPhysicalDeviceFeatures(m_physical_device, &features);
+
+    // The downsampler reads and writes every format through the same untyped image array
+    m_storage_images = features.shaderStorageImageArrayDynamicIndexing &&
+                       features.shaderStorageImageReadWithoutFormat     &&
+                       features.shaderStorageImageWriteWithoutFormat;
+}
+
+VkImageUsageFlags MipGenerator::get_usage(VkFormat format) const
+{
+    const VkFormatFeatureFlags features = get_format_features(format);
+
+    VkImageUsageFlags usage = 0;
+
+    if (m_storage_images && (features & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+    {
+        usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    if ((features & BLIT_FEATURES) == BLIT_FEATURES)
+    {
+        usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+
+    return usage;
+}
+
+MipGenerator::Method MipGenerator::get_method(const Vulkan::Texture& texture) const
+{
+    if (texture.get_mip_levels() < 2) { return Method::None; }
+
+    const VkImageUsageFlags usage = get_usage(texture.get_format());
+
+    // The downsampler works on 2D layers, volumes are always blitted
+    if (m_shader && (usage & VK_IMAGE_USAGE_STORAGE_BIT) && texture.get_extent().depth == 1)
+    {
+        return Method::Compute;
+    }
+
+    return (usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) ? Method::Blit : Method::None;
+}
+
+void MipGenerator::generate(Vulkan::CommandBuffer& cmd, std::span<Vulkan::Texture* const> textures)
+{
+    std::vector<Vulkan::Texture*> downsampled;
+    std::vector<Vulkan::Texture*> blitted;
+
+    U32 view_count = 0;
+
+    for (Vulkan::Texture* texture : textures)
+    {
+        Method method = get_method(*texture);
+
+        if (method == Method::Compute && view_count + texture->get_mip_levels() > MAX_BATCH_VIEWS &&
+            (get_usage(texture->get_format()) & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+        {
+            method = Method::Blit;
+        }
+
+        switch (method)
+        {
+            case Method::Compute:
+                downsampled.push_back(texture);
+                view_count += texture->get_mip_levels();
+                break;
+            case Method::Blit:
+                blitted.push_back(texture);
+                break;
+            case Method::None:
+                CR_WARN("Skipping mip generation of a texture with {} levels, its format supports neither method", texture->get_mip_levels());
+                break;
+        }
+    }
+
+    if (!downsampled.empty()) { downsample(cmd, downsampled); }
+    if (!blitted.empty())     { blit(cmd, blitted);           }
+}
+
+VkFormatFeatureFlags MipGenerator::get_format_features(VkFormat format) const
+{
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(m_physical_device, format, &properties);
+
+    return properties.optimalTilingFeatures;
+}
+
+void MipGenerator::downsample(Vulkan::CommandBuffer& cmd, std::span<Vulkan::Texture* const> textures)
+{
+    auto views = create_unique<LevelViews>(m_device, m_heap);
+
+    std::vector<U32> first_views; // Per texture, into views
+    first_views.reserve(textures.size());
+
+    U32 counter_count = 0;
+
+    for (const Vulkan::Texture* texture : textures)
+    {
+        first_views.push_back(static_cast<U32>(views->indices.size()));
+
+        for (U32 level = 0; level < texture->get_mip_levels(); ++level)
+        {
+            const VkImageViewCreateInfo view_info {
+                .sType              = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image              = texture->get_native(),
+                .viewType           = VK_IMAGE_VIEW_TYPE_2D_ARRAY, // Cube faces are plain layers here
+                .format             = texture->get_format(),
+                .components         = {},
+                .subresourceRange   = {
+                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .baseMipLevel   = level,
+                    .levelCount     = 1,
+                    .baseArrayLayer = 0,
+                    .layerCount     = texture->get_array_layers(),
+                },
+            };
+
+            VkImageView view;
+            VK_ASSERT_THROW(vkCreateImageView(m_device, &view_info, nullptr, &view), "Failed to create mip level view");
+
+            views->views.push_back(view);
+            views->indices.push_back(m_heap.register_image(view));
+        }
+
+        for (U32 source = 0; source + 1 < texture->get_mip_levels(); source += get_dispatch_level_count(*texture, source))
+        {
+            counter_count += texture->get_array_layers();
+        }
+    }
+
+    if (counter_count > m_counter_capacity)
+    {
+        if (m_counters)
+        {
+            m_deletion_queue.push(std::move(m_counters)); // Earlier batches may still be counting
+        }
+
+        m_counter_capacity = std::max(counter_count, m_counter_capacity * 2);
+        m_counters         = create_unique<Vulkan::Buffer>(m_allocator, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, U64(m_counter_capacity) * sizeof(U32), HostAccess::None, &m_heap);
+    }
+
+    // The counters are reused by every batch, the atomics of the previous one, in this or an earlier submission,
+    // must be done before they are cleared
+    const VkMemoryBarrier counted {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    };
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {&counted, 1}, {}, {});
+
+    cmd.fill_buffer(*m_counters, 0, U64(counter_count) * sizeof(U32), 0);
+
+    // Level 0 keeps its contents, the others are discarded. Everything is accessed as a storage image.
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(textures.size() * 2);
+
+    for (const Vulkan::Texture* texture : textures)
+    {
+        barriers.push_back(get_level_barrier(*texture, 0, 1, VK_ACCESS_NONE, VK_ACCESS_SHADER_READ_BIT,
+                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL));
+
+        barriers.push_back(get_level_barrier(*texture, 1, VK_REMAINING_MIP_LEVELS, VK_ACCESS_NONE, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                                             VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL));
+    }
+
+    const VkMemoryBarrier cleared {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, {&cleared, 1}, {}, barriers);
+
+    cmd.bind_shader(*m_shader);
+
+    // Every round dispatches once per texture with levels left, reading the last level the previous round wrote
+    std::vector<U32> sources(textures.size(), 0);
+
+    U32  counter_offset = 0;
+    bool first_round    = true;
+
+    while (true)
+    {
+        bool dispatched = false;
+
+        for (std::size_t i = 0; i < textures.size(); ++i)
+        {
+            const Vulkan::Texture& texture = *textures[i];
+            const U32              source  = sources[i];
+
+            if (source + 1 >= texture.get_mip_levels()) { continue; }
+
+            if (!dispatched && !first_round)
+            {
+                const VkMemoryBarrier written {
+                    .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                    .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+                };
+
+                cmd.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, {&written, 1}, {}, {});
+            }
+
+            DownsampleConstants constants {
+                .image_indices        = {},
+                .level_count          = get_dispatch_level_count(texture, source),
+                .counter_buffer_index = m_counters->get_descriptor_index(),
+                .counter_offset       = counter_offset,
+                .group_count          = 0,
+            };
+
+            for (U32 level = 0; level <= constants.level_count; ++level)
+            {
+                constants.image_indices[level] = views->indices[first_views[i] + source + level];
+            }
+
+            const U32 group_count_x = (get_level_size(texture.get_extent().width,  source) + TILE_SIZE - 1) / TILE_SIZE;
+            const U32 group_count_y = (get_level_size(texture.get_extent().height, source) + TILE_SIZE - 1) / TILE_SIZE;
+
+            constants.group_count = group_count_x * group_count_y;
+
+            cmd.push_constants(*m_shader, &constants, sizeof(constants));
+            cmd.dispatch(group_count_x, group_count_y, texture.get_array_layers());
+
+            sources[i]     += constants.level_count;
+            counter_offset += texture.get_array_layers();
+            dispatched      = true;
+        }
+
+        if (!dispatched) { break; }
+
+        first_round = false;
+    }
+
+    barriers.clear();
+
+    for (const Vulkan::Texture* texture : textures)
+    {
+        barriers.push_back(get_level_barrier(*texture, 0, VK_REMAINING_MIP_LEVELS, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                                             VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+    }
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, {}, {}, barriers);
+
+    m_deletion_queue.push(std::move(views));
+}
+
+void MipGenerator::blit(Vulkan::CommandBuffer& cmd, std::span<Vulkan::Texture* const> textures)
+{
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(textures.size() * 2);
+
+    U32 level_count = 0;
+
+    // Level 0 is the first source, the others are discarded
+    for (const Vulkan::Texture* texture : textures)
+    {
+        barriers.push_back(get_level_barrier(*texture, 0, 1, VK_ACCESS_NONE, VK_ACCESS_TRANSFER_READ_BIT,
+                                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL));
+
+        barriers.push_back(get_level_barrier(*texture, 1, VK_REMAINING_MIP_LEVELS, VK_ACCESS_NONE, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                             VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL));
+
+        level_count = std::max(level_count, texture->get_mip_levels());
+    }
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, barriers);
+
+    // Level by level across every texture, each level turns into the source of the next one
+    for (U32 level = 1; level < level_count; ++level)
+    {
+        barriers.clear();
+
+        for (const Vulkan::Texture* texture : textures)
+        {
+            if (level >= texture->get_mip_levels()) { continue; }
+
+            const VkExtent3D extent = texture->get_extent();
+
+            const VkImageBlit region {
+                .srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, texture->get_array_layers() },
+                .srcOffsets     = {
+                    VkOffset3D { 0, 0, 0 },
+                    VkOffset3D {
+                        static_cast<I32>(get_level_size(extent.width,  level - 1)),
+                        static_cast<I32>(get_level_size(extent.height, level - 1)),
+                        static_cast<I32>(get_level_size(extent.depth,  level - 1)),
+                    },
+                },
+                .dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, texture->get_array_layers() },
+                .dstOffsets     = {
+                    VkOffset3D { 0, 0, 0 },
+                    VkOffset3D {
+                        static_cast<I32>(get_level_size(extent.width,  level)),
+                        static_cast<I32>(get_level_size(extent.height, level)),
+                        static_cast<I32>(get_level_size(extent.depth,  level)),
+                    },
+                },
+            };
+
+            cmd.blit_image(texture->get_native(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           texture->get_native(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {&region, 1}, VK_FILTER_LINEAR);
+
+            barriers.push_back(get_level_barrier(*texture, level, 1, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL));
+        }
+
+        cmd.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, barriers);
+    }
+
+    barriers.clear();
+
+    for (const Vulkan::Texture* texture : textures)
+    {
+        barriers.push_back(get_level_barrier(*texture, 0, VK_REMAINING_MIP_LEVELS, VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+                                             VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+    }
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, {}, {}, barriers);
+}
+
+} // namespace Cr::Graphics::Vulkan
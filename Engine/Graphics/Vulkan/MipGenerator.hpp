@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+#include "Graphics/Vulkan/Buffer.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+class CommandBuffer;
+class DeletionQueue;
+class DescriptorHeap;
+class Shader;
+class Texture;
+
+// Fills mip chains from their first level on the GPU. Formats usable as storage images go through downsample.comp,
+// a single pass downsampler writing up to twelve levels per dispatch: every workgroup reduces a 64x64 tile to six
+// levels in shared memory and the last workgroup of a layer to finish reduces the tile results to the next six.
+// Every other format, and every texture until the shader is set, goes through a chain of linear blits.
+//
+// Any number of textures is generated in one go and they share their barriers, three per batch for the downsampler
+// plus one per further round of twelve levels, and one per level for blits. Loading many textures never
+// serializes on a per texture basis.
+class MipGenerator : public NoCopy, public NoMove
+{
+    public:
+        enum class Method
+        {
+            None,
+            Compute,
+            Blit,
+        };
+
+        static constexpr U32 TILE_SIZE               = 64; // Source texels per workgroup and axis of downsample.comp
+        static constexpr U32 MAX_LEVELS_PER_DISPATCH = 12; // Two reductions of six levels
+
+        MipGenerator() = delete;
+        MipGenerator(VmaAllocator allocator, VkPhysicalDevice physical_device, Vulkan::DescriptorHeap& heap, Vulkan::DeletionQueue& deletion_queue);
+        ~MipGenerator() = default;
+
+        // Compute pipeline of downsample.comp, null to go back to blits
+        void set_shader(const Vulkan::Shader* shader) { m_shader = shader; }
+
+        // Usage textures of the format need on top of the default ones to be generated, 0 when neither method
+        // supports the format
+        [[nodiscard]] VkImageUsageFlags get_usage(VkFormat format) const;
+
+        [[nodiscard]] Method get_method(const Vulkan::Texture& texture) const;
+
+        // Outside of rendering on a graphics queue, with the descriptor heap bound. Every level must be in
+        // VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL with level 0 visible to cmd, levels above 0 are overwritten and
+        // every level is left shader readable.
+        void generate(Vulkan::CommandBuffer& cmd, std::span<Vulkan::Texture* const> textures);
+
+    private:
+        [[nodiscard]] VkFormatFeatureFlags get_format_features(VkFormat format) const;
+
+        void downsample(Vulkan::CommandBuffer& cmd, std::span<Vulkan::Texture* const> textures);
+        void blit      (Vulkan::CommandBuffer& cmd, std::span<Vulkan::Texture* const> textures);
+
+        VmaAllocator     m_allocator       = VK_NULL_HANDLE;
+        VkPhysicalDevice m_physical_device = VK_NULL_HANDLE;
+        VkDevice         m_device          = VK_NULL_HANDLE;
+
+        Vulkan::DescriptorHeap& m_heap;
+        Vulkan::DeletionQueue&  m_deletion_queue;
+
+        const Vulkan::Shader* m_shader = nullptr;
+
+        bool m_storage_images = false; // Storage image arrays are indexable and accessible without a format
+
+        // One workgroup counter per layer and dispatch, zeroed before every batch
+        Unique<Vulkan::Buffer> m_counters;
+        U32                    m_counter_capacity = 0;
+};
+
+} // namespace Cr::Graphics::Vulkan
@@ -0,0 +1,106 @@
+#include "Graphics/Vulkan/PipelineCache.hpp"
+
+#include "Crunch/Filesystem.hpp"
+
+#include <cstring>
+
+namespace Cr::Graphics::Vulkan
+{
+
+PipelineCache::PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties, std::filesystem::path path)
+    : m_path(std::move(path))
+    , m_vendor_id(properties.vendorID)
+    , m_device_id(properties.deviceID)
+    , m_device(device)
+{
+    std::memcpy(m_cache_uuid.data(), properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    // Handed to the driver straight from the mapping, it copies what it keeps
+    MappedFile file;
+    std::span<const U8> data;
+
+    if (std::filesystem::exists(m_path))
+    {
+        file = MappedFile(m_path);
+        data = file.get_data();
+
+        if (is_compatible(data))
+        {
+            CR_INFO("Loaded pipeline cache {} ({} bytes)", m_path.string(), data.size());
+        }
+        else
+        {
+            CR_WARN("Discarding pipeline cache {}, it was written by another device or driver", m_path.string());
+            data = {};
+        }
+    }
+
+    const VkPipelineCacheCreateInfo cache_info {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = data.size(),
+        .pInitialData    = data.empty() ? nullptr : data.data(),
+    };
+
+    VK_ASSERT_THROW(vkCreatePipelineCache(m_device, &cache_info, nullptr, &m_handle), "Failed to create pipeline cache");
+}
+
+PipelineCache::~PipelineCache()
+{
+    if (m_handle)
+    {
+        vkDestroyPipelineCache(m_device, m_handle, nullptr);
+    }
+}
+
+PipelineCache::PipelineCache(PipelineCache&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr))
+    , m_path(std::move(other.m_path))
+    , m_vendor_id(other.m_vendor_id)
+    , m_device_id(other.m_device_id)
+    , m_cache_uuid(other.m_cache_uuid)
+    , m_device(std::exchange(other.m_device, nullptr))
+{}
+
+PipelineCache& PipelineCache::operator = (PipelineCache&& other) noexcept
+{
+    if (this != &other)
+    {
+        std::swap(m_handle, other.m_handle);
+        std::swap(m_path, other.m_path);
+        std::swap(m_vendor_id, other.m_vendor_id);
+        std::swap(m_device_id, other.m_device_id);
+        std::swap(m_cache_uuid, other.m_cache_uuid);
+        std::swap(m_device, other.m_device);
+    }
+    return *this;
+}
+
+void PipelineCache::save() const
+{
+    std::size_t size = 0;
+    VK_ASSERT_THROW(vkGetPipelineCacheData(m_device, m_handle, &size, nullptr), "Failed to get pipeline cache size");
+
+    std::vector<U8> data(size);
+    VK_ASSERT_THROW(vkGetPipelineCacheData(m_device, m_handle, &size, data.data()), "Failed to get pipeline cache data");
+    data.resize(size);
+
+    write_binary_file(m_path, data);
+}
+
+bool PipelineCache::is_compatible(std::span<const U8> data) const
+{
+    VkPipelineCacheHeaderVersionOne header;
+
+    if (data.size() < sizeof(header)) { return false; }
+
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize    >= sizeof(header)                       &&
+           header.headerSize    <= data.size()                          &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID      == m_vendor_id                          &&
+           header.deviceID      == m_device_id                          &&
+           std::memcmp(header.pipelineCacheUUID, m_cache_uuid.data(), VK_UUID_SIZE) == 0;
+}
+
+} // namespace Cr::Graphics::Vulkan
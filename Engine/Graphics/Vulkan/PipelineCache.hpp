@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+#include <filesystem>
+
+namespace Cr::Graphics::Vulkan
+{
+
+// VkPipelineCache backed by a file. Data written by another device or driver is detected through the
+// cache header and discarded instead of being handed to the driver.
+class PipelineCache : public NoCopy
+{
+    public:
+        PipelineCache() = default;
+        PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties, std::filesystem::path path);
+        ~PipelineCache();
+
+        PipelineCache(PipelineCache&& other) noexcept;
+        PipelineCache& operator = (PipelineCache&& other) noexcept;
+
+        void save() const;
+
+        [[nodiscard]] constexpr VkPipelineCache get_native() const { return m_handle; }
+
+    private:
+        [[nodiscard]] bool is_compatible(std::span<const U8> data) const;
+
+        VkPipelineCache m_handle {};
+
+        std::filesystem::path m_path;
+
+        U32 m_vendor_id = 0;
+        U32 m_device_id = 0;
+        std::array<U8, VK_UUID_SIZE> m_cache_uuid {};
+
+        VkDevice m_device {};
+};
+
+} // namespace Cr::Graphics::Vulkan
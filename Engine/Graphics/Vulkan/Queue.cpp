@@ -1,5 +1,8 @@
 #include "Graphics/Vulkan/Queue.hpp"
 
+#include <limits>
+#include <vector>
+
 namespace Cr::Graphics::Vulkan
 {
 
@@ -16,10 +19,28 @@ Queue::Queue(VkDevice device, U32 family_index, U32 queue_index)
     };
 
     VK_ASSERT_THROW(vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool), "Failed to create a command pool for Vulkan queue");
+
+    VkSemaphoreTypeCreateInfo timeline_info {
+        .sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue  = 0,
+    };
+
+    VkSemaphoreCreateInfo semaphore_info {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &timeline_info,
+    };
+
+    VK_ASSERT_THROW(vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_timeline), "Failed to create a timeline semaphore for Vulkan queue");
 }
 
 Queue::~Queue()
 {
+    if (m_timeline)
+    {
+        vkDestroySemaphore(m_device, m_timeline, nullptr);
+    }
+
     if (m_command_pool)
     {
         vkDestroyCommandPool(m_device, m_command_pool, nullptr);
@@ -29,6 +50,11 @@ Queue::~Queue()
 Queue::Queue(Queue&& other) noexcept
     : m_handle(std::exchange(other.m_handle, nullptr))
     , m_command_pool(std::exchange(other.m_command_pool, nullptr))
+    , m_timeline(std::exchange(other.m_timeline, nullptr))
+    , m_last_submitted(other.m_last_submitted)
+    , m_last_completed(other.m_last_completed)
+    , m_wait_statistics(other.m_wait_statistics)
+    , m_family_index(other.m_family_index)
     , m_device(std::exchange(other.m_device, nullptr))
 {}
 
@@ -38,6 +64,11 @@ Queue& Queue::operator = (Queue&& other) noexcept
     {
         std::swap(m_handle, other.m_handle);
         std::swap(m_command_pool, other.m_command_pool);
+        std::swap(m_timeline, other.m_timeline);
+        std::swap(m_last_submitted, other.m_last_submitted);
+        std::swap(m_last_completed, other.m_last_completed);
+        std::swap(m_wait_statistics, other.m_wait_statistics);
+        std::swap(m_family_index, other.m_family_index);
         std::swap(m_device, other.m_device);
     }
     return *this;
@@ -48,14 +79,119 @@ Queue& Queue::operator = (Queue&& other) noexcept
     return create_unique<Vulkan::CommandBuffer>(m_device, m_command_pool);
 }
 
-void Queue::submit(std::span<const VkSubmitInfo> submissions, VkFence to_signal)
+U64 Queue::submit(std::span<const VkCommandBuffer> command_buffers, std::span<const SemaphoreSubmit> waits, std::span<const SemaphoreSubmit> signals)
 {
-    VK_ASSERT_THROW(vkQueueSubmit(m_handle, submissions.size(), submissions.data(), to_signal), "Failed to submit command buffer"); 
+    const U64 ticket = m_last_submitted + 1;
+
+    // Infos of a submit fit on the stack, submitting never allocates
+    std::array<std::byte, 2048> scratch_buffer;
+    LinearArena scratch { scratch_buffer };
+
+    std::pmr::vector<VkCommandBufferSubmitInfo> command_buffer_infos { &scratch };
+    command_buffer_infos.reserve(command_buffers.size());
+
+    for (VkCommandBuffer command_buffer : command_buffers)
+    {
+        command_buffer_infos.push_back({
+            .sType         = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+            .commandBuffer = command_buffer,
+        });
+    }
+
+    auto to_submit_info = [](const SemaphoreSubmit& semaphore) {
+        return VkSemaphoreSubmitInfo {
+            .sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = semaphore.semaphore,
+            .value     = semaphore.value,
+            .stageMask = semaphore.stages,
+        };
+    };
+
+    std::pmr::vector<VkSemaphoreSubmitInfo> wait_infos { &scratch };
+    wait_infos.reserve(waits.size());
+
+    for (const auto& wait : waits)
+    {
+        wait_infos.push_back(to_submit_info(wait));
+    }
+
+    std::pmr::vector<VkSemaphoreSubmitInfo> signal_infos { &scratch };
+    signal_infos.reserve(signals.size() + 1);
+
+    for (const auto& signal : signals)
+    {
+        signal_infos.push_back(to_submit_info(signal));
+    }
+
+    signal_infos.push_back(to_submit_info({ m_timeline, ticket, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT }));
+
+    const VkSubmitInfo2 submit_info {
+        .sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+        .waitSemaphoreInfoCount   = static_cast<U32>(wait_infos.size()),
+        .pWaitSemaphoreInfos      = wait_infos.data(),
+        .commandBufferInfoCount   = static_cast<U32>(command_buffer_infos.size()),
+        .pCommandBufferInfos      = command_buffer_infos.data(),
+        .signalSemaphoreInfoCount = static_cast<U32>(signal_infos.size()),
+        .pSignalSemaphoreInfos    = signal_infos.data(),
+    };
+
+    VK_ASSERT_THROW(vkQueueSubmit2(m_handle, 1, &submit_info, VK_NULL_HANDLE), "Failed to submit command buffer");
+
+    m_last_submitted = ticket;
+
+    return ticket;
+}
+
+SemaphoreSubmit Queue::get_wait(U64 ticket, VkPipelineStageFlags2 stages) const
+{
+    CR_ASSERT(ticket <= m_last_submitted, "Waiting on ticket {} which was never submitted", ticket);
+
+    return { m_timeline, ticket, stages };
+}
+
+bool Queue::is_complete(U64 ticket)
+{
+    return ticket <= m_last_completed || ticket <= poll();
+}
+
+U64 Queue::poll()
+{
+    VK_ASSERT_THROW(vkGetSemaphoreCounterValue(m_device, m_timeline, &m_last_completed), "Failed to query queue timeline");
+
+    return m_last_completed;
+}
+
+void Queue::wait(U64 ticket)
+{
+    CR_ASSERT(ticket <= m_last_submitted, "Waiting on ticket {} which was never submitted", ticket);
+
+    ++m_wait_statistics.wait_count;
+
+    if (is_complete(ticket)) { return; }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const VkSemaphoreWaitInfo wait_info {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores    = &m_timeline,
+        .pValues        = &ticket,
+    };
+
+    VK_ASSERT_THROW(vkWaitSemaphores(m_device, &wait_info, std::numeric_limits<U64>::max()), "Failure while waiting for queue timeline");
+
+    const auto blocked = std::chrono::steady_clock::now() - start;
+
+    ++m_wait_statistics.blocked_count;
+    m_wait_statistics.blocked_time += blocked;
+    m_wait_statistics.longest_block = std::max<std::chrono::nanoseconds>(m_wait_statistics.longest_block, blocked);
+
+    m_last_completed = std::max(m_last_completed, ticket);
 }
 
 void Queue::wait_for_idle()
 {
-    VK_ASSERT_THROW(vkQueueWaitIdle(m_handle), "Failure while waiting for queue idle.");
+    wait(m_last_submitted);
 }
 
 } // namespace Cr::Graphics::Vulkan
@@ -5,9 +5,33 @@
 
 #include "Crunch/ClassUtility.hpp"
 
+#include <chrono>
+
 namespace Cr::Graphics::Vulkan
 {
 
+// Semaphore waited on or signaled by a submission, the value is ignored for binary semaphores
+struct SemaphoreSubmit
+{
+    VkSemaphore           semaphore = VK_NULL_HANDLE;
+    U64                   value     = 0;
+    VkPipelineStageFlags2 stages    = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+};
+
+// Time the CPU spent blocked on queue tickets
+struct QueueWaitStatistics
+{
+    U64 wait_count    = 0; // Calls to wait
+    U64 blocked_count = 0; // Calls that found the ticket incomplete and had to block
+
+    std::chrono::nanoseconds blocked_time  {};
+    std::chrono::nanoseconds longest_block {};
+};
+
+// Every submission signals the queue's timeline semaphore with the next ticket. Tickets are monotonic, so one
+// completed ticket means every earlier submission on the queue is complete as well. Ticket 0 is always complete.
+//
+// Not thread safe, like vkQueueSubmit itself. Submit from one thread at a time.
 class Queue : public NoCopy
 {
     public:
@@ -20,18 +44,45 @@ class Queue : public NoCopy
 
         [[nodiscard]] Unique<Vulkan::CommandBuffer> create_command_buffer();
 
-        void submit(std::span<const VkSubmitInfo> submissions, VkFence to_signal);
+        // Returns the ticket signaled once the command buffers have completed
+        U64 submit(std::span<const VkCommandBuffer> command_buffers,
+                   std::span<const SemaphoreSubmit> waits   = {},
+                   std::span<const SemaphoreSubmit> signals = {});
+
+        // Wait for another submission to pass through, possibly on another queue
+        [[nodiscard]] SemaphoreSubmit get_wait(U64 ticket, VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT) const;
 
+        [[nodiscard]] bool is_complete(U64 ticket);
+
+        // Refreshes and returns the last completed ticket
+        U64 poll();
+
+        void wait(U64 ticket);
         void wait_for_idle();
 
-        [[nodiscard]] constexpr U32 get_family_index() const { return m_family_index; }
-        [[nodiscard]] constexpr VkQueue get_native() const { return m_handle; }
+        [[nodiscard]] constexpr U64 get_last_submitted() const { return m_last_submitted; }
+
+        [[nodiscard]] constexpr const QueueWaitStatistics& get_wait_statistics() const { return m_wait_statistics; }
+                                      void                 reset_wait_statistics()     { m_wait_statistics = {}; }
+
+        [[nodiscard]] constexpr U32         get_family_index() const { return m_family_index; }
+        [[nodiscard]] constexpr VkQueue     get_native()       const { return m_handle; }
+        [[nodiscard]] constexpr VkSemaphore get_timeline()     const { return m_timeline; }
+
+        [[nodiscard]] constexpr bool is_valid() const { return m_handle != nullptr; }
 
     private:
         VkQueue       m_handle {};
         VkCommandPool m_command_pool {};
 
-        U32 m_family_index;
+        VkSemaphore m_timeline {};
+
+        U64 m_last_submitted = 0;
+        U64 m_last_completed = 0;
+
+        QueueWaitStatistics m_wait_statistics {};
+
+        U32 m_family_index = 0;
 
         VkDevice m_device {};
 };
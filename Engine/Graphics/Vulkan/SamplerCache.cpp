@@ -0,0 +1,87 @@
+#include "Graphics/Vulkan/SamplerCache.hpp"
+
+#include "Crunch/Hash.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+static_assert(sizeof(SamplerDescription) == 11 * 4, "Sampler descriptions are hashed by value and must not have padding");
+
+SamplerCache::SamplerCache(VkDevice device, const VkPhysicalDeviceLimits& limits)
+    : m_max_anisotropy(limits.maxSamplerAnisotropy)
+    , m_max_samplers(limits.maxSamplerAllocationCount)
+    , m_device(device)
+{
+}
+
+SamplerCache::~SamplerCache()
+{
+    for (const auto& [description, sampler] : m_samplers)
+    {
+        vkDestroySampler(m_device, sampler, nullptr);
+    }
+}
+
+std::size_t SamplerCache::DescriptionHash::operator () (const SamplerDescription& description) const
+{
+    return static_cast<std::size_t>(hash_value(description));
+}
+
+VkSampler SamplerCache::get_sampler(const SamplerDescription& description)
+{
+    // Anisotropy the device can not deliver maps to the same sampler as its limit. Floats are hashed bytewise,
+    // adding 0 turns -0 into +0 so both find the same sampler.
+    SamplerDescription normalized = description;
+    normalized.max_anisotropy = std::clamp(description.max_anisotropy, 1.0f, m_max_anisotropy) + 0.0f;
+    normalized.mip_lod_bias   = description.mip_lod_bias + 0.0f;
+    normalized.min_lod        = description.min_lod      + 0.0f;
+    normalized.max_lod        = description.max_lod      + 0.0f;
+
+    std::lock_guard lock(m_mutex);
+
+    if (const auto it = m_samplers.find(normalized); it != m_samplers.end())
+    {
+        return it->second;
+    }
+
+    CR_ASSERT_THROW(m_samplers.size() < m_max_samplers, "Sampler cache is out of device samplers ({})", m_max_samplers);
+
+    const VkSamplerCreateInfo sampler_info {
+        .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .pNext                   = nullptr,
+        .flags                   = 0,
+        .magFilter               = normalized.mag_filter,
+        .minFilter               = normalized.min_filter,
+        .mipmapMode              = normalized.mipmap_mode,
+        .addressModeU            = normalized.address_u,
+        .addressModeV            = normalized.address_v,
+        .addressModeW            = normalized.address_w,
+        .mipLodBias              = normalized.mip_lod_bias,
+        .anisotropyEnable        = normalized.max_anisotropy > 1.0f ? VK_TRUE : VK_FALSE,
+        .maxAnisotropy           = normalized.max_anisotropy,
+        .compareEnable           = VK_FALSE,
+        .compareOp               = VK_COMPARE_OP_ALWAYS,
+        .minLod                  = normalized.min_lod,
+        .maxLod                  = normalized.max_lod,
+        .borderColor             = normalized.border_color,
+        .unnormalizedCoordinates = VK_FALSE,
+    };
+
+    VkSampler sampler;
+
+    const VkResult result = vkCreateSampler(m_device, &sampler_info, nullptr, &sampler);
+    VK_ASSERT_THROW(result, "Failed to create Vulkan Sampler: {}", to_string(result));
+
+    m_samplers.emplace(normalized, sampler);
+
+    return sampler;
+}
+
+U32 SamplerCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+
+    return static_cast<U32>(m_samplers.size());
+}
+
+} // namespace Cr::Graphics::Vulkan
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Cr::Graphics::Vulkan
+{
+
+struct SamplerDescription
+{
+    VkFilter            mag_filter  = VK_FILTER_LINEAR;
+    VkFilter            min_filter  = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode mipmap_mode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+
+    VkSamplerAddressMode address_u = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode address_v = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode address_w = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+
+    F32 max_anisotropy = 16.0f; // Clamped to the device limit, 1 and below disable anisotropic filtering
+
+    F32 mip_lod_bias = 0.0f;
+    F32 min_lod      = 0.0f;
+    F32 max_lod      = VK_LOD_CLAMP_NONE; // Every level of the view
+
+    VkBorderColor border_color = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+
+    [[nodiscard]] bool operator == (const SamplerDescription& other) const = default;
+};
+
+// Samplers keyed on their description, identical ones are created once and shared by every texture
+// using them. Handles stay valid as long as the cache, so they can also be baked into layouts as immutable
+// samplers. Thread safe.
+class SamplerCache : public NoCopy, public NoMove
+{
+    public:
+        SamplerCache() = delete;
+        SamplerCache(VkDevice device, const VkPhysicalDeviceLimits& limits);
+        ~SamplerCache();
+
+        [[nodiscard]] VkSampler get_sampler(const SamplerDescription& description);
+
+        [[nodiscard]] U32 size() const;
+
+    private:
+        // Of normalized descriptions, their bytes are equal whenever the descriptions are
+        struct DescriptionHash
+        {
+            [[nodiscard]] std::size_t operator () (const SamplerDescription& description) const;
+        };
+
+        mutable std::mutex m_mutex;
+
+        std::unordered_map<SamplerDescription, VkSampler, DescriptionHash> m_samplers;
+
+        F32 m_max_anisotropy = 1.0f;
+        U32 m_max_samplers   = 0;
+
+        VkDevice m_device {};
+};
+
+} // namespace Cr::Graphics::Vulkan
@@ -1,16 +1,28 @@
 #include "Graphics/Vulkan/Shader.hpp"
 #include "Graphics/Vulkan/ShaderModule.hpp"
+#include "Graphics/Vulkan/LayoutCache.hpp"
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
+
+#include <map>
 
 namespace Cr::Graphics::Vulkan
 {
 
-Shader::Shader(VkDevice device, VkFormat swap_format, VkPipelineBindPoint bindpoint, std::span<const Vulkan::ShaderModule* const> modules)
+Shader::Shader(VkDevice                                      device,
+               Vulkan::LayoutCache&                          layouts,
+               const Vulkan::DescriptorHeap&                 heap,
+               VkPipelineCache                               cache,
+               VkFormat                                      swap_format,
+               VkPipelineBindPoint                           bindpoint,
+               std::span<const Vulkan::ShaderModule* const>  modules)
     : m_bindpoint(bindpoint)
     , m_device(device)
 {
-    VkResult result {};
+    // Create infos only live through the constructor, which runs on compiler workers
+    std::array<std::byte, 1024> scratch_buffer;
+    LinearArena scratch { scratch_buffer };
 
-    std::vector<VkPipelineShaderStageCreateInfo> stage_infos;
+    std::pmr::vector<VkPipelineShaderStageCreateInfo> stage_infos { &scratch };
 
     VkShaderStageFlags stage_flags = {};
     for (const auto* module : modules)
@@ -26,34 +38,120 @@ Shader::Shader(VkDevice device, VkFormat swap_format, VkPipelineBindPoint bindpo
         });
     }
 
-    // TODO Define from a provided Vertex layout but hardcode for now
-    const VkVertexInputBindingDescription bind_descriptor{
-        .binding   = 0,
-        .stride    = sizeof(float) * 5,
-        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
-    };
+    // Descriptor set layouts, bindings shared between stages are merged
+
+    std::map<U32, std::vector<VkDescriptorSetLayoutBinding>> set_bindings {{DescriptorHeap::SET, {}}};
+
+    for (const auto* module : modules)
+    {
+        for (const auto& [set, binding] : module->get_descriptor_set_layout_bindings())
+        {
+            auto& bindings = set_bindings[set];
+
+            auto it = std::find_if(bindings.begin(), bindings.end(), [&](const auto& b) { return b.binding == binding.binding; });
+
+            if (it == bindings.end())
+            {
+                bindings.push_back(binding);
+                continue;
+            }
+
+            CR_ASSERT_THROW(it->descriptorType == binding.descriptorType && it->descriptorCount == binding.descriptorCount,
+                "Stages disagree on the descriptor at set {} binding {}", set, binding.binding);
+
+            it->stageFlags |= binding.stageFlags;
+        }
+    }
+
+    // The heap set is declared by the shaders as unsized arrays, only check they agree with it
 
-    const VkVertexInputAttributeDescription attribute_descriptors[2] {
+    for (const auto& binding : set_bindings[DescriptorHeap::SET])
+    {
+        const bool matches_heap =
+            (binding.binding == DescriptorHeap::TEXTURE_BINDING && binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) ||
+            (binding.binding == DescriptorHeap::BUFFER_BINDING  && binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) ||
+            (binding.binding == DescriptorHeap::IMAGE_BINDING   && binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+
+        CR_ASSERT_THROW(matches_heap, "Set {} is reserved for the descriptor heap, binding {} does not match it", DescriptorHeap::SET, binding.binding);
+    }
+
+    // Unused set numbers in between get empty layouts
+    const U32 set_count = set_bindings.rbegin()->first + 1;
+
+    m_descriptor_set_layouts.resize(set_count);
+    for (U32 set = 0; set < set_count; ++set)
+    {
+        if (set == DescriptorHeap::SET)
         {
-            .location = 0,
-            .binding  = 0,
-            .format   = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset   = 0,
-        },
+            m_descriptor_set_layouts[set] = heap.get_set_layout();
+            continue;
+        }
+
+        auto& bindings = set_bindings[set];
+        std::sort(bindings.begin(), bindings.end(), [](const auto& a, const auto& b) { return a.binding < b.binding; });
+
+        m_descriptor_set_layouts[set] = layouts.get_descriptor_set_layout(bindings);
+    }
+
+    // Push constants, every layout shares the heap range so that bound sets stay compatible between shaders
+
+    for (const auto* module : modules)
+    {
+        for (const auto& range : module->get_push_constant_ranges())
         {
-            .location = 1,
-            .binding  = 0,
-            .format   = VK_FORMAT_R32G32_SFLOAT,
-            .offset   = sizeof(float) * 3,
+            CR_ASSERT_THROW(range.offset + range.size <= DescriptorHeap::PUSH_CONSTANT_SIZE,
+                "Push constants exceed the {} bytes shared by every shader", DescriptorHeap::PUSH_CONSTANT_SIZE);
         }
+    }
+
+    const VkPushConstantRange push_constant_range = heap.get_push_constant_range();
+
+    m_push_constant_stages = push_constant_range.stageFlags;
+
+    m_pipeline_layout = layouts.get_pipeline_layout(m_descriptor_set_layouts, {&push_constant_range, 1});
+
+    if (m_bindpoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+    {
+        CR_ASSERT_THROW(stage_infos.size() == 1 && stage_flags == VK_SHADER_STAGE_COMPUTE_BIT, "Compute shaders take a single compute module");
+
+        const VkComputePipelineCreateInfo pipeline_info {
+            .sType             = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .stage             = stage_infos.front(),
+            .layout            = m_pipeline_layout,
+            .basePipelineIndex = -1,
+        };
+
+        const VkResult result = vkCreateComputePipelines(m_device, cache, 1, &pipeline_info, nullptr, &m_handle);
+        VK_ASSERT_THROW(result, "Failed to create Vulkan compute Pipeline: {}", to_string(result));
+
+        return;
+    }
+
+    // Vertex input, one binding with the attributes of the vertex stage
+
+    const Vulkan::ShaderModule* vertex_module = nullptr;
+    for (const auto* module : modules)
+    {
+        if (module->get_stage() == VK_SHADER_STAGE_VERTEX_BIT)
+        {
+            vertex_module = module;
+        }
+    }
+
+    const auto vertex_attributes = vertex_module ? vertex_module->get_vertex_attributes() : std::span<const VkVertexInputAttributeDescription>{};
+
+    const VkVertexInputBindingDescription bind_descriptor{
+        .binding   = 0,
+        .stride    = vertex_module ? vertex_module->get_vertex_stride() : 0,
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
     };
 
     const VkPipelineVertexInputStateCreateInfo vertex_input_state_info {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount   = 1,
+        .vertexBindingDescriptionCount   = vertex_attributes.empty() ? 0u : 1u,
         .pVertexBindingDescriptions      = &bind_descriptor,
-        .vertexAttributeDescriptionCount = 2,
-        .pVertexAttributeDescriptions    = attribute_descriptors,
+        .vertexAttributeDescriptionCount = static_cast<U32>(vertex_attributes.size()),
+        .pVertexAttributeDescriptions    = vertex_attributes.data(),
     };
 
     const VkPipelineInputAssemblyStateCreateInfo input_assembly_info{
@@ -135,51 +233,7 @@ Shader::Shader(VkDevice device, VkFormat swap_format, VkPipelineBindPoint bindpo
         .dynamicStateCount = static_cast<uint32_t>(dynamic_states.size()),
         .pDynamicStates    = dynamic_states.data(),
     };
-    
-    // TODO Reflect, hardcode for now
-    const std::array descriptor_set_layout_bindings {
-        VkDescriptorSetLayoutBinding{
-            .binding = 0,
-            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-            .pImmutableSamplers = nullptr,
-        },
-        VkDescriptorSetLayoutBinding{
-            .binding = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-            .pImmutableSamplers = nullptr,
-        },
-    };
-
-    const VkDescriptorSetLayoutCreateInfo descriptor_set_layout_info {
-        .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = descriptor_set_layout_bindings.size(),
-        .pBindings    = descriptor_set_layout_bindings.data(),
-    };
-
-    result = vkCreateDescriptorSetLayout(m_device, &descriptor_set_layout_info, nullptr, &m_descriptor_set_layout);
-    VK_ASSERT_THROW(result, "Failed to create Vulkan Descriptor Set Layout: {}", to_string(result));
-
-    // TODO Reflect, hardcode for now
-    const VkPushConstantRange push_constant_range {
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-        .offset     = 0,
-        .size       = sizeof(PushConstantObject),
-    };
 
-    const VkPipelineLayoutCreateInfo layout_info {
-        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount         = 1,
-        .pSetLayouts            = &m_descriptor_set_layout,
-        .pushConstantRangeCount = 1,
-        .pPushConstantRanges    = &push_constant_range,
-    };
-
-    result = vkCreatePipelineLayout(m_device, &layout_info, nullptr, &m_pipeline_layout);
-    VK_ASSERT_THROW(result, "Failed to create Vulkan Pipeline Layout: {}", to_string(result));
 
     const VkPipelineRenderingCreateInfoKHR pipeline_rendering_info {
         .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
@@ -208,20 +262,41 @@ Shader::Shader(VkDevice device, VkFormat swap_format, VkPipelineBindPoint bindpo
         .basePipelineIndex   = -1,
     };
 
-    result = vkCreateGraphicsPipelines(m_device, nullptr, 1, &pipeline_info, nullptr, &m_handle);
+    const VkResult result = vkCreateGraphicsPipelines(m_device, cache, 1, &pipeline_info, nullptr, &m_handle);
     VK_ASSERT_THROW(result, "Failed to create Vulkan Pipeline: {}", to_string(result));
 }
 
+Shader::Shader(Shader&& other) noexcept
+    : m_handle                (std::exchange(other.m_handle,          nullptr))
+    , m_pipeline_layout       (std::exchange(other.m_pipeline_layout, nullptr))
+    , m_bindpoint             (other.m_bindpoint)
+    , m_descriptor_set_layouts(std::move(other.m_descriptor_set_layouts))
+    , m_push_constant_stages  (other.m_push_constant_stages)
+    , m_device                (std::exchange(other.m_device,          nullptr))
+{}
+
+Shader& Shader::operator = (Shader&& other) noexcept
+{
+    if (this != &other)
+    {
+        std::swap(m_handle,                 other.m_handle);
+        std::swap(m_pipeline_layout,        other.m_pipeline_layout);
+        std::swap(m_bindpoint,              other.m_bindpoint);
+        std::swap(m_descriptor_set_layouts, other.m_descriptor_set_layouts);
+        std::swap(m_push_constant_stages,   other.m_push_constant_stages);
+        std::swap(m_device,                 other.m_device);
+    }
+    return *this;
+}
+
 Shader::~Shader()
 {
     if (m_handle)
     {
         vkDestroyPipeline(m_device, m_handle, nullptr);
-        vkDestroyPipelineLayout(m_device, m_pipeline_layout, nullptr);
-        vkDestroyDescriptorSetLayout(m_device, m_descriptor_set_layout, nullptr);
         m_handle = {};
         m_pipeline_layout = {};
-        m_descriptor_set_layout = {};
+        m_descriptor_set_layouts = {};
         m_device = {};
     }
 }
@@ -8,25 +8,44 @@ namespace Cr::Graphics::Vulkan
 {
 
 class ShaderModule;
+class LayoutCache;
+class DescriptorHeap;
 
 class Shader : public NoCopy
 {
     public:
         Shader() = default;
-        Shader(VkDevice device, VkFormat swap_format, VkPipelineBindPoint bindpoint, std::span<const Vulkan::ShaderModule* const> modules);
+        // Layouts and vertex input are reflected from the modules, layouts are shared through the cache.
+        // Set DescriptorHeap::SET is always the heap and the push constant range is the heap's shared one.
+        Shader(VkDevice                                      device,
+               Vulkan::LayoutCache&                          layouts,
+               const Vulkan::DescriptorHeap&                 heap,
+               VkPipelineCache                               cache,
+               VkFormat                                      swap_format,
+               VkPipelineBindPoint                           bindpoint,
+               std::span<const Vulkan::ShaderModule* const>  modules);
         ~Shader();
 
+        Shader(Shader&& other) noexcept;
+        Shader& operator = (Shader&& other) noexcept;
+
         [[nodiscard]] constexpr const VkPipeline&       get_native()     const { return m_handle;          }
         [[nodiscard]] constexpr const VkPipelineLayout& get_pipeline_layout()     const { return m_pipeline_layout; }
         [[nodiscard]] constexpr VkPipelineBindPoint     get_bind_point() const { return m_bindpoint;       }
 
-        [[nodiscard]] constexpr const VkDescriptorSetLayout& get_descriptor_set_layout() const { return m_descriptor_set_layout; }
+        [[nodiscard]] constexpr const VkDescriptorSetLayout& get_descriptor_set_layout(U32 set = 0) const { return m_descriptor_set_layouts[set]; }
+
+        // Every stage using push constants, all of them have to be named when pushing
+        [[nodiscard]] constexpr VkShaderStageFlags get_push_constant_stages() const { return m_push_constant_stages; }
+
     private:
         VkPipeline          m_handle          {};
-        VkPipelineLayout    m_pipeline_layout {};
+        VkPipelineLayout    m_pipeline_layout {}; // Owned by the layout cache
         VkPipelineBindPoint m_bindpoint       {};
 
-        VkDescriptorSetLayout m_descriptor_set_layout {};
+        std::vector<VkDescriptorSetLayout> m_descriptor_set_layouts; // Owned by the layout cache, indexed by set
+
+        VkShaderStageFlags m_push_constant_stages {};
 
         VkDevice m_device {};
 };
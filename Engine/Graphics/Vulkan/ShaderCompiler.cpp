@@ -0,0 +1,107 @@
+#include "Graphics/Vulkan/ShaderCompiler.hpp"
+#include "Graphics/Vulkan/ShaderModule.hpp"
+
+#include "Crunch/Hash.hpp"
+
+namespace Cr::Graphics::Vulkan
+{
+
+ShaderCompiler::ShaderCompiler(VkDevice device, Vulkan::LayoutCache& layouts, const Vulkan::DescriptorHeap& heap, VkPipelineCache cache, VkFormat color_format, Core::JobSystem& jobs)
+    : m_device(device)
+    , m_layouts(layouts)
+    , m_heap(heap)
+    , m_cache(cache)
+    , m_color_format(color_format)
+    , m_jobs(jobs)
+{
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    wait_for_idle();
+}
+
+std::vector<ShaderCompiler::Future> ShaderCompiler::compile(std::span<const ShaderDescription> descriptions)
+{
+    std::vector<Future> futures;
+    futures.reserve(descriptions.size());
+
+    std::lock_guard lock(m_mutex);
+
+    for (const auto& description : descriptions)
+    {
+        auto [it, inserted] = m_shaders.try_emplace(get_key(description));
+
+        if (!inserted)
+        {
+            futures.push_back(it->second->future);
+            continue;
+        }
+
+        it->second = create_unique<Entry>();
+
+        Entry& entry = *it->second;
+        entry.future = entry.promise.get_future().share();
+
+        futures.push_back(entry.future);
+
+        // Entries are never erased while the compiler lives, the reference stays valid for the job
+        m_jobs.run([this, &entry, description]()
+        {
+            try
+            {
+                entry.shader = create_unique<Vulkan::Shader>(m_device, m_layouts, m_heap, m_cache, m_color_format, description.bind_point, description.modules);
+                entry.promise.set_value(entry.shader.get());
+            }
+            catch (...)
+            {
+                entry.promise.set_exception(std::current_exception());
+            }
+        }, &m_pending);
+    }
+
+    return futures;
+}
+
+ShaderCompiler::Future ShaderCompiler::compile(const ShaderDescription& description)
+{
+    return compile({&description, 1}).front();
+}
+
+void ShaderCompiler::wait_for_idle()
+{
+    m_jobs.wait(m_pending);
+}
+
+ShaderCompiler::Key ShaderCompiler::get_key(const ShaderDescription& description)
+{
+    Key key { .bind_point = description.bind_point };
+    key.stages.reserve(description.modules.size());
+
+    for (const auto* module : description.modules)
+    {
+        key.stages.push_back({
+            .stage = module->get_stage(),
+            .hash  = module->get_hash(),
+            .spirv = { module->get_spirv().begin(), module->get_spirv().end() },
+        });
+    }
+
+    std::ranges::sort(key.stages, {}, &Stage::stage);
+
+    return key;
+}
+
+std::size_t ShaderCompiler::KeyHash::operator () (const Key& key) const
+{
+    U64 hash = hash_value(key.bind_point);
+
+    for (const auto& stage : key.stages)
+    {
+        hash = hash_combine(hash, stage.hash);
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
+} // namespace Cr::Graphics::Vulkan
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+#include "Graphics/Vulkan/Shader.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+namespace Cr::Graphics::Vulkan
+{
+
+class ShaderModule;
+class LayoutCache;
+class DescriptorHeap;
+
+struct ShaderDescription
+{
+    VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+    std::vector<const Vulkan::ShaderModule*> modules; // Must stay alive until the shader is compiled
+};
+
+// Compiles shader pipelines on the job system. Identical descriptions, within a batch or across calls, share a
+// single pipeline: descriptions match when their bind point and the SPIR-V and stage of every module do. The compiler owns every shader it hands out.
+// Must be driven from the thread that created the job system.
+class ShaderCompiler : public NoCopy, public NoMove
+{
+    public:
+        using Future = std::shared_future<const Vulkan::Shader*>;
+
+        ShaderCompiler() = delete;
+        ShaderCompiler(VkDevice device, Vulkan::LayoutCache& layouts, const Vulkan::DescriptorHeap& heap, VkPipelineCache cache, VkFormat color_format, Core::JobSystem& jobs);
+        ~ShaderCompiler(); // Waits for pending compilations
+
+        // One future per description, in order. Compilation errors are rethrown by Future::get.
+        [[nodiscard]] std::vector<Future> compile(std::span<const ShaderDescription> descriptions);
+        [[nodiscard]] Future              compile(const ShaderDescription& description);
+
+        // Helps the workers until every requested shader is compiled
+        void wait_for_idle();
+
+    private:
+        struct Stage
+        {
+            VkShaderStageFlags stage = 0;
+            U64                hash  = 0; // Of the module, compared before the code
+            std::vector<U8>    spirv;
+
+            [[nodiscard]] bool operator == (const Stage& other) const = default;
+        };
+
+        // Owns copies of the module contents, modules may be destroyed once their shader is compiled. The color
+        // format is the same for every shader of a compiler.
+        struct Key
+        {
+            VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            std::vector<Stage>  stages; // In stage order, module order doesn't change the pipeline
+
+            [[nodiscard]] bool operator == (const Key& other) const = default;
+        };
+
+        struct KeyHash
+        {
+            [[nodiscard]] std::size_t operator () (const Key& key) const;
+        };
+
+        [[nodiscard]] static Key get_key(const ShaderDescription& description);
+
+        struct Entry
+        {
+            std::promise<const Vulkan::Shader*> promise;
+            Future                              future;
+            Unique<Vulkan::Shader>              shader;
+        };
+
+        VkDevice                      m_device {};
+        Vulkan::LayoutCache&          m_layouts;
+        const Vulkan::DescriptorHeap& m_heap;
+
+        VkPipelineCache m_cache        {};
+        VkFormat        m_color_format {};
+
+        Core::JobSystem& m_jobs;
+        Core::JobCounter m_pending;
+
+        std::mutex                                      m_mutex; // Guards the map, entries are only written by their job
+        std::unordered_map<Key, Unique<Entry>, KeyHash> m_shaders;
+};
+
+} // namespace Cr::Graphics::Vulkan
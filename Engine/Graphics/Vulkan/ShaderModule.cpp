@@ -1,14 +1,67 @@
 #include "Graphics/Vulkan/ShaderModule.hpp"
 
+#include "Graphics/SPIRVReflection.hpp"
+
+#include "Crunch/Hash.hpp"
+
 namespace Cr::Graphics::Vulkan
 {
 
 ShaderModule::ShaderModule(VkDevice device, std::span<const U8> spirv, VkShaderStageFlags stage)
-    //: m_reflection(spirv)
-    : m_handle()
+    : m_spirv(spirv.begin(), spirv.end())
+    , m_handle()
     , m_stage(stage)
+    , m_hash(hash_combine(hash_bytes(spirv), stage))
     , m_device(device)
 {
+    const SPIRVReflection reflection(spirv);
+
+    // Reflection results only live through the constructor
+    std::array<std::byte, 2048> scratch_buffer;
+    LinearArena scratch { scratch_buffer };
+
+    for (const auto* binding : reflection.get_descriptor_bindings(&scratch))
+    {
+        m_bindings.push_back({
+            .set     = binding->set,
+            .binding = {
+                .binding         = binding->binding,
+                .descriptorType  = static_cast<VkDescriptorType>(binding->descriptor_type), // Values match
+                .descriptorCount = binding->count,
+                .stageFlags      = m_stage,
+            },
+        });
+    }
+
+    for (const auto* block : reflection.get_push_constant_blocks(&scratch))
+    {
+        m_push_constants.push_back({
+            .stageFlags = m_stage,
+            .offset     = block->offset,
+            .size       = block->size,
+        });
+    }
+
+    if (m_stage == VK_SHADER_STAGE_VERTEX_BIT)
+    {
+        auto inputs = reflection.get_inputs(&scratch);
+
+        std::erase_if(inputs, [](const auto* input) { return (input->decoration_flags & SPV_REFLECT_DECORATION_BUILT_IN) != 0; });
+        std::sort(inputs.begin(), inputs.end(), [](const auto* a, const auto* b) { return a->location < b->location; });
+
+        for (const auto* input : inputs)
+        {
+            m_vertex_attributes.push_back({
+                .location = input->location,
+                .binding  = 0,
+                .format   = static_cast<VkFormat>(input->format), // Values match
+                .offset   = m_vertex_stride,
+            });
+
+            m_vertex_stride += input->numeric.scalar.width / 8 * std::max(1u, input->numeric.vector.component_count);
+        }
+    }
+
     VkShaderModuleCreateInfo info {
         .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
         .codeSize = spirv.size(),
@@ -29,25 +82,4 @@ ShaderModule::~ShaderModule()
     }
 }
 
-// [[nodiscard]] std::vector<VkDescriptorSetLayoutBinding> ShaderModule::get_descriptor_set_layout_bindings() const
-// {
-//     std::vector<VkDescriptorSetLayoutBinding> vulkan_bindings;
-//     for (const auto* descriptor_set : m_reflection.get_descriptor_sets())
-//     {
-//         for (const auto it = descriptor_set->bindings, end = it + descriptor_set->binding_count; it != end; ++it)
-//         {
-//             const auto* binding = *it;
-//             vulkan_bindings.push_back({
-//                 .binding         = layout->binding,
-//                 .descriptorCount = layout->
-//                 .descriptorType  = layout->count.
-//                 .stageFlags      = m_stage,
-//             });
-//         }
-//     }
-// }
-
-//[[nodiscard]] std::vector<VkPushConstantRange> ShaderModule::get_push_constant_ranges() const
-//{
-
 } // Cr::Graphics::Vulkan
@@ -1,30 +1,52 @@
 #pragma once
 
 #include "Crunch/ClassUtility.hpp"
-// #include "Graphics/SPIRVReflection.hpp"
 
 #include "Graphics/Vulkan/Vulkan.hpp"
 
 namespace Cr::Graphics::Vulkan
 {
 
+struct DescriptorBinding
+{
+    U32                          set;
+    VkDescriptorSetLayoutBinding binding;
+};
+
 class ShaderModule : public NoCopy
 {
     public:
         ShaderModule(VkDevice device, std::span<const U8> spirv, VkShaderStageFlags stage);
         ~ShaderModule();
 
-        // [[nodiscard]] std::vector<VkDescriptorSetLayoutBinding> get_descriptor_set_layout_bindings() const;
-        // [[nodiscard]] std::vector<VkPushConstantRange>          get_push_constant_ranges()  const;
+        // Reflected from the SPIR-V, stage flags are the module's own
+        [[nodiscard]] constexpr std::span<const DescriptorBinding>   get_descriptor_set_layout_bindings() const { return m_bindings;       }
+        [[nodiscard]] constexpr std::span<const VkPushConstantRange> get_push_constant_ranges()           const { return m_push_constants; }
+
+        // Vertex stage only, attributes of a single tightly packed binding in location order
+        [[nodiscard]] constexpr std::span<const VkVertexInputAttributeDescription> get_vertex_attributes() const { return m_vertex_attributes; }
+        [[nodiscard]] constexpr U32                                                get_vertex_stride()     const { return m_vertex_stride;     }
 
         [[nodiscard]] constexpr VkShaderStageFlags    get_stage()  const { return m_stage;  }
         [[nodiscard]] constexpr const VkShaderModule& get_native() const { return m_handle; }
 
+        // Of the SPIR-V and stage, identical modules hash the same
+        [[nodiscard]] constexpr U64 get_hash() const { return m_hash; }
+
+        // Kept so identical modules can be told apart from hash collisions
+        [[nodiscard]] constexpr std::span<const U8> get_spirv() const { return m_spirv; }
+
     private:
-        // SPIRVReflection m_reflection;
+        std::vector<DescriptorBinding>                 m_bindings;
+        std::vector<VkPushConstantRange>               m_push_constants;
+        std::vector<VkVertexInputAttributeDescription> m_vertex_attributes;
+        U32                                            m_vertex_stride = 0;
+
+        std::vector<U8> m_spirv;
 
         VkShaderModule     m_handle;
         VkShaderStageFlags m_stage;
+        U64                m_hash;
 
         VkDevice m_device; 
 };
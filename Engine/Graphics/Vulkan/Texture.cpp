@@ -1,11 +1,43 @@
 #include "Graphics/Vulkan/Texture.hpp"
+#include "Graphics/Vulkan/DescriptorHeap.hpp"
 
 namespace Cr::Graphics::Vulkan
 {
 
-Texture::Texture(VmaAllocator allocator, VkFormat format, VkExtent3D extent) 
-    : m_allocator(allocator)
+Texture::Texture(VmaAllocator allocator, VkFormat format, VkExtent3D extent, VkSampler sampler, Vulkan::DescriptorHeap* heap)
+    : Texture(allocator, TextureDescription{ .format = format, .extent = extent }, sampler, heap)
+{}
+
+Texture::Texture(VmaAllocator allocator, const TextureDescription& description, VkSampler sampler, Vulkan::DescriptorHeap* heap)
+    : m_sampler(sampler)
+    , m_allocator(allocator)
+    , m_heap(heap)
+    , m_format(description.format)
+    , m_extent(description.extent)
+    , m_mip_levels(description.mip_levels)
+    , m_array_layers(description.array_layers * (description.cubemap ? 6 : 1))
 {
+    const bool volume = description.extent.depth > 1;
+
+    CR_ASSERT_THROW(description.mip_levels > 0 && description.array_layers > 0, "Texture without mip levels or layers");
+    CR_ASSERT_THROW(description.mip_levels <= get_full_mip_levels(description.extent), "Texture has more mip levels than its extent allows");
+    CR_ASSERT_THROW(!volume || (description.array_layers == 1 && !description.cubemap), "3D textures can not be arrays or cubemaps");
+
+    VkImageViewType view_type = VK_IMAGE_VIEW_TYPE_2D;
+
+    if (volume)
+    {
+        view_type = VK_IMAGE_VIEW_TYPE_3D;
+    }
+    else if (description.cubemap)
+    {
+        view_type = description.array_layers > 1 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+    }
+    else if (description.array_layers > 1)
+    {
+        view_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    }
+
     VmaAllocatorInfo allocator_info;
     vmaGetAllocatorInfo(m_allocator, &allocator_info);
 
@@ -14,15 +46,15 @@ Texture::Texture(VmaAllocator allocator, VkFormat format, VkExtent3D extent)
     VkImageCreateInfo image_info {
         .sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .pNext         = nullptr,
-        .flags         = 0,
-        .imageType     = VK_IMAGE_TYPE_2D,
-        .format        = format,
-        .extent        = extent,
-        .mipLevels     = 1,
-        .arrayLayers   = 1,
+        .flags         = description.cubemap ? VkImageCreateFlags(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) : 0,
+        .imageType     = volume ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D,
+        .format        = description.format,
+        .extent        = description.extent,
+        .mipLevels     = m_mip_levels,
+        .arrayLayers   = m_array_layers,
         .samples       = VK_SAMPLE_COUNT_1_BIT,
         .tiling        = VK_IMAGE_TILING_OPTIMAL,
-        .usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | description.usage,
         .sharingMode   = VK_SHARING_MODE_EXCLUSIVE,
         // .queueFamilyIndexCount,
         // .pQueueFamilyIndices,
@@ -39,77 +71,77 @@ Texture::Texture(VmaAllocator allocator, VkFormat format, VkExtent3D extent)
         .pNext              = nullptr,
         .flags              = 0,
         .image              = m_handle,
-        .viewType           = VK_IMAGE_VIEW_TYPE_2D,
-        .format             = format,
+        .viewType           = view_type,
+        .format             = description.format,
         .components         = {}, // Default rgb
         .subresourceRange   = {
             .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
             .baseMipLevel   = 0,
-            .levelCount     = 1,
+            .levelCount     = m_mip_levels,
             .baseArrayLayer = 0,
-            .layerCount     = 1,
+            .layerCount     = m_array_layers,
         },
     };
 
     VK_ASSERT_THROW(vkCreateImageView(device, &view_info, nullptr, &m_view), "Failed to create image view for texture");
 
-    VkSamplerCreateInfo sampler_info {
-        .sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-        .pNext                   = nullptr,
-        .flags                   = 0,
-        .magFilter               = VK_FILTER_LINEAR,
-        .minFilter               = VK_FILTER_LINEAR,
-        .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR,
-        .addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .mipLodBias              = 0.0f,
-        .anisotropyEnable        = VK_TRUE, 
-        .maxAnisotropy           = 1.0f,
-        .compareEnable           = VK_FALSE,
-        .compareOp               = VK_COMPARE_OP_ALWAYS,
-        .minLod                  = 0.0f,
-        .maxLod                  = 0.0f,
-        .borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
-        .unnormalizedCoordinates = VK_FALSE,
-    };
-
-    VK_ASSERT_THROW(vkCreateSampler(device, &sampler_info, nullptr, &m_sampler), "Failed to create image sampler for texture");
+    if (m_heap)
+    {
+        m_descriptor_index = m_heap->register_texture(m_view, m_sampler);
+    }
 }
 
 Texture::Texture(Texture&& other) noexcept
-    : m_handle    (std::exchange(other.m_handle,     nullptr))
-    , m_view      (std::exchange(other.m_view,       nullptr))
-    , m_sampler   (std::exchange(other.m_sampler,    nullptr))
-    , m_allocation(std::exchange(other.m_allocation, nullptr))
-    , m_allocator (std::exchange(other.m_allocator,  nullptr))
+    : m_handle          (std::exchange(other.m_handle,           nullptr))
+    , m_view            (std::exchange(other.m_view,             nullptr))
+    , m_sampler         (std::exchange(other.m_sampler,          nullptr))
+    , m_allocation      (std::exchange(other.m_allocation,       nullptr))
+    , m_allocator       (std::exchange(other.m_allocator,        nullptr))
+    , m_heap            (std::exchange(other.m_heap,             nullptr))
+    , m_descriptor_index(std::exchange(other.m_descriptor_index, DescriptorHeap::INVALID_INDEX))
+    , m_format          (std::exchange(other.m_format,           VK_FORMAT_UNDEFINED))
+    , m_extent          (std::exchange(other.m_extent,           {}))
+    , m_mip_levels      (std::exchange(other.m_mip_levels,       0))
+    , m_array_layers    (std::exchange(other.m_array_layers,     0))
 {}
 
 Texture& Texture::operator = (Texture&& other) noexcept
 {
     if (this != &other)
     {
-        std::swap(m_handle,     other.m_handle);
-        std::swap(m_view,       other.m_view);
-        std::swap(m_sampler,    other.m_sampler);
-        std::swap(m_allocation, other.m_allocation);
-        std::swap(m_allocator,  other.m_allocator);
+        std::swap(m_handle,           other.m_handle);
+        std::swap(m_view,             other.m_view);
+        std::swap(m_sampler,          other.m_sampler);
+        std::swap(m_allocation,       other.m_allocation);
+        std::swap(m_allocator,        other.m_allocator);
+        std::swap(m_heap,             other.m_heap);
+        std::swap(m_descriptor_index, other.m_descriptor_index);
+        std::swap(m_format,           other.m_format);
+        std::swap(m_extent,           other.m_extent);
+        std::swap(m_mip_levels,       other.m_mip_levels);
+        std::swap(m_array_layers,     other.m_array_layers);
     }
     return *this;
 }
 
 Texture::~Texture()
 {
-    if (m_view || m_sampler)
+    if (m_heap)
+    {
+        m_heap->release_texture(m_descriptor_index);
+        m_heap             = nullptr;
+        m_descriptor_index = DescriptorHeap::INVALID_INDEX;
+    }
+
+    if (m_view)
     {
         VmaAllocatorInfo allocator_info;
         vmaGetAllocatorInfo(m_allocator, &allocator_info);
 
         vkDestroyImageView(allocator_info.device, m_view, nullptr);
-        vkDestroySampler(allocator_info.device, m_sampler, nullptr);
-        m_view    = nullptr;
-        m_sampler = nullptr;
+        m_view = nullptr;
     }
+    m_sampler = nullptr;
 
     if (m_handle)
     {
@@ -2,18 +2,41 @@
 
 #include "Graphics/Vulkan/Vulkan.hpp"
 #include "Graphics/Vulkan/Allocator.hpp"
+#include "Graphics/Vulkan/SamplerCache.hpp"
 
 #include "Crunch/ClassUtility.hpp"
 
+#include <bit>
+
 namespace Cr::Graphics::Vulkan
 {
 
+class DescriptorHeap;
+
+struct TextureDescription
+{
+    VkFormat   format = VK_FORMAT_UNDEFINED;
+    VkExtent3D extent = { 1, 1, 1 }; // Depth above 1 makes a 3D texture
+
+    U32  mip_levels   = 1;
+    U32  array_layers = 1;     // Cubes per array for cubemaps
+    bool cubemap      = false; // Six layers per array layer, in +X -X +Y -Y +Z -Z order
+
+    VkImageUsageFlags usage = 0; // On top of transfer destination and sampled
+
+    SamplerDescription sampler {}; // Resolved through the API sampler cache
+};
+
 class Texture : public NoCopy
 {
     public:
         Texture() = default;
 
-        Texture(VmaAllocator allocator, VkFormat format, VkExtent3D extent);
+        // Registered in the heap when given one, the index stays valid for the lifetime of the texture. The view
+        // type follows the description, shaders have to declare the heap slot with the matching sampler type.
+        // The sampler is shared and not owned, it has to outlive the texture (see SamplerCache).
+        Texture(VmaAllocator allocator, const TextureDescription& description, VkSampler sampler, Vulkan::DescriptorHeap* heap = nullptr);
+        Texture(VmaAllocator allocator, VkFormat format, VkExtent3D extent, VkSampler sampler, Vulkan::DescriptorHeap* heap = nullptr);
         ~Texture();
 
         Texture(Texture&& other) noexcept;
@@ -23,13 +46,34 @@ class Texture : public NoCopy
         [[nodiscard]] constexpr const VkImageView& get_view()    const { return m_view;    }
         [[nodiscard]] constexpr const VkSampler&   get_sampler() const { return m_sampler; }
 
+        [[nodiscard]] constexpr U32 get_descriptor_index() const { return m_descriptor_index; } // Into the heap texture array
+
+        [[nodiscard]] constexpr VkFormat   get_format()       const { return m_format;       }
+        [[nodiscard]] constexpr VkExtent3D get_extent()       const { return m_extent;       }
+        [[nodiscard]] constexpr U32        get_mip_levels()   const { return m_mip_levels;   }
+        [[nodiscard]] constexpr U32        get_array_layers() const { return m_array_layers; } // Faces count as layers
+
+        // Levels down to 1x1x1
+        [[nodiscard]] static constexpr U32 get_full_mip_levels(VkExtent3D extent)
+        {
+            return std::bit_width(std::max({ extent.width, extent.height, extent.depth, 1u }));
+        }
+
     private:
         VkImage     m_handle  = nullptr;
         VkImageView m_view    = nullptr;
-        VkSampler   m_sampler = nullptr;
+        VkSampler   m_sampler = nullptr; // Shared
 
         VmaAllocation m_allocation = nullptr;
         VmaAllocator  m_allocator  = nullptr;
+
+        Vulkan::DescriptorHeap* m_heap             = nullptr;
+        U32                     m_descriptor_index = ~0u;
+
+        VkFormat   m_format       = VK_FORMAT_UNDEFINED;
+        VkExtent3D m_extent       = {};
+        U32        m_mip_levels   = 0;
+        U32        m_array_layers = 0;
 };
 
 }
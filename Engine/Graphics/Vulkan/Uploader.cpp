@@ -0,0 +1,297 @@
+#include "Graphics/Vulkan/Uploader.hpp"
+
+#include "Graphics/Vulkan/Queue.hpp"
+#include "Graphics/Vulkan/Texture.hpp"
+
+#include <cstring>
+
+namespace Cr::Graphics::Vulkan
+{
+
+static constexpr U64 STAGING_ALIGNMENT = 16; // Satisfies texel block and the 4 byte buffer to image offset rules
+
+static constexpr U64 align_up(U64 value, U64 alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+Uploader::Uploader(VmaAllocator allocator, Vulkan::Queue& queue, U32 consumer_family, U64 capacity)
+    : m_capacity(capacity)
+    , m_queue_family(queue.get_family_index())
+    , m_consumer_family(consumer_family)
+    , m_queue(&queue)
+{
+    VmaAllocatorInfo allocator_info;
+    vmaGetAllocatorInfo(allocator, &allocator_info);
+
+    m_device = allocator_info.device;
+
+    m_ring   = create_unique<Vulkan::Buffer>(allocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_capacity, HostAccess::SequentialWrite);
+    m_mapped = static_cast<U8*>(m_ring->get_mapped());
+
+    CR_ASSERT_THROW(m_mapped != nullptr, "Staging ring is not host visible");
+}
+
+Uploader::~Uploader()
+{
+    if (m_device)
+    {
+        flush();
+        wait_for_idle();
+
+        m_free.clear();
+        m_ring = {};
+        m_device = VK_NULL_HANDLE;
+    }
+}
+
+void Uploader::copy_to_buffer(const void* data, U64 size, Vulkan::Buffer& destination, U64 destination_offset)
+{
+    const U64 offset = allocate(size, STAGING_ALIGNMENT);
+
+    std::memcpy(m_mapped + offset, data, size);
+    m_ring->flush(offset, size);
+
+    const VkBufferCopy copy {
+        .srcOffset = offset,
+        .dstOffset = destination_offset,
+        .size      = size,
+    };
+
+    begin_batch().command_buffer->copy_buffer(*m_ring, destination, {&copy, 1});
+
+    if (transfers_ownership())
+    {
+        m_buffer_releases.push_back({
+            .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_NONE,
+            .srcQueueFamilyIndex = m_queue_family,
+            .dstQueueFamilyIndex = m_consumer_family,
+            .buffer              = destination.get_native(),
+            .offset              = destination_offset,
+            .size                = size,
+        });
+    }
+}
+
+void Uploader::copy_to_texture(const void*                        data,
+                               U64                                size,
+                               Vulkan::Texture&                   destination,
+                               std::span<const VkBufferImageCopy> regions,
+                               VkImageLayout                      final_layout)
+{
+    const U64 offset = allocate(size, STAGING_ALIGNMENT);
+
+    std::memcpy(m_mapped + offset, data, size);
+    m_ring->flush(offset, size);
+
+    std::vector<VkBufferImageCopy> staged_regions(regions.begin(), regions.end());
+    for (auto& region : staged_regions)
+    {
+        region.bufferOffset += offset;
+    }
+
+    auto& cmd = *begin_batch().command_buffer;
+
+    VkImageMemoryBarrier barrier {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_NONE,
+        .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED, // Previous contents are discarded
+        .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = destination.get_native(),
+        .subresourceRange
+        {
+            .aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel    = 0,
+            .levelCount      = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer  = 0,
+            .layerCount      = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+
+    cmd.pipeline_barrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, {&barrier, 1});
+
+    cmd.copy_buffer_to_texture(*m_ring, destination, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, staged_regions);
+
+    // Layout transition to final_layout, doubling as the release when ownership moves to the consumer
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = transfers_ownership() ? VK_ACCESS_NONE : VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout     = final_layout;
+
+    if (transfers_ownership())
+    {
+        barrier.srcQueueFamilyIndex = m_queue_family;
+        barrier.dstQueueFamilyIndex = m_consumer_family;
+    }
+
+    m_image_releases.push_back(barrier);
+}
+
+void Uploader::flush()
+{
+    if (!m_recording) { return; }
+
+    Batch& batch = *m_recording;
+    auto&  cmd   = *batch.command_buffer;
+
+    if (transfers_ownership())
+    {
+        cmd.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, {}, m_buffer_releases, m_image_releases);
+
+        // Same barriers from the consumer's point of view, the layout transition is only executed once
+        for (auto release : m_buffer_releases)
+        {
+            release.srcAccessMask = VK_ACCESS_NONE;
+            release.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+            m_buffer_acquires.push_back(release);
+        }
+
+        for (auto release : m_image_releases)
+        {
+            release.srcAccessMask = VK_ACCESS_NONE;
+            release.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            m_image_acquires.push_back(release);
+        }
+    }
+    else
+    {
+        // Make the copies visible to whatever executes after waiting on the ticket
+        const VkMemoryBarrier barrier {
+            .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+        };
+
+        cmd.pipeline_barrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, {&barrier, 1}, {}, m_image_releases);
+    }
+
+    m_buffer_releases.clear();
+    m_image_releases.clear();
+
+    cmd.end();
+
+    batch.ticket = m_queue->submit({&cmd.get_native(), 1});
+
+    batch.ring_end = m_head;
+    m_in_flight.push_back(std::move(m_recording));
+
+    m_unacquired_ticket = batch.ticket;
+
+    ++m_flush_count;
+}
+
+U64 Uploader::acquire(Vulkan::CommandBuffer& cmd)
+{
+    if (!m_buffer_acquires.empty() || !m_image_acquires.empty())
+    {
+        cmd.pipeline_barrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, {}, m_buffer_acquires, m_image_acquires);
+
+        m_buffer_acquires.clear();
+        m_image_acquires.clear();
+    }
+
+    return std::exchange(m_unacquired_ticket, 0);
+}
+
+void Uploader::wait_for_idle()
+{
+    while (!m_in_flight.empty())
+    {
+        retire(true);
+    }
+}
+
+U64 Uploader::allocate(U64 size, U64 alignment)
+{
+    CR_ASSERT_THROW(size <= m_capacity, "Upload of {} bytes exceeds staging ring capacity of {} bytes", size, m_capacity);
+
+    while (true)
+    {
+        U64 begin = align_up(m_head, alignment);
+
+        // Allocations never straddle the end of the ring
+        if ((begin % m_capacity) + size > m_capacity)
+        {
+            begin = align_up(begin + 1, m_capacity);
+        }
+
+        if (begin + size - m_tail <= m_capacity)
+        {
+            m_head = begin + size;
+            return begin % m_capacity;
+        }
+
+        // Full, reclaim finished batches and only block on the oldest one if none have finished
+        if (retire(false)) { continue; }
+
+        if (m_in_flight.empty())
+        {
+            if (!m_recording)
+            {
+                // Nothing in use, but the wrap padding didn't fit. Restart from the beginning of the ring.
+                m_head = m_tail = align_up(m_head, m_capacity);
+                continue;
+            }
+
+            flush();
+        }
+
+        retire(true);
+    }
+}
+
+bool Uploader::retire(bool wait_for_oldest)
+{
+    if (m_in_flight.empty()) { return false; }
+
+    if (wait_for_oldest)
+    {
+        m_queue->wait(m_in_flight.front()->ticket);
+    }
+
+    const U64 completed = m_queue->poll();
+
+    bool retired = false;
+
+    while (!m_in_flight.empty() && m_in_flight.front()->ticket <= completed)
+    {
+        m_tail = m_in_flight.front()->ring_end;
+        m_free.push_back(std::move(m_in_flight.front()));
+        m_in_flight.pop_front();
+
+        retired = true;
+    }
+
+    return retired;
+}
+
+Uploader::Batch& Uploader::begin_batch()
+{
+    if (m_recording) { return *m_recording; }
+
+    retire(false);
+
+    if (m_free.empty())
+    {
+        auto batch = create_unique<Batch>();
+
+        batch->command_buffer = m_queue->create_command_buffer();
+
+        m_recording = std::move(batch);
+    }
+    else
+    {
+        m_recording = std::move(m_free.back());
+        m_free.pop_back();
+
+        m_recording->command_buffer->reset(0);
+    }
+
+    m_recording->command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    return *m_recording;
+}
+
+} // namespace Cr::Graphics::Vulkan
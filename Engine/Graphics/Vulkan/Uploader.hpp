@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Graphics/Vulkan/Vulkan.hpp"
+#include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/CommandBuffer.hpp"
+
+#include "Crunch/ClassUtility.hpp"
+
+#include <deque>
+
+namespace Cr::Graphics::Vulkan
+{
+
+class Queue;
+class Texture;
+
+// Persistently mapped staging ring. Copies are batched into one command buffer per flush and the ring space
+// of a batch is reclaimed once its queue ticket completes, so the CPU only ever waits when the ring is full. When the upload queue belongs to another family than the consumer, every copy is released
+// to the consumer family on flush and the matching acquire is recorded by acquire() on the consumer side.
+// Not thread safe, owned and driven by the thread that runs the frame loop.
+class Uploader : public NoCopy
+{
+    public:
+        static constexpr U64 DEFAULT_CAPACITY = 64ull * 1024 * 1024;
+
+        Uploader() = default;
+        Uploader(VmaAllocator allocator, Vulkan::Queue& queue, U32 consumer_family, U64 capacity = DEFAULT_CAPACITY);
+        ~Uploader();
+
+        void copy_to_buffer(const void* data, U64 size, Vulkan::Buffer& destination, U64 destination_offset);
+
+        // Replaces the texture contents, region buffer offsets are relative to data. The texture is left in final_layout.
+        void copy_to_texture(const void*                        data,
+                             U64                                size,
+                             Vulkan::Texture&                   destination,
+                             std::span<const VkBufferImageCopy> regions,
+                             VkImageLayout                      final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        // Submits the current batch without waiting for it
+        void flush();
+
+        // Records the acquire side of every flushed upload not yet handed over to the consumer queue. The submission
+        // of cmd must wait on the returned ticket of get_queue(), 0 when there is nothing to wait for.
+        [[nodiscard]] U64 acquire(Vulkan::CommandBuffer& cmd);
+
+        // Blocks until every flushed batch has completed
+        void wait_for_idle();
+
+        [[nodiscard]] bool has_pending_copies() const { return m_recording != nullptr; }
+
+        // Batches submitted so far. Copies recorded now go out with batch get_flush_count(), they have been flushed
+        // once the count has moved past it.
+        [[nodiscard]] constexpr U64 get_flush_count() const { return m_flush_count; }
+
+        [[nodiscard]] constexpr Vulkan::Queue& get_queue() const { return *m_queue; }
+
+    private:
+        struct Batch
+        {
+            Unique<Vulkan::CommandBuffer> command_buffer;
+            U64 ticket   = 0;
+            U64 ring_end = 0;
+        };
+
+        [[nodiscard]] U64 allocate(U64 size, U64 alignment);
+
+        // Returns true if at least one batch was retired
+        bool retire(bool wait_for_oldest);
+
+        Batch& begin_batch();
+
+        [[nodiscard]] constexpr bool transfers_ownership() const { return m_queue_family != m_consumer_family; }
+
+        Unique<Vulkan::Buffer> m_ring;
+
+        U8* m_mapped   = nullptr;
+        U64 m_capacity = 0;
+
+        // Monotonic positions, modulo capacity gives the offset in the ring
+        U64 m_head = 0;
+        U64 m_tail = 0;
+
+        Unique<Batch>              m_recording;
+        std::deque<Unique<Batch>>  m_in_flight; // Submission order
+        std::vector<Unique<Batch>> m_free;
+
+        // Barriers applied once the copies of the recording batch are done
+        std::vector<VkBufferMemoryBarrier> m_buffer_releases;
+        std::vector<VkImageMemoryBarrier>  m_image_releases;
+
+        // Flushed but not yet acquired by the consumer
+        std::vector<VkBufferMemoryBarrier> m_buffer_acquires;
+        std::vector<VkImageMemoryBarrier>  m_image_acquires;
+        U64 m_unacquired_ticket = 0;
+
+        U64 m_flush_count = 0;
+
+        U32 m_queue_family    = 0;
+        U32 m_consumer_family = 0;
+
+        Vulkan::Queue* m_queue  = nullptr;
+        VkDevice       m_device = VK_NULL_HANDLE;
+};
+
+} // namespace Cr::Graphics::Vulkan
@@ -36,12 +36,12 @@ std::vector<VkExtensionProperties> get_physical_device_extension_properties(VkPh
     return extension_properties;
 }
 
-std::vector<VkQueueFamilyProperties> get_physical_device_queue_properties(VkPhysicalDevice physical_device)
+std::pmr::vector<VkQueueFamilyProperties> get_physical_device_queue_properties(VkPhysicalDevice physical_device, std::pmr::memory_resource* memory)
 {
     U32 property_count;
     vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &property_count, nullptr);
 
-    std::vector<VkQueueFamilyProperties> properties(property_count);
+    std::pmr::vector<VkQueueFamilyProperties> properties(property_count, memory);
     vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &property_count, properties.data());
 
     return properties;
@@ -2,6 +2,8 @@
 
 #include "Graphics/Graphics.hpp"
 
+#include "Crunch/Memory.hpp"
+
 #include <vulkan/vulkan.h>
 
 #define VK_ASSERT_THROW(RESULT, ...) CR_ASSERT_THROW(((RESULT) >= 0), __VA_ARGS__)
@@ -13,7 +15,7 @@ namespace Cr::Graphics::Vulkan
 std::vector<VkLayerProperties>       get_instance_layer_properties();
 std::vector<VkPhysicalDevice>        get_physical_devices(VkInstance instance);
 std::vector<VkExtensionProperties>   get_physical_device_extension_properties(VkPhysicalDevice physical_device);
-std::vector<VkQueueFamilyProperties> get_physical_device_queue_properties(VkPhysicalDevice physical_device);
+std::pmr::vector<VkQueueFamilyProperties> get_physical_device_queue_properties(VkPhysicalDevice physical_device, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
 const char* to_string(VkFormat format);
 const char* to_string(VkResult result);
@@ -1,24 +1,33 @@
 #include "Crunch/Crunch.hpp"
 #include "Crunch/Math.hpp"
+#include "Crunch/BatchMath.hpp"
 
 #include "Core/Window.hpp"
 #include "Core/Input.hpp"
+#include "Core/Jobs.hpp"
 
 #include "Graphics/Vulkan/API.hpp"
+#include "Graphics/AssetLoader.hpp"
+#include "Graphics/Culling.hpp"
 #include "Graphics/Mesh.hpp"
 
-#include "Crunch/Filesystem.hpp"
+#include "Scene/World.hpp"
+#include "Scene/Transform.hpp"
+#include "Scene/TransformHierarchy.hpp"
 
 // Temp headers and values
 #include <glm/gtx/rotate_vector.hpp>
-#include <ktx.h>
 
+#include <chrono>
 #include <iostream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 int main(int argc, char *argv[])
 {
-    (void)argc;
-    (void)argv;
+    // Draws the instanced cubes one by one with push constants, to compare against instancing
+    const bool draw_individually = argc > 1 && std::string_view(argv[1]) == "--individual";
 
     using namespace Cr;
     using namespace Cr::Graphics;
@@ -35,241 +44,169 @@ int main(int argc, char *argv[])
         Cr::Core::Window window { WINDOW_WIDTH, WINDOW_HEIGHT, "Crunch" };
         Cr::Core::Input  input  { window.get_native() };
 
+        Cr::Core::JobSystem jobs { std::max(1u, std::thread::hardware_concurrency()) - 1 };
+
         Cr::Graphics::Vulkan::API vk { window };
 
+        auto shader_compiler = vk.create_shader_compiler(jobs);
+
+        // ASSETS, read, decoded and uploaded in the background while the mesh is set up
+
+        Cr::Graphics::AssetLoader assets { vk, jobs };
+
+        const Cr::Graphics::AssetID vert_asset           = assets.load_shader_module("Assets/Shaders/triangle.vert.spv",  VK_SHADER_STAGE_VERTEX_BIT);
+        const Cr::Graphics::AssetID frag_asset           = assets.load_shader_module("Assets/Shaders/triangle.frag.spv",  VK_SHADER_STAGE_FRAGMENT_BIT);
+        const Cr::Graphics::AssetID indirect_vert_asset  = assets.load_shader_module("Assets/Shaders/indirect.vert.spv",  VK_SHADER_STAGE_VERTEX_BIT);
+        const Cr::Graphics::AssetID indirect_frag_asset  = assets.load_shader_module("Assets/Shaders/indirect.frag.spv",  VK_SHADER_STAGE_FRAGMENT_BIT);
+        const Cr::Graphics::AssetID cull_asset           = assets.load_shader_module("Assets/Shaders/cull.comp.spv",      VK_SHADER_STAGE_COMPUTE_BIT);
+        const Cr::Graphics::AssetID downsample_asset     = assets.load_shader_module("Assets/Shaders/downsample.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+        const Cr::Graphics::AssetID instanced_vert_asset = assets.load_shader_module("Assets/Shaders/instanced.vert.spv", VK_SHADER_STAGE_VERTEX_BIT);
+        const Cr::Graphics::AssetID texture_asset        = assets.load_texture("Assets/Textures/T_CrunchLogo_D.ktx2");
+
         // MESH 
 
         const auto vertices = get_cube_vertices(1.0f, 0);
         const auto indices  = get_cube_indices(0);
 
-        const VkDeviceSize vertices_size = sizeof(vertices[0]) * vertices.size();
-        const VkDeviceSize indices_size  = sizeof(indices[0])  * indices.size();
+        const auto cube_mesh = vk.create_mesh(vertices.data(), sizeof(vertices[0]) * vertices.size(), indices);
 
-        const auto vertices_buffer = vk.create_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, vertices_size);
-        const auto indices_buffer  = vk.create_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT  | VK_BUFFER_USAGE_TRANSFER_DST_BIT, indices_size);
+        const U32 mesh_index_count = vk.get(cube_mesh).index_count;
 
-        const U32 mesh_index_count = indices.size();
+        auto& uploader = vk.get_uploader();
 
-        {
-        
-            // TODO Staging buffer reuse
-            auto vertices_staging = vk.create_buffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, vertices_size);
-            auto indices_staging  = vk.create_buffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, indices_size);
+        assets.wait_for_idle();
 
-            vertices_staging->set_data(vertices.data(), vertices_size, 0);
-            indices_staging->set_data(indices.data(),  indices_size,  0);
+        std::unordered_map<Cr::Graphics::AssetID, Cr::Graphics::LoadedAsset> loaded;
 
-            auto& queue = vk.get_command_queue(VK_QUEUE_TRANSFER_BIT);
-            CR_ASSERT(queue.get_family_index() == vk.get_command_queue(VK_QUEUE_GRAPHICS_BIT).get_family_index(), "Queue transfer for mesh uploads not implemented yet");
-
-            auto cmd = queue.create_command_buffer();
+        for (auto& asset : assets.take_completed())
+        {
+            const Cr::Graphics::AssetID id = asset.id;
+            loaded.emplace(id, std::move(asset));
+        }
 
-            cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        // SHADER
 
-            VkBufferCopy copy { .size = vertices_size };
-            cmd->copy_buffer(*vertices_staging, *vertices_buffer, {&copy, 1});
+        const std::array shader_modules = {
+            std::move(loaded.at(vert_asset).shader_module),
+            std::move(loaded.at(frag_asset).shader_module),
+        };
 
-            copy.size = indices_size;
-            cmd->copy_buffer(*indices_staging, *indices_buffer, {&copy, 1});
+        const std::array indirect_shader_modules = {
+            std::move(loaded.at(indirect_vert_asset).shader_module),
+            std::move(loaded.at(indirect_frag_asset).shader_module),
+        };
 
-            cmd->end();
+        const auto cull_shader_module       = std::move(loaded.at(cull_asset).shader_module);
+        const auto downsample_shader_module = std::move(loaded.at(downsample_asset).shader_module);
+        const auto instanced_vert_module    = std::move(loaded.at(instanced_vert_asset).shader_module);
 
-            const VkSubmitInfo submission {
-                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                .commandBufferCount = 1,
-                .pCommandBuffers = &cmd->get_native(),
-            };
+        // Compiles on the workers, modules must outlive the compilation
+        const auto compiled_shader = shader_compiler->compile({
+            .bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .modules    = { shader_modules[0].get(), shader_modules[1].get() },
+        });
 
-            queue.submit({&submission, 1}, nullptr);
+        const auto compiled_indirect_shader = shader_compiler->compile({
+            .bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .modules    = { indirect_shader_modules[0].get(), indirect_shader_modules[1].get() },
+        });
 
-            // TODO Handle with fence or semaphore 
-            queue.wait_for_idle();
-        }
+        const auto compiled_cull_shader = shader_compiler->compile({
+            .bind_point = VK_PIPELINE_BIND_POINT_COMPUTE,
+            .modules    = { cull_shader_module.get() },
+        });
 
-        // TEXTURE
+        const auto compiled_downsample_shader = shader_compiler->compile({
+            .bind_point = VK_PIPELINE_BIND_POINT_COMPUTE,
+            .modules    = { downsample_shader_module.get() },
+        });
 
-        Cr::Unique<Cr::Graphics::Vulkan::Texture> texture {};
-        {
-            ktxTexture2* ktx_texture;
-
-            CR_ASSERT_THROW(ktxTexture2_CreateFromNamedFile("Assets/Textures/T_CrunchLogo_D.ktx2", KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx_texture) == KTX_SUCCESS, "Failed to load ktx image");
-            CR_DEFER { ktxTexture_Destroy(ktxTexture(ktx_texture)); };
-
-            const ktx_uint8_t* data = ktxTexture_GetData(ktxTexture(ktx_texture));
-            const ktx_size_t   size = ktxTexture_GetDataSize(ktxTexture(ktx_texture));
-
-            texture = vk.create_texture(static_cast<VkFormat>(ktx_texture->vkFormat), {ktx_texture->baseWidth, ktx_texture->baseHeight, ktx_texture->baseDepth});
-
-            auto texture_staging = vk.create_buffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size);
-
-            texture_staging->set_data(data, size, 0);
-
-            auto& queue = vk.get_command_queue(VK_QUEUE_TRANSFER_BIT);
-            CR_ASSERT(queue.get_family_index() == vk.get_command_queue(VK_QUEUE_GRAPHICS_BIT).get_family_index(), "Queue transfer for mesh uploads not implemented yet");
-
-            auto cmd = queue.create_command_buffer();
-
-            cmd->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-            { 
-                VkImageMemoryBarrier image_memory_barrier {
-                    .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                    .pNext               = nullptr,
-                    .srcAccessMask       = VK_ACCESS_NONE,                       // Wait for these accesses...
-                    .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,         // ...and before these ones... 
-                    .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED,            // ...change layout...
-                    .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // ...to this!
-                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                    .image               = texture->get_native(),
-                    .subresourceRange
-                    {
-                        .aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT,
-                        .baseMipLevel    = 0,
-                        .levelCount      = ktx_texture->numLevels,
-                        .baseArrayLayer  = 0,
-                        .layerCount      = ktx_texture->numLayers,
-                    },
-                };
+        const auto compiled_instanced_shader = shader_compiler->compile({
+            .bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .modules    = { instanced_vert_module.get(), indirect_shader_modules[1].get() },
+        });
 
-                cmd->pipeline_barrier(
-                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    0,
-                    {}, {}, {&image_memory_barrier, 1}
-                );
-            }
+        // TEXTURE, copied by the uploader and usable with every mip level from the first frame on
 
-            VkBufferImageCopy copy { 
-                .bufferOffset      = 0,
-                .bufferRowLength   = 0,
-                .bufferImageHeight = 0,
-                .imageSubresource  = {
-                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .layerCount = 1,
-                },
-                .imageExtent       = {
-                    .width  = ktx_texture->baseWidth,
-                    .height = ktx_texture->baseHeight,
-                    .depth  = ktx_texture->baseDepth,
-                }
-            };
+        const Cr::Graphics::Vulkan::TextureHandle texture = loaded.at(texture_asset).texture;
 
-            cmd->copy_buffer_to_texture(*texture_staging, *texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {&copy, 1});
-
-            { 
-                VkImageMemoryBarrier image_memory_barrier {
-                    .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                    .pNext               = nullptr,
-                    .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
-                    .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
-                    .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    .newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, // TODO QUEUE FAMILIES
-                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, // TODO QUEUE FAMILIES
-                    .image               = texture->get_native(),
-                    .subresourceRange
-                    {
-                        .aspectMask      = VK_IMAGE_ASPECT_COLOR_BIT,
-                        .baseMipLevel    = 0,
-                        .levelCount      = ktx_texture->numLevels,
-                        .baseArrayLayer  = 0,
-                        .layerCount      = ktx_texture->numLayers,
-                    },
-                };
+        const U32 texture_index = vk.get(texture).get_descriptor_index();
 
-                cmd->pipeline_barrier(
-                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                    0,
-                    {}, {}, {&image_memory_barrier, 1}
-                );
-            }
+        // GPU DRIVEN FIELD OF CUBES, culled and drawn without per instance CPU work
 
-            cmd->end();
+        constexpr U32 FIELD_SIZE    = 320; // 100k instances
+        constexpr F32 FIELD_SPACING = 2.0f;
 
-            const VkSubmitInfo submission {
-                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                .commandBufferCount = 1,
-                .pCommandBuffers = &cmd->get_native(),
+        auto indirect_batch = vk.create_indirect_batch(FIELD_SIZE * FIELD_SIZE, 1);
+        {
+            const Cr::Graphics::GPUMesh cube_mesh {
+                .index_count   = mesh_index_count,
+                .first_index   = 0,
+                .vertex_offset = 0,
             };
 
-            queue.submit({&submission, 1}, nullptr);
-
-            // TODO Handle with fence or semaphore 
-            queue.wait_for_idle();
-        }
-
+            std::vector<Cr::Graphics::GPUInstance> instances;
+            instances.reserve(FIELD_SIZE * FIELD_SIZE);
 
-        Cr::Unique<Cr::Graphics::Vulkan::Shader> shader {};
+            for (U32 z = 0; z < FIELD_SIZE; ++z)
+            {
+                for (U32 x = 0; x < FIELD_SIZE; ++x)
+                {
+                    const Cr::Vec3f position {
+                        (F32(x) - F32(FIELD_SIZE) / 2) * FIELD_SPACING,
+                        -2.0f,
+                        (F32(z) - F32(FIELD_SIZE) / 2) * FIELD_SPACING,
+                    };
+
+                    instances.push_back({
+                        .model         = glm::translate(Cr::Mat4f{1.0f}, position),
+                        .bounds        = { 0.0f, 0.0f, 0.0f, std::sqrt(3.0f) / 2 }, // Unit cube
+                        .mesh_index    = 0,
+                        .texture_index = texture_index,
+                    });
+                }
+            }
 
-        // TODO In reality, all modules should be compiled first then assembled into pipelines under a single call
-        {
-            const auto vert_source = Cr::read_binary_file("Assets/Shaders/triangle.vert.spv");
-            const auto frag_source = Cr::read_binary_file("Assets/Shaders/triangle.frag.spv");
+            indirect_batch->set_meshes(uploader, {&cube_mesh, 1});
+            indirect_batch->set_instances(uploader, instances);
+        }
 
-            const std::array modules = {
-                vk.create_shader_module(vert_source, VK_SHADER_STAGE_VERTEX_BIT),
-                vk.create_shader_module(frag_source, VK_SHADER_STAGE_FRAGMENT_BIT)
-            };
+        // Submitted in one batch, the first frame takes ownership of everything
+        uploader.flush();
 
-            const std::array refs = { modules[0].get(), modules[1].get() };
-            shader = vk.create_shader(VK_PIPELINE_BIND_POINT_GRAPHICS, {refs});
-        }
 
-        // UNIFORM BUFFER FOR STATIC FRAME DATA
-        auto frame_uniform_buffer = vk.create_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(Cr::Graphics::UniformBufferObject));
+        // Other loading overlaps with compilation, only block once the shader is needed
+        shader_compiler->wait_for_idle();
+        const Cr::Graphics::Vulkan::Shader* shader          = compiled_shader.get();
+        const Cr::Graphics::Vulkan::Shader* indirect_shader = compiled_indirect_shader.get();
+        const Cr::Graphics::Vulkan::Shader* cull_shader     = compiled_cull_shader.get();
 
-        VkDescriptorSetAllocateInfo desc_info {
-            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-            .descriptorPool     = vk.m_descriptor_pool,
-            .descriptorSetCount = 1,
-            .pSetLayouts        = &shader->get_descriptor_set_layout(),
-        };
+        // Mips of the loaded textures are generated by the first frame, with compute from here on
+        vk.get_mip_generator().set_shader(compiled_downsample_shader.get());
 
-        VkDescriptorSet descriptor_set = nullptr;
-        VK_ASSERT_THROW(vkAllocateDescriptorSets(vk.m_device, &desc_info, &descriptor_set), "Failed to allocate descriptor set"); 
+        const Cr::Graphics::Vulkan::Shader* instanced_shader = compiled_instanced_shader.get();
 
-        VkDescriptorBufferInfo descriptor_buffer_info {
-            .buffer = frame_uniform_buffer->get_native(),
-            .offset = 0,
-            .range = sizeof(Cr::Graphics::UniformBufferObject),
-        };
+        // FRAME DATA, read by shaders through the descriptor heap
+        const auto frame_buffer       = vk.create_buffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(Cr::Graphics::UniformBufferObject), Cr::Graphics::Vulkan::HostAccess::SequentialWrite);
+        const U32  frame_buffer_index = vk.get(frame_buffer).get_descriptor_index();
 
-        VkDescriptorImageInfo descriptor_image_info {
-            .sampler     = texture->get_sampler(),
-            .imageView   = texture->get_view(),
-            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        };
+        // SCENE
 
-        std::array writes {
-            VkWriteDescriptorSet {
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = descriptor_set,
-                .dstBinding = 0,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .pBufferInfo = &descriptor_buffer_info,
-            },
-            VkWriteDescriptorSet {
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = descriptor_set,
-                .dstBinding = 1,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                .pImageInfo = &descriptor_image_info,
-            },
+        struct Spin
+        {
+            F32 velocity; // Radians per second around the up axis
         };
 
-        vkUpdateDescriptorSets(vk.m_device, writes.size(), writes.data(), 0, nullptr);
+        Cr::Scene::World              scene;
+        Cr::Scene::TransformHierarchy hierarchy;
 
-        // SCENE
-
-        Cr::Vec3f cube_position   { 1.0f, 0.0f, 0.0f };
-        // Cr::Vec3f sphere_position {-1.0f, 0.0f, 0.0f };
+        const U32 cube_node = hierarchy.add({ .translation = { 1.0f, 0.0f, 0.0f } });
+        const U32 moon_node = hierarchy.add({ .translation = { 0.0f, 0.0f, 1.5f }, .scale = Cr::Vec3f{ 0.25f } }, cube_node); // Orbits the cube
+        // const U32 sphere_node = hierarchy.add({ .translation = {-1.0f, 0.0f, 0.0f } });
 
-        auto cube_matrix   = glm::translate(Cr::Mat4f{1.0f}, cube_position);
-        //auto sphere_matrix = glm::translate(Cr::Mat4f{1.0f}, sphere_position);
+        (void)scene.create(Cr::Scene::HierarchyNode { cube_node }, Cr::Scene::WorldTransform {}, Spin { glm::radians(50.0f) });
+        (void)scene.create(Cr::Scene::HierarchyNode { moon_node }, Cr::Scene::WorldTransform {});
+        // (void)scene.create(Cr::Scene::HierarchyNode { sphere_node }, Cr::Scene::WorldTransform {}, Spin { glm::radians(-50.0f) });
 
         // CAMERA
 
@@ -284,6 +221,43 @@ int main(int argc, char *argv[])
 
         // Main Loop
 
+        // INSTANCED CUBES, transforms rewritten every frame
+
+        constexpr U32 SWARM_SIZE = 100; // 10k instances
+
+        auto instance_stream = vk.create_instance_stream(SWARM_SIZE * SWARM_SIZE);
+
+        std::vector<Cr::Mat4f> swarm_transforms(SWARM_SIZE * SWARM_SIZE);
+        std::vector<Cr::Mat4f> visible_swarm_transforms;
+        std::vector<U32>       visible_swarm;
+
+        // Translation, rotation and scale components, composed into swarm_transforms every frame
+        std::vector<F32> swarm_x(swarm_transforms.size()), swarm_y(swarm_transforms.size(), 4.0f), swarm_z(swarm_transforms.size());
+        std::vector<F32> swarm_rotation_y(swarm_transforms.size()), swarm_rotation_w(swarm_transforms.size());
+        std::vector<F32> swarm_zeros(swarm_transforms.size(), 0.0f), swarm_scale(swarm_transforms.size(), 0.5f);
+
+        // Cubes only spin in place, their bounding spheres never move
+        Cr::Graphics::FrustumCuller swarm_culler;
+
+        for (U32 z = 0; z < SWARM_SIZE; ++z)
+        {
+            for (U32 x = 0; x < SWARM_SIZE; ++x)
+            {
+                const Cr::Vec3f position { (F32(x) - F32(SWARM_SIZE) / 2), 4.0f, (F32(z) - F32(SWARM_SIZE) / 2) };
+
+                swarm_x[z * SWARM_SIZE + x] = position.x;
+                swarm_z[z * SWARM_SIZE + x] = position.z;
+
+                (void)swarm_culler.add(position, std::sqrt(3.0f) / 4); // Half sized cube
+            }
+        }
+
+        CR_INFO("CPU culling with the {} kernel", Cr::Graphics::FrustumCuller::get_kernel_name());
+        CR_INFO("CPU transforms with the {} kernel", Cr::get_batch_math_kernel_name());
+
+        U64 frame_count = 0;
+        std::chrono::nanoseconds recording_time {};
+
         F32 time = window.get_time();
 
         while (!window.should_close())
@@ -336,37 +310,140 @@ int main(int argc, char *argv[])
                 .projected_view = perspective_matrix * view_matrix
             };
 
-            const F32 rotation_velocity = 50.0f * time_delta;
+            scene.each<const Cr::Scene::HierarchyNode, const Spin>([&](const Cr::Scene::HierarchyNode& node, const Spin& spin)
+            {
+                Cr::Scene::LocalTransform local = hierarchy.get_local(node.node);
+                local.rotation = glm::normalize(local.rotation * glm::angleAxis(spin.velocity * time_delta, Cr::VEC3F_UP));
 
-            cube_matrix   = glm::rotate(cube_matrix,   glm::radians( rotation_velocity), Cr::VEC3F_UP);
-            //sphere_matrix = glm::rotate(sphere_matrix, glm::radians(-rotation_velocity), Cr::VEC3F_UP);
+                hierarchy.set_local(node.node, local);
+            });
 
-            Cr::Graphics::PushConstantObject instance_data {
-                .model = cube_matrix
-            };
+            // Only the spinning nodes and their subtrees are recomputed
+            hierarchy.update(jobs);
+            Cr::Scene::copy_world_transforms(scene, hierarchy, jobs);
             
+            for (U32 z = 0; z < SWARM_SIZE; ++z)
+            {
+                for (U32 x = 0; x < SWARM_SIZE; ++x)
+                {
+                    const F32 half_angle = (time + F32(x + z)) / 2;
+
+                    swarm_rotation_y[z * SWARM_SIZE + x] = std::sin(half_angle);
+                    swarm_rotation_w[z * SWARM_SIZE + x] = std::cos(half_angle);
+                }
+            }
+
+            Cr::compose_transforms({swarm_x, swarm_y, swarm_z},
+                                   {swarm_zeros, swarm_rotation_y, swarm_zeros, swarm_rotation_w},
+                                   {swarm_scale, swarm_scale, swarm_scale}, swarm_transforms);
+
+            swarm_culler.cull(frame_data.projected_view, visible_swarm, jobs);
+
+            visible_swarm_transforms.clear();
+            for (const U32 index : visible_swarm)
+            {
+                visible_swarm_transforms.push_back(swarm_transforms[index]);
+            }
+
             // RENDER PIPELINE
 
-            frame_uniform_buffer->set_data(&frame_data, sizeof(frame_data), 0);
+            const auto recording_start = std::chrono::steady_clock::now();
+
+            vk.get(frame_buffer).set_data(&frame_data, sizeof(frame_data), 0);
 
             auto& cmd = vk.begin_frame();
 
+            indirect_batch->cull(cmd, *cull_shader, frame_data.projected_view);
+
+            vk.begin_rendering();
+
+            // Every draw of the frame uses the cube
+            const auto& cube = vk.get(cube_mesh);
+
+            cmd.bind_vertex_buffer(vk.get(cube.vertex_buffer));
+            cmd.bind_index_buffer(vk.get(cube.index_buffer), VK_INDEX_TYPE_UINT32);
+
             cmd.bind_shader(*shader);
 
-            cmd.bind_vertex_buffer(*vertices_buffer);
-            cmd.bind_index_buffer(*indices_buffer, VK_INDEX_TYPE_UINT32);
+            scene.each<const Cr::Scene::WorldTransform>([&](const Cr::Scene::WorldTransform& transform)
+            {
+                const Cr::Graphics::PushConstantObject object_data {
+                    .model              = transform.matrix,
+                    .frame_buffer_index = frame_buffer_index,
+                    .texture_index      = texture_index,
+                };
 
-            cmd.bind_descriptor_set(*shader, descriptor_set);
+                cmd.push_constants(*shader, object_data);
+                cmd.draw_indexed(mesh_index_count, 1, 0, 0, 0);
+            });
 
-            cmd.push_constants(*shader, instance_data);
+            const std::array indirect_constants {
+                frame_buffer_index,
+                indirect_batch->get_instance_buffer().get_descriptor_index(),
+            };
+
+            cmd.bind_shader(*indirect_shader);
+            cmd.push_constants(*indirect_shader, indirect_constants.data(), sizeof(indirect_constants));
+            indirect_batch->draw(cmd);
+
+            if (draw_individually)
+            {
+                cmd.bind_shader(*shader);
+
+                for (const auto& transform : visible_swarm_transforms)
+                {
+                    const Cr::Graphics::PushConstantObject swarm_instance_data {
+                        .model              = transform,
+                        .frame_buffer_index = frame_buffer_index,
+                        .texture_index      = texture_index,
+                    };
+
+                    cmd.push_constants(*shader, swarm_instance_data);
+                    cmd.draw_indexed(mesh_index_count, 1, 0, 0, 0);
+                }
+            }
+            else
+            {
+                instance_stream->begin(vk.get_frame_index());
+                const U32 first_instance = instance_stream->write(visible_swarm_transforms);
+                instance_stream->end();
+
+                const std::array instanced_constants {
+                    frame_buffer_index,
+                    instance_stream->get_descriptor_index(),
+                    texture_index,
+                };
 
-            cmd.draw_indexed(mesh_index_count, 1, 0, 0, 0);
+                cmd.bind_shader(*instanced_shader);
+                cmd.push_constants(*instanced_shader, instanced_constants.data(), sizeof(instanced_constants));
+                cmd.draw_indexed(mesh_index_count, static_cast<U32>(visible_swarm_transforms.size()), 0, 0, first_instance);
+            }
 
             vk.end_frame();
+
+            recording_time += std::chrono::steady_clock::now() - recording_start;
+            ++frame_count;
+        }
+
+        {
+            const auto& stats = vk.get_command_queue(VK_QUEUE_GRAPHICS_BIT).get_wait_statistics();
+
+            using Milliseconds = std::chrono::duration<F64, std::milli>;
+
+            CR_INFO("{} swarm cubes drawn {}, {:.3f} ms of CPU recording per frame over {} frames",
+                swarm_transforms.size(), draw_individually ? "individually" : "instanced",
+                Milliseconds(recording_time).count() / F64(std::max<U64>(frame_count, 1)), frame_count);
+
+            CR_INFO("CPU blocked on the GPU in {} of {} waits, {:.2f} ms total, {:.2f} ms longest",
+                stats.blocked_count, stats.wait_count,
+                Milliseconds(stats.blocked_time).count(),
+                Milliseconds(stats.longest_block).count());
         }
 
-        vkDeviceWaitIdle(vk.m_device);
-        vkFreeDescriptorSets(vk.m_device, vk.m_descriptor_pool, 1, &descriptor_set);
+        // Released like any other resource, the API destroys whatever is still in flight when it shuts down
+        vk.destroy(std::move(instance_stream));
+        vk.destroy(std::move(indirect_batch));
+        vk.destroy(std::move(shader_compiler));
     }
     catch (std::exception& e)
     {
@@ -0,0 +1,15 @@
+#include "Scene/Transform.hpp"
+#include "Scene/World.hpp"
+
+namespace Cr::Scene
+{
+
+void update_world_transforms(World& world, Core::JobSystem& jobs)
+{
+    world.parallel_each<const LocalTransform, WorldTransform>(jobs, [](const LocalTransform& local, WorldTransform& global)
+    {
+        global.matrix = get_matrix(local);
+    });
+}
+
+} // namespace Cr::Scene
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/Math.hpp"
+
+namespace Cr::Core { class JobSystem; }
+
+namespace Cr::Scene
+{
+
+class World;
+
+struct LocalTransform
+{
+    Vec3f translation { 0.0f };
+    Quatf rotation    { 1.0f, 0.0f, 0.0f, 0.0f };
+    Vec3f scale       { 1.0f };
+};
+
+struct WorldTransform
+{
+    Mat4f matrix { 1.0f };
+};
+
+// translate * rotate * scale
+[[nodiscard]] inline Mat4f get_matrix(const LocalTransform& local)
+{
+    Mat4f matrix = glm::mat4_cast(local.rotation);
+
+    matrix[0] *= local.scale.x;
+    matrix[1] *= local.scale.y;
+    matrix[2] *= local.scale.z;
+    matrix[3]  = Vec4f(local.translation, 1.0f);
+
+    return matrix;
+}
+
+// WorldTransform from the LocalTransform of every entity holding both
+void update_world_transforms(World& world, Core::JobSystem& jobs);
+
+} // namespace Cr::Scene
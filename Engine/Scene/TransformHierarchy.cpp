@@ -0,0 +1,282 @@
+#include "Scene/TransformHierarchy.hpp"
+#include "Scene/World.hpp"
+
+#include "Core/Jobs.hpp"
+
+namespace Cr::Scene
+{
+
+U32 TransformHierarchy::add(const LocalTransform& local, U32 parent)
+{
+    const U32 depth = parent == INVALID_NODE ? 0 : get_node(parent).depth + 1;
+
+    U32 id;
+
+    if (m_free_nodes.empty())
+    {
+        id = static_cast<U32>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    else
+    {
+        id = m_free_nodes.back();
+        m_free_nodes.pop_back();
+    }
+
+    // Appended out of order, rebuild() moves it to its level
+    m_nodes[id] = {
+        .slot   = static_cast<U32>(m_local.size()),
+        .parent = parent,
+        .depth  = depth,
+        .alive  = true,
+        .marked = true,
+    };
+
+    m_local.push_back(local);
+    m_world.emplace_back(1.0f);
+    m_parent_slot.push_back(INVALID_NODE);
+    m_first_child.push_back(0);
+    m_child_count.push_back(0);
+    m_slot_node.push_back(id);
+    m_updated.push_back(0);
+
+    m_marked_nodes.push_back(id);
+    m_layout_dirty = true;
+
+    return id;
+}
+
+void TransformHierarchy::remove(U32 node)
+{
+    (void)get_node(node);
+
+    // Descendants are unreachable from the roots from now on and are dropped by rebuild()
+    m_nodes[node].alive = false;
+    m_layout_dirty = true;
+}
+
+void TransformHierarchy::set_local(U32 node, const LocalTransform& local)
+{
+    (void)get_node(node);
+
+    Node& data = m_nodes[node];
+    m_local[data.slot] = local;
+
+    if (!data.marked)
+    {
+        data.marked = true;
+        m_marked_nodes.push_back(node);
+    }
+}
+
+const LocalTransform& TransformHierarchy::get_local(U32 node) const
+{
+    return m_local[get_node(node).slot];
+}
+
+const Mat4f& TransformHierarchy::get_world(U32 node) const
+{
+    return m_world[get_node(node).slot];
+}
+
+U32 TransformHierarchy::get_parent(U32 node) const
+{
+    return get_node(node).parent;
+}
+
+void TransformHierarchy::update(Core::JobSystem& jobs, U32 batch_size)
+{
+    if (m_layout_dirty)
+    {
+        rebuild();
+    }
+
+    m_marked_levels.resize(m_level_count);
+
+    for (const U32 id : m_marked_nodes)
+    {
+        Node& node = m_nodes[id];
+
+        // Ids show up again when freed and reused before an update
+        if (!node.marked) { continue; }
+
+        node.marked = false;
+
+        if (node.slot != INVALID_NODE)
+        {
+            m_marked_levels[node.depth].push_back(node.slot);
+        }
+    }
+
+    m_marked_nodes.clear();
+    m_queue.clear();
+
+    // The queue holds one level after the other, a level is its marked nodes whose parent was not recomputed
+    // followed by the children of the previous level's recomputed nodes
+    U32 level_begin = 0;
+
+    for (U32 level = 0; level < m_level_count; ++level)
+    {
+        for (const U32 slot : m_marked_levels[level])
+        {
+            const U32 parent = m_parent_slot[slot];
+
+            if (parent == INVALID_NODE || m_updated[parent] == 0)
+            {
+                m_queue.push_back(slot);
+            }
+        }
+
+        m_marked_levels[level].clear();
+
+        const U32 level_end = static_cast<U32>(m_queue.size());
+
+        jobs.parallel_for(level_end - level_begin, batch_size, [this, level_begin](U32 begin, U32 end)
+        {
+            for (U32 i = level_begin + begin; i < level_begin + end; ++i)
+            {
+                const U32 slot   = m_queue[i];
+                const U32 parent = m_parent_slot[slot];
+
+                const Mat4f local = get_matrix(m_local[slot]);
+
+                m_world[slot]   = parent == INVALID_NODE ? local : m_world[parent] * local;
+                m_updated[slot] = 1;
+            }
+        });
+
+        for (U32 i = level_begin; i < level_end; ++i)
+        {
+            const U32 slot = m_queue[i];
+
+            for (U32 child = m_first_child[slot]; child < m_first_child[slot] + m_child_count[slot]; ++child)
+            {
+                m_queue.push_back(child);
+            }
+        }
+
+        level_begin = level_end;
+    }
+
+    for (const U32 slot : m_queue)
+    {
+        m_updated[slot] = 0;
+    }
+
+    m_updated_count = static_cast<U32>(m_queue.size());
+}
+
+const TransformHierarchy::Node& TransformHierarchy::get_node(U32 node) const
+{
+    CR_ASSERT(node < m_nodes.size() && m_nodes[node].alive, "Transform node {} does not exist", node);
+
+    return m_nodes[node];
+}
+
+void TransformHierarchy::rebuild()
+{
+    const U32 node_count = static_cast<U32>(m_nodes.size());
+
+    // Children of every node, grouped by parent id
+    std::vector<U32> child_offsets(node_count + 1, 0);
+
+    for (const Node& node : m_nodes)
+    {
+        if (node.alive && node.parent != INVALID_NODE) { ++child_offsets[node.parent + 1]; }
+    }
+
+    for (U32 id = 0; id < node_count; ++id)
+    {
+        child_offsets[id + 1] += child_offsets[id];
+    }
+
+    std::vector<U32> children(child_offsets.back());
+    std::vector<U32> cursors(child_offsets.begin(), child_offsets.end() - 1);
+
+    for (U32 id = 0; id < node_count; ++id)
+    {
+        const Node& node = m_nodes[id];
+
+        if (node.alive && node.parent != INVALID_NODE) { children[cursors[node.parent]++] = id; }
+    }
+
+    // Breadth first from the roots, nodes under a removed ancestor are never reached
+    std::vector<U32> order;
+    order.reserve(m_local.size());
+
+    for (U32 id = 0; id < node_count; ++id)
+    {
+        if (m_nodes[id].alive && m_nodes[id].parent == INVALID_NODE) { order.push_back(id); }
+    }
+
+    const std::size_t slot_count = m_local.size();
+
+    std::vector<U32> first_child;
+    std::vector<U32> child_count;
+
+    first_child.reserve(slot_count);
+    child_count.reserve(slot_count);
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const U32 id = order[i];
+
+        first_child.push_back(static_cast<U32>(order.size()));
+        order.insert(order.end(), children.begin() + child_offsets[id], children.begin() + child_offsets[id + 1]);
+        child_count.push_back(static_cast<U32>(order.size()) - first_child.back());
+    }
+
+    std::vector<U32> new_slots(node_count, INVALID_NODE);
+
+    std::vector<LocalTransform> local(order.size());
+    std::vector<Mat4f>          world(order.size());
+    std::vector<U32>            parent_slot(order.size());
+
+    for (U32 slot = 0; slot < order.size(); ++slot)
+    {
+        const Node& node = m_nodes[order[slot]];
+
+        new_slots[order[slot]] = slot;
+
+        local[slot]       = m_local[node.slot];
+        world[slot]       = m_world[node.slot];
+        parent_slot[slot] = node.parent == INVALID_NODE ? INVALID_NODE : new_slots[node.parent];
+    }
+
+    for (U32 id = 0; id < node_count; ++id)
+    {
+        Node& node = m_nodes[id];
+
+        if (new_slots[id] != INVALID_NODE)
+        {
+            node.slot = new_slots[id];
+        }
+        else if (node.slot != INVALID_NODE)
+        {
+            node = {};
+            m_free_nodes.push_back(id);
+        }
+    }
+
+    m_local       = std::move(local);
+    m_world       = std::move(world);
+    m_parent_slot = std::move(parent_slot);
+    m_first_child = std::move(first_child);
+    m_child_count = std::move(child_count);
+    m_slot_node   = std::move(order);
+
+    m_updated.assign(m_local.size(), 0);
+
+    m_level_count  = m_slot_node.empty() ? 0 : m_nodes[m_slot_node.back()].depth + 1;
+    m_layout_dirty = false;
+}
+
+void copy_world_transforms(World& world, const TransformHierarchy& hierarchy, Core::JobSystem& jobs)
+{
+    world.parallel_each<const HierarchyNode, WorldTransform>(jobs, [&hierarchy](const HierarchyNode& node, WorldTransform& global)
+    {
+        global.matrix = hierarchy.get_world(node.node);
+    });
+}
+
+} // namespace Cr::Scene
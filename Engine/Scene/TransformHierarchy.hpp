@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/Math.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include "Scene/Transform.hpp"
+
+namespace Cr::Core { class JobSystem; }
+
+namespace Cr::Scene
+{
+
+class World;
+
+// Parent child transforms kept as flat arrays in breadth first order, every depth level is contiguous and the
+// children of a node are adjacent in the next level. Changing a local transform marks the node, update() then only
+// recomputes the world matrices of marked nodes and their subtrees, one level after the other with every level
+// split across the job system.
+//
+// Nodes are identified by ids that stay valid until the node or one of its ancestors is removed. Adding and removing
+// nodes only flags the layout, it is rebuilt by the next update().
+class TransformHierarchy : public NoCopy, public NoMove
+{
+    public:
+        static constexpr U32 INVALID_NODE = ~0u;
+
+        TransformHierarchy() = default;
+        ~TransformHierarchy() = default;
+
+        [[nodiscard]] U32 add(const LocalTransform& local = {}, U32 parent = INVALID_NODE);
+
+        // Removes the node with its whole subtree
+        void remove(U32 node);
+
+        void set_local(U32 node, const LocalTransform& local);
+
+        [[nodiscard]] const LocalTransform& get_local(U32 node) const;
+
+        // As of the last update()
+        [[nodiscard]] const Mat4f& get_world(U32 node) const;
+
+        [[nodiscard]] U32 get_parent(U32 node) const;
+
+        void update(Core::JobSystem& jobs, U32 batch_size = 1024);
+
+        [[nodiscard]] U32 size() const { return static_cast<U32>(m_local.size()); }
+
+        // World matrices recomputed by the last update(), for profiling
+        [[nodiscard]] U32 get_updated_count() const { return m_updated_count; }
+
+    private:
+        struct Node
+        {
+            U32  slot   = INVALID_NODE;
+            U32  parent = INVALID_NODE;
+            U32  depth  = 0;
+            bool alive  = false;
+            bool marked = false;
+        };
+
+        [[nodiscard]] const Node& get_node(U32 node) const;
+
+        void rebuild();
+
+        std::vector<Node> m_nodes; // By id
+        std::vector<U32>  m_free_nodes;
+        std::vector<U32>  m_marked_nodes;
+
+        // By slot, breadth first
+        std::vector<LocalTransform> m_local;
+        std::vector<Mat4f>          m_world;
+        std::vector<U32>            m_parent_slot;
+        std::vector<U32>            m_first_child;
+        std::vector<U32>            m_child_count;
+        std::vector<U32>            m_slot_node;
+        std::vector<U8>             m_updated;
+
+        std::vector<std::vector<U32>> m_marked_levels; // Marked slots bucketed by depth during update()
+        std::vector<U32>              m_queue;         // Slots recomputed by the running update(), level by level
+
+        U32  m_level_count   = 0;
+        U32  m_updated_count = 0;
+        bool m_layout_dirty  = false;
+};
+
+// Links an entity to a hierarchy node
+struct HierarchyNode
+{
+    U32 node = TransformHierarchy::INVALID_NODE;
+};
+
+// WorldTransform from the hierarchy for every entity holding both it and a HierarchyNode
+void copy_world_transforms(World& world, const TransformHierarchy& hierarchy, Core::JobSystem& jobs);
+
+} // namespace Cr::Scene
@@ -0,0 +1,303 @@
+#include "Scene/World.hpp"
+
+#include <mutex>
+#include <new>
+
+namespace Cr::Scene
+{
+
+namespace
+{
+
+struct ComponentRegistry
+{
+    // Reserved up front so infos never move while other threads read them
+    ComponentRegistry() { infos.reserve(MAX_COMPONENTS); }
+
+    std::mutex                 mutex;
+    std::vector<ComponentInfo> infos;
+};
+
+ComponentRegistry& get_registry()
+{
+    static ComponentRegistry registry;
+    return registry;
+}
+
+constexpr U32 align_up(U32 value, U32 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+ComponentID Detail::register_component(U32 size, U32 alignment)
+{
+    auto& registry = get_registry();
+    std::lock_guard lock { registry.mutex };
+
+    CR_ASSERT_THROW(registry.infos.size() < MAX_COMPONENTS, "More than {} component types", MAX_COMPONENTS);
+
+    registry.infos.push_back({size, alignment});
+
+    return static_cast<ComponentID>(registry.infos.size() - 1);
+}
+
+const ComponentInfo& Detail::get_component_info(ComponentID id)
+{
+    return get_registry().infos[id];
+}
+
+Archetype::Archetype(ComponentMask mask) : m_mask(mask)
+{
+    U32 entity_size = sizeof(Entity);
+
+    for (ComponentMask bits = mask; bits != 0; bits &= bits - 1)
+    {
+        const ComponentID id = static_cast<ComponentID>(std::countr_zero(bits));
+
+        m_components.push_back(id);
+        entity_size += Detail::get_component_info(id).size;
+    }
+
+    // Start from the unpadded estimate and shrink until the aligned arrays fit
+    for (m_chunk_capacity = CHUNK_SIZE / entity_size; m_chunk_capacity > 0; --m_chunk_capacity)
+    {
+        U32 offset = sizeof(Entity) * m_chunk_capacity;
+
+        for (const ComponentID id : m_components)
+        {
+            const ComponentInfo& info = Detail::get_component_info(id);
+
+            offset = align_up(offset, info.alignment);
+            m_offsets[id] = offset;
+            offset += info.size * m_chunk_capacity;
+        }
+
+        if (offset <= CHUNK_SIZE) { break; }
+    }
+
+    CR_ASSERT_THROW(m_chunk_capacity > 0, "Components of archetype {:#x} take more than a {} byte chunk", mask, CHUNK_SIZE);
+}
+
+Archetype::~Archetype()
+{
+    for (const Chunk& chunk : m_chunks)
+    {
+        ::operator delete(chunk.data, std::align_val_t{CHUNK_ALIGNMENT});
+    }
+}
+
+U32 Archetype::allocate_row(Entity entity)
+{
+    if (m_chunks.empty() || m_chunks.back().count == m_chunk_capacity)
+    {
+        m_chunks.push_back({
+            .data  = static_cast<std::byte*>(::operator new(CHUNK_SIZE, std::align_val_t{CHUNK_ALIGNMENT})),
+            .count = 0,
+        });
+    }
+
+    Chunk& chunk = m_chunks.back();
+    get_entities(chunk)[chunk.count++] = entity;
+
+    return m_count++;
+}
+
+Entity Archetype::remove_row(U32 row)
+{
+    CR_ASSERT(row < m_count, "Archetype row {} out of range", row);
+
+    const U32 last = --m_count;
+
+    Chunk& last_chunk = m_chunks.back();
+    --last_chunk.count;
+
+    Entity moved = INVALID_ENTITY;
+
+    if (row != last)
+    {
+        const Chunk& chunk = m_chunks[row / m_chunk_capacity];
+        const U32    index = row % m_chunk_capacity;
+
+        moved = get_entities(last_chunk)[last_chunk.count];
+        get_entities(chunk)[index] = moved;
+
+        for (const ComponentID id : m_components)
+        {
+            const U32 size = Detail::get_component_info(id).size;
+
+            std::memcpy(get_array(chunk, id) + size * index, get_array(last_chunk, id) + size * last_chunk.count, size);
+        }
+    }
+
+    if (last_chunk.count == 0)
+    {
+        ::operator delete(last_chunk.data, std::align_val_t{CHUNK_ALIGNMENT});
+        m_chunks.pop_back();
+    }
+
+    return moved;
+}
+
+std::byte* Archetype::get_component(U32 row, ComponentID component) const
+{
+    const Chunk& chunk = m_chunks[row / m_chunk_capacity];
+
+    return get_array(chunk, component) + Detail::get_component_info(component).size * (row % m_chunk_capacity);
+}
+
+World::World()
+{
+    m_empty_archetype = &get_archetype(0);
+}
+
+void World::destroy(Entity entity)
+{
+    CR_ASSERT(is_alive(entity), "Entity destroyed twice");
+
+    Record& record = m_records[entity.index];
+
+    const Entity moved = record.archetype->remove_row(record.row);
+
+    if (moved != INVALID_ENTITY)
+    {
+        m_records[moved.index].row = record.row;
+    }
+
+    record.archetype = nullptr;
+    ++record.generation;
+
+    m_free_indices.push_back(entity.index);
+    --m_alive_count;
+}
+
+bool World::is_alive(Entity entity) const
+{
+    return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation &&
+           m_records[entity.index].archetype != nullptr;
+}
+
+Archetype& World::get_archetype(ComponentMask mask)
+{
+    auto& archetype = m_archetypes[mask];
+
+    if (!archetype)
+    {
+        archetype = create_unique<Archetype>(mask);
+
+        for (auto& [query_mask, archetypes] : m_queries)
+        {
+            if ((mask & query_mask) == query_mask)
+            {
+                archetypes.push_back(archetype.get());
+            }
+        }
+    }
+
+    return *archetype;
+}
+
+Archetype& World::get_add_edge(Archetype& archetype, ComponentID component)
+{
+    Archetype*& edge = archetype.m_add_edges[component];
+
+    if (edge == nullptr)
+    {
+        edge = &get_archetype(archetype.get_mask() | (ComponentMask(1) << component));
+    }
+
+    return *edge;
+}
+
+Archetype& World::get_remove_edge(Archetype& archetype, ComponentID component)
+{
+    Archetype*& edge = archetype.m_remove_edges[component];
+
+    if (edge == nullptr)
+    {
+        edge = &get_archetype(archetype.get_mask() & ~(ComponentMask(1) << component));
+    }
+
+    return *edge;
+}
+
+const std::vector<Archetype*>& World::query(ComponentMask mask)
+{
+    const auto [it, inserted] = m_queries.try_emplace(mask);
+
+    if (inserted)
+    {
+        for (const auto& [archetype_mask, archetype] : m_archetypes)
+        {
+            if ((archetype_mask & mask) == mask)
+            {
+                it->second.push_back(archetype.get());
+            }
+        }
+    }
+
+    return it->second;
+}
+
+Entity World::allocate_entity(Archetype& archetype)
+{
+    Entity entity {};
+
+    if (m_free_indices.empty())
+    {
+        entity.index = static_cast<U32>(m_records.size());
+        m_records.emplace_back();
+    }
+    else
+    {
+        entity.index = m_free_indices.back();
+        m_free_indices.pop_back();
+    }
+
+    Record& record = m_records[entity.index];
+
+    entity.generation = record.generation;
+
+    record.archetype = &archetype;
+    record.row       = archetype.allocate_row(entity);
+
+    ++m_alive_count;
+
+    return entity;
+}
+
+void World::move_entity(Entity entity, Archetype& destination)
+{
+    Record& record = m_records[entity.index];
+    Archetype& source = *record.archetype;
+
+    const U32 row = destination.allocate_row(entity);
+
+    for (const ComponentID id : source.m_components)
+    {
+        if ((destination.get_mask() & (ComponentMask(1) << id)) != 0)
+        {
+            std::memcpy(destination.get_component(row, id), source.get_component(record.row, id), Detail::get_component_info(id).size);
+        }
+    }
+
+    const Entity moved = source.remove_row(record.row);
+
+    if (moved != INVALID_ENTITY)
+    {
+        m_records[moved.index].row = record.row;
+    }
+
+    record.archetype = &destination;
+    record.row       = row;
+}
+
+std::byte* World::get_component(Entity entity, ComponentID component) const
+{
+    const Record& record = m_records[entity.index];
+
+    return record.archetype->get_component(record.row, component);
+}
+
+} // namespace Cr::Scene
@@ -0,0 +1,345 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+#include "Crunch/ClassUtility.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+namespace Cr::Scene
+{
+
+static constexpr U32 CHUNK_SIZE      = 16 * 1024;
+static constexpr U32 CHUNK_ALIGNMENT = 64;
+static constexpr U32 MAX_COMPONENTS  = 64; // Bits of a ComponentMask
+
+using ComponentID   = U32;
+using ComponentMask = U64;
+
+// Plain data, moved between chunks with memcpy and never destructed
+template<typename T>
+concept Component = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T> &&
+                    !std::is_const_v<T> && !std::is_reference_v<T> && alignof(T) <= CHUNK_ALIGNMENT;
+
+struct Entity
+{
+    U32 index      = ~0u;
+    U32 generation = 0;
+
+    constexpr bool operator == (const Entity& other) const = default;
+};
+
+constexpr Entity INVALID_ENTITY {};
+
+struct ComponentInfo
+{
+    U32 size;
+    U32 alignment;
+};
+
+namespace Detail
+{
+    [[nodiscard]] ComponentID register_component(U32 size, U32 alignment);
+    [[nodiscard]] const ComponentInfo& get_component_info(ComponentID id);
+}
+
+// Ids are handed out on first use and are only stable within a run
+template<Component T>
+[[nodiscard]] ComponentID get_component_id()
+{
+    static const ComponentID id = Detail::register_component(sizeof(T), alignof(T));
+    return id;
+}
+
+template<typename... Ts>
+[[nodiscard]] ComponentMask get_component_mask()
+{
+    return (ComponentMask(0) | ... | (ComponentMask(1) << get_component_id<std::remove_const_t<Ts>>()));
+}
+
+// CHUNK_SIZE bytes holding up to the archetype chunk capacity of entities, the entity array comes first and is
+// followed by one array per component in id order
+struct Chunk
+{
+    std::byte* data  = nullptr;
+    U32        count = 0;
+};
+
+// Every entity with exactly the same set of components. Rows are packed, row r lives in chunk r / capacity and
+// every chunk but the last is full.
+class Archetype : public NoCopy, public NoMove
+{
+    public:
+        Archetype() = delete;
+        explicit Archetype(ComponentMask mask);
+        ~Archetype();
+
+        [[nodiscard]] constexpr ComponentMask get_mask()           const { return m_mask; }
+        [[nodiscard]] constexpr U32           get_chunk_capacity() const { return m_chunk_capacity; }
+        [[nodiscard]] constexpr U32           get_count()          const { return m_count; }
+
+        [[nodiscard]] std::span<const Chunk> get_chunks() const { return m_chunks; }
+
+        [[nodiscard]] Entity* get_entities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+
+        // Array of the component in the chunk, the component must be part of the archetype
+        [[nodiscard]] std::byte* get_array(const Chunk& chunk, ComponentID component) const { return chunk.data + m_offsets[component]; }
+
+    private:
+        friend class World;
+
+        [[nodiscard]] U32 allocate_row(Entity entity);
+
+        // Fills the row with the last one and returns the entity moved into it, INVALID_ENTITY if the row was last
+        [[nodiscard]] Entity remove_row(U32 row);
+
+        [[nodiscard]] std::byte* get_component(U32 row, ComponentID component) const;
+
+        ComponentMask m_mask = 0;
+
+        std::vector<ComponentID>              m_components;
+        std::array<U32, MAX_COMPONENTS>       m_offsets {};
+        std::vector<Chunk>                    m_chunks;
+
+        // Archetypes reached by adding or removing one component, filled on first use
+        std::array<Archetype*, MAX_COMPONENTS> m_add_edges    {};
+        std::array<Archetype*, MAX_COMPONENTS> m_remove_edges {};
+
+        U32 m_chunk_capacity = 0;
+        U32 m_count          = 0;
+};
+
+// Archetype based entity component storage. Components of an archetype are streamed chunk by chunk, queries walk
+// every archetype holding at least the requested components.
+//
+// Creating, destroying or changing the components of an entity invalidates component references and must not
+// happen during a query.
+class World : public NoCopy, public NoMove
+{
+    public:
+        World();
+        ~World() = default;
+
+        template<Component... Ts>
+        [[nodiscard]] Entity create(const Ts&... components);
+
+        void destroy(Entity entity);
+
+        [[nodiscard]] bool is_alive(Entity entity) const;
+
+        // Overwrites the component when the entity already has it
+        template<Component T>
+        void add(Entity entity, const T& component = {});
+
+        template<Component T>
+        void remove(Entity entity);
+
+        template<Component T>
+        [[nodiscard]] bool has(Entity entity) const;
+
+        template<Component T>
+        [[nodiscard]] T& get(Entity entity);
+
+        template<Component T>
+        [[nodiscard]] const T& get(Entity entity) const;
+
+        // function(std::span<const Entity>, std::span<Ts>...) for every chunk holding all of Ts, declare a
+        // component const to only read it
+        template<typename... Ts, typename F>
+        void each_chunk(F&& function);
+
+        // function(Ts&...) for every entity holding all of Ts
+        template<typename... Ts, typename F>
+        void each(F&& function);
+
+        // Same as above, chunks are split across the job system in batches of chunks_per_job
+        template<typename... Ts, typename F>
+        void parallel_each_chunk(Core::JobSystem& jobs, F&& function, U32 chunks_per_job = 4);
+
+        template<typename... Ts, typename F>
+        void parallel_each(Core::JobSystem& jobs, F&& function, U32 chunks_per_job = 4);
+
+        [[nodiscard]] U32 size() const { return m_alive_count; }
+
+    private:
+        struct Record
+        {
+            Archetype* archetype  = nullptr;
+            U32        row        = 0;
+            U32        generation = 0;
+        };
+
+        struct ChunkRef
+        {
+            const Archetype* archetype;
+            const Chunk*     chunk;
+        };
+
+        [[nodiscard]] Archetype& get_archetype(ComponentMask mask);
+        [[nodiscard]] Archetype& get_add_edge   (Archetype& archetype, ComponentID component);
+        [[nodiscard]] Archetype& get_remove_edge(Archetype& archetype, ComponentID component);
+
+        // Archetypes holding every component of the mask, kept up to date as archetypes are created
+        [[nodiscard]] const std::vector<Archetype*>& query(ComponentMask mask);
+
+        [[nodiscard]] Entity allocate_entity(Archetype& archetype);
+
+        // Moves the entity and the components both archetypes share, the others are left uninitialized
+        void move_entity(Entity entity, Archetype& destination);
+
+        [[nodiscard]] std::byte* get_component(Entity entity, ComponentID component) const;
+
+        template<typename... Ts, typename F>
+        static void invoke_chunk(const Archetype& archetype, const Chunk& chunk, F& function);
+
+        std::vector<Record> m_records;
+        std::vector<U32>    m_free_indices;
+
+        std::unordered_map<ComponentMask, Unique<Archetype>>       m_archetypes;
+        std::unordered_map<ComponentMask, std::vector<Archetype*>> m_queries;
+
+        Archetype* m_empty_archetype = nullptr;
+
+        U32 m_alive_count = 0;
+};
+
+template<Component... Ts>
+Entity World::create(const Ts&... components)
+{
+    const ComponentMask mask = get_component_mask<Ts...>();
+
+    CR_ASSERT(std::popcount(mask) == sizeof...(Ts), "Entity created with duplicate components");
+
+    const Entity entity = allocate_entity(get_archetype(mask));
+
+    (std::memcpy(get_component(entity, get_component_id<Ts>()), &components, sizeof(Ts)), ...);
+
+    return entity;
+}
+
+template<Component T>
+void World::add(Entity entity, const T& component)
+{
+    CR_ASSERT(is_alive(entity), "Component added to a destroyed entity");
+
+    const ComponentID id = get_component_id<T>();
+    Record& record = m_records[entity.index];
+
+    if ((record.archetype->get_mask() & (ComponentMask(1) << id)) == 0)
+    {
+        move_entity(entity, get_add_edge(*record.archetype, id));
+    }
+
+    std::memcpy(get_component(entity, id), &component, sizeof(T));
+}
+
+template<Component T>
+void World::remove(Entity entity)
+{
+    CR_ASSERT(is_alive(entity), "Component removed from a destroyed entity");
+
+    const ComponentID id = get_component_id<T>();
+    Record& record = m_records[entity.index];
+
+    if ((record.archetype->get_mask() & (ComponentMask(1) << id)) != 0)
+    {
+        move_entity(entity, get_remove_edge(*record.archetype, id));
+    }
+}
+
+template<Component T>
+bool World::has(Entity entity) const
+{
+    return is_alive(entity) && (m_records[entity.index].archetype->get_mask() & get_component_mask<T>()) != 0;
+}
+
+template<Component T>
+T& World::get(Entity entity)
+{
+    CR_ASSERT(has<T>(entity), "Entity is destroyed or has no such component");
+
+    return *reinterpret_cast<T*>(get_component(entity, get_component_id<T>()));
+}
+
+template<Component T>
+const T& World::get(Entity entity) const
+{
+    CR_ASSERT(has<T>(entity), "Entity is destroyed or has no such component");
+
+    return *reinterpret_cast<const T*>(get_component(entity, get_component_id<T>()));
+}
+
+template<typename... Ts, typename F>
+void World::invoke_chunk(const Archetype& archetype, const Chunk& chunk, F& function)
+{
+    function(std::span<const Entity>(archetype.get_entities(chunk), chunk.count),
+             std::span<Ts>(reinterpret_cast<Ts*>(archetype.get_array(chunk, get_component_id<std::remove_const_t<Ts>>())), chunk.count)...);
+}
+
+template<typename... Ts, typename F>
+void World::each_chunk(F&& function)
+{
+    static_assert((Component<std::remove_const_t<Ts>> && ...), "Queries take components, optionally const");
+
+    for (const Archetype* archetype : query(get_component_mask<Ts...>()))
+    {
+        for (const Chunk& chunk : archetype->get_chunks())
+        {
+            invoke_chunk<Ts...>(*archetype, chunk, function);
+        }
+    }
+}
+
+template<typename... Ts, typename F>
+void World::each(F&& function)
+{
+    each_chunk<Ts...>([&function](std::span<const Entity> entities, std::span<Ts>... components)
+    {
+        for (std::size_t i = 0; i < entities.size(); ++i)
+        {
+            function(components[i]...);
+        }
+    });
+}
+
+template<typename... Ts, typename F>
+void World::parallel_each_chunk(Core::JobSystem& jobs, F&& function, U32 chunks_per_job)
+{
+    static_assert((Component<std::remove_const_t<Ts>> && ...), "Queries take components, optionally const");
+
+    std::vector<ChunkRef> chunks;
+
+    for (const Archetype* archetype : query(get_component_mask<Ts...>()))
+    {
+        for (const Chunk& chunk : archetype->get_chunks())
+        {
+            chunks.push_back({archetype, &chunk});
+        }
+    }
+
+    jobs.parallel_for(static_cast<U32>(chunks.size()), chunks_per_job, [&](U32 begin, U32 end)
+    {
+        for (U32 i = begin; i < end; ++i)
+        {
+            invoke_chunk<Ts...>(*chunks[i].archetype, *chunks[i].chunk, function);
+        }
+    });
+}
+
+template<typename... Ts, typename F>
+void World::parallel_each(Core::JobSystem& jobs, F&& function, U32 chunks_per_job)
+{
+    parallel_each_chunk<Ts...>(jobs, [&function](std::span<const Entity> entities, std::span<Ts>... components)
+    {
+        for (std::size_t i = 0; i < entities.size(); ++i)
+        {
+            function(components[i]...);
+        }
+    }, chunks_per_job);
+}
+
+} // namespace Cr::Scene
@@ -0,0 +1,233 @@
+#include "Crunch/BatchMath.hpp"
+
+#include <random>
+
+// Every BatchMath kernel the CPU supports against the GLM functions it replaces. Counts cover empty input, inputs
+// shorter than a vector and every tail length of the SSE and AVX2 loops, so the scalar remainder runs after both.
+
+using namespace Cr;
+
+namespace
+{
+
+constexpr std::size_t COUNTS[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 11, 12, 13, 15, 16, 17, 31, 64, 1000, 1003 };
+constexpr std::size_t MAX_COUNT = 1003;
+
+constexpr F32 TOLERANCE = 1e-4f; // Relative to the magnitude of the expected value
+
+U32 g_failures = 0;
+
+bool is_close(F32 value, F32 expected)
+{
+    return std::abs(value - expected) <= TOLERANCE * std::max(1.0f, std::abs(expected));
+}
+
+void expect_close(const char* kernel, const char* test, std::size_t count, std::size_t index, F32 value, F32 expected)
+{
+    if (!is_close(value, expected))
+    {
+        CR_ERROR("{} {}, {} elements: element {} is {} instead of {}", kernel, test, count, index, value, expected);
+        ++g_failures;
+    }
+}
+
+struct Vec3Array
+{
+    std::vector<F32> x, y, z;
+
+    explicit Vec3Array(std::size_t count) : x(count), y(count), z(count) {}
+
+    [[nodiscard]] Vec3f get(std::size_t i) const { return { x[i], y[i], z[i] }; }
+
+    [[nodiscard]] Vec3Span get_span() const { return { x, y, z }; }
+
+    // Only the first count elements are written, the rest must stay untouched
+    [[nodiscard]] Vec3SpanOut get_span(std::size_t count) { return { { x.data(), count }, { y.data(), count }, { z.data(), count } }; }
+};
+
+struct Inputs
+{
+    Vec3Array translations { MAX_COUNT };
+    Vec3Array scales       { MAX_COUNT };
+    Vec3Array extents      { MAX_COUNT };
+
+    std::vector<F32> qx, qy, qz, qw;
+
+    explicit Inputs(std::mt19937& random)
+        : qx(MAX_COUNT), qy(MAX_COUNT), qz(MAX_COUNT), qw(MAX_COUNT)
+    {
+        std::uniform_real_distribution<F32> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<F32> scale(-4.0f, 4.0f);
+        std::uniform_real_distribution<F32> extent(0.0f, 10.0f);
+        std::normal_distribution<F32>       rotation;
+
+        for (std::size_t i = 0; i < MAX_COUNT; ++i)
+        {
+            translations.x[i] = position(random);
+            translations.y[i] = position(random);
+            translations.z[i] = position(random);
+
+            scales.x[i] = scale(random);
+            scales.y[i] = scale(random);
+            scales.z[i] = scale(random);
+
+            extents.x[i] = extent(random);
+            extents.y[i] = extent(random);
+            extents.z[i] = extent(random);
+
+            // Normally distributed components give uniformly distributed rotations once normalized
+            const Quatf q = glm::normalize(Quatf(rotation(random), rotation(random), rotation(random), rotation(random)));
+
+            qx[i] = q.x;
+            qy[i] = q.y;
+            qz[i] = q.z;
+            qw[i] = q.w;
+        }
+    }
+
+    [[nodiscard]] QuatSpan get_rotations() const { return { qx, qy, qz, qw }; }
+
+    [[nodiscard]] Quatf get_rotation(std::size_t i) const { return Quatf(qw[i], qx[i], qy[i], qz[i]); }
+};
+
+void test_compose_transforms(const char* kernel, const Inputs& inputs)
+{
+    for (const std::size_t count : COUNTS)
+    {
+        const Mat4f sentinel { 42.0f };
+
+        std::vector<Mat4f> matrices(count + 1, sentinel);
+
+        compose_transforms(inputs.translations.get_span(), inputs.get_rotations(), inputs.scales.get_span(), { matrices.data(), count });
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Mat4f expected = glm::translate(Mat4f { 1.0f }, inputs.translations.get(i)) *
+                                   glm::mat4_cast(inputs.get_rotation(i)) *
+                                   glm::scale(Mat4f { 1.0f }, inputs.scales.get(i));
+
+            for (U32 element = 0; element < 16; ++element)
+            {
+                expect_close(kernel, "compose_transforms", count, i, matrices[i][element / 4][element % 4], expected[element / 4][element % 4]);
+            }
+        }
+
+        if (matrices[count] != sentinel)
+        {
+            CR_ERROR("{} compose_transforms, {} elements: wrote past the end", kernel, count);
+            ++g_failures;
+        }
+    }
+}
+
+void test_transform_points(const char* kernel, const Inputs& inputs, const Mat4f& matrix)
+{
+    for (const std::size_t count : COUNTS)
+    {
+        Vec3Array results(count + 1);
+        results.x[count] = results.y[count] = results.z[count] = 42.0f;
+
+        transform_points(matrix, inputs.translations.get_span(), results.get_span(count));
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Vec3f expected = Vec3f(matrix * Vec4f(inputs.translations.get(i), 1.0f));
+
+            for (U32 axis = 0; axis < 3; ++axis)
+            {
+                expect_close(kernel, "transform_points", count, i, results.get(i)[axis], expected[axis]);
+            }
+        }
+
+        if (results.get(count) != Vec3f { 42.0f })
+        {
+            CR_ERROR("{} transform_points, {} elements: wrote past the end", kernel, count);
+            ++g_failures;
+        }
+    }
+}
+
+void test_transform_aabbs(const char* kernel, const Inputs& inputs, const Mat4f& matrix)
+{
+    for (const std::size_t count : COUNTS)
+    {
+        Vec3Array centers(count + 1);
+        Vec3Array extents(count + 1);
+        centers.x[count] = centers.y[count] = centers.z[count] = 42.0f;
+        extents.x[count] = extents.y[count] = extents.z[count] = 42.0f;
+
+        transform_aabbs(matrix, inputs.translations.get_span(), inputs.extents.get_span(), centers.get_span(count), extents.get_span(count));
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Tightest box around the eight transformed corners
+            Vec3f minimum { std::numeric_limits<F32>::max() };
+            Vec3f maximum { std::numeric_limits<F32>::lowest() };
+
+            for (U32 corner = 0; corner < 8; ++corner)
+            {
+                const Vec3f sign  { corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f };
+                const Vec3f point = Vec3f(matrix * Vec4f(inputs.translations.get(i) + sign * inputs.extents.get(i), 1.0f));
+
+                minimum = glm::min(minimum, point);
+                maximum = glm::max(maximum, point);
+            }
+
+            const Vec3f expected_center = (maximum + minimum) * 0.5f;
+            const Vec3f expected_extent = (maximum - minimum) * 0.5f;
+
+            for (U32 axis = 0; axis < 3; ++axis)
+            {
+                expect_close(kernel, "transform_aabbs center", count, i, centers.get(i)[axis], expected_center[axis]);
+                expect_close(kernel, "transform_aabbs extent", count, i, extents.get(i)[axis], expected_extent[axis]);
+            }
+        }
+
+        if (centers.get(count) != Vec3f { 42.0f } || extents.get(count) != Vec3f { 42.0f })
+        {
+            CR_ERROR("{} transform_aabbs, {} elements: wrote past the end", kernel, count);
+            ++g_failures;
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(1);
+
+    const Inputs inputs(random);
+
+    // Rotation, non uniform scale with a mirrored axis and translation
+    const Mat4f matrix = glm::translate(Mat4f { 1.0f }, Vec3f { 3.0f, -7.0f, 11.0f }) *
+                         glm::mat4_cast(glm::angleAxis(0.7f, glm::normalize(Vec3f { 1.0f, 2.0f, 3.0f }))) *
+                         glm::scale(Mat4f { 1.0f }, Vec3f { 2.0f, -0.5f, 1.5f });
+
+    for (const BatchMathKernel kernel : { BatchMathKernel::Scalar, BatchMathKernel::SSE, BatchMathKernel::AVX2 })
+    {
+        if (!is_batch_math_kernel_supported(kernel))
+        {
+            CR_WARN("Skipping a batch math kernel this CPU does not support");
+            continue;
+        }
+
+        set_batch_math_kernel(kernel);
+
+        const char* name = get_batch_math_kernel_name();
+
+        test_compose_transforms(name, inputs);
+        test_transform_points(name, inputs, matrix);
+        test_transform_aabbs(name, inputs, matrix);
+
+        CR_INFO("{} kernels tested", name);
+    }
+
+    if (g_failures != 0)
+    {
+        CR_ERROR("{} batch math results differ from GLM", g_failures);
+        return 1;
+    }
+
+    return 0;
+}
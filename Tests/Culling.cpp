@@ -0,0 +1,208 @@
+#include "Test.hpp"
+
+#include "Graphics/Culling.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <random>
+
+// Every FrustumCuller kernel the CPU supports, serial and split across the job system, against the scalar kernel.
+// Sphere counts cover every tail length of the SSE and AVX2 loops, so padding lanes are tested as well, and batch
+// sizes cover compaction moving ranges left and leaving them in place.
+
+using namespace Cr;
+using namespace Cr::Graphics;
+
+namespace
+{
+
+constexpr U32 COUNTS[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 100, 1003, 4099 };
+
+constexpr U32 BATCH_SIZES[] = { 1, 8, 20, 64, 1024 }; // Rounded up to whole lanes
+
+// Spheres closer than this to touching a plane may land on either side with FMA rounding
+constexpr F32 MARGIN = 1e-3f;
+
+struct Sphere
+{
+    Vec3f center;
+    F32   radius;
+};
+
+Mat4f get_projected_view()
+{
+    const Mat4f projection = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 100.0f);
+    const Mat4f view       = glm::lookAt(Vec3f(3.0f, 2.0f, 10.0f), Vec3f(0.0f), VEC3F_UP);
+
+    return projection * view;
+}
+
+// Distance of the surface past the plane the sphere is furthest outside of, negative when culled
+F32 get_clearance(const std::array<Vec4f, 6>& planes, const Sphere& sphere)
+{
+    F32 clearance = std::numeric_limits<F32>::infinity();
+
+    for (const Vec4f& plane : planes)
+    {
+        clearance = std::min(clearance, glm::dot(Vec3f(plane), sphere.center) + plane.w + sphere.radius);
+    }
+
+    return clearance;
+}
+
+std::vector<Sphere> make_spheres(U32 count, std::mt19937& random)
+{
+    std::uniform_real_distribution<F32> position(-120.0f, 120.0f);
+    std::uniform_real_distribution<F32> radius(0.0f, 8.0f);
+
+    std::vector<Sphere> spheres(count);
+
+    for (Sphere& sphere : spheres)
+    {
+        sphere = { { position(random), position(random), position(random) }, radius(random) };
+    }
+
+    return spheres;
+}
+
+void fill(FrustumCuller& culler, std::span<const Sphere> spheres)
+{
+    culler.clear();
+
+    for (const Sphere& sphere : spheres)
+    {
+        (void)culler.add(sphere.center, sphere.radius);
+    }
+}
+
+// Same indices as the scalar result in increasing order, except for spheres touching a plane within MARGIN
+void expect_matches(const char* kernel, const char* test, std::span<const Sphere> spheres, const std::vector<U32>& visible, const std::vector<U32>& expected)
+{
+    const auto planes = get_frustum_planes(get_projected_view());
+
+    CR_EXPECT(std::ranges::is_sorted(visible) && std::ranges::adjacent_find(visible) == visible.end(),
+              "{} {}, {} spheres: indices are not strictly increasing", kernel, test, spheres.size());
+
+    std::vector<U8> is_visible(spheres.size(), 0);
+
+    for (const U32 index : visible)
+    {
+        CR_EXPECT(index < spheres.size(), "{} {}, {} spheres: padding lane {} is visible", kernel, test, spheres.size(), index);
+
+        if (index < spheres.size()) { is_visible[index] = 1; }
+    }
+
+    std::vector<U8> is_expected(spheres.size(), 0);
+
+    for (const U32 index : expected)
+    {
+        is_expected[index] = 1;
+    }
+
+    for (std::size_t i = 0; i < spheres.size(); ++i)
+    {
+        if (is_visible[i] == is_expected[i] || std::abs(get_clearance(planes, spheres[i])) < MARGIN) { continue; }
+
+        CR_EXPECT(false, "{} {}, {} spheres: sphere {} is {} instead of {}", kernel, test, spheres.size(), i,
+                  is_visible[i] ? "visible" : "culled", is_expected[i] ? "visible" : "culled");
+    }
+}
+
+// Scalar results, checked against the plane test directly
+std::vector<U32> get_expected(FrustumCuller& culler, std::span<const Sphere> spheres)
+{
+    const auto planes = get_frustum_planes(get_projected_view());
+
+    FrustumCuller::set_kernel(SIMDLevel::Scalar);
+
+    std::vector<U32> visible;
+    culler.cull(get_projected_view(), visible);
+
+    std::vector<U32> direct;
+
+    for (U32 i = 0; i < spheres.size(); ++i)
+    {
+        if (get_clearance(planes, spheres[i]) >= 0.0f) { direct.push_back(i); }
+    }
+
+    expect_matches("scalar", "plane test", spheres, visible, direct);
+
+    return visible;
+}
+
+void test_kernel(SIMDLevel level, Core::JobSystem& jobs, std::span<const Sphere> spheres, const std::vector<U32>& expected, FrustumCuller& culler, const char* test)
+{
+    FrustumCuller::set_kernel(level);
+
+    std::vector<U32> visible;
+
+    culler.cull(get_projected_view(), visible);
+    expect_matches(to_string(level), test, spheres, visible, expected);
+
+    for (const U32 batch_size : BATCH_SIZES)
+    {
+        visible.assign(3, 12345); // Stale contents are replaced
+
+        culler.cull(get_projected_view(), visible, jobs, batch_size);
+        expect_matches(to_string(level), test, spheres, visible, expected);
+    }
+}
+
+void test_kernels(Core::JobSystem& jobs, std::span<const Sphere> spheres, const char* test)
+{
+    FrustumCuller culler;
+    fill(culler, spheres);
+
+    const std::vector<U32> expected = get_expected(culler, spheres);
+
+    for (const SIMDLevel level : { SIMDLevel::Scalar, SIMDLevel::SSE, SIMDLevel::AVX2 })
+    {
+        if (!is_simd_level_supported(level))
+        {
+            CR_WARN("Culling: {} is not supported by this CPU, skipped", to_string(level));
+            continue;
+        }
+
+        test_kernel(level, jobs, spheres, expected, culler, test);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    Core::JobSystem jobs(3);
+
+    std::mt19937 random(5);
+
+    for (const U32 count : COUNTS)
+    {
+        test_kernels(jobs, make_spheres(count, random), "random");
+
+        // Every sphere visible, batches compact in place
+        test_kernels(jobs, std::vector<Sphere>(count, Sphere { Vec3f(0.0f), 1.0f }), "all visible");
+
+        // Nothing visible, behind the camera
+        test_kernels(jobs, std::vector<Sphere>(count, Sphere { Vec3f(6.0f, 4.0f, 20.0f), 1.0f }), "none visible");
+    }
+
+    // Spheres moved with set() after being added, alternating visible and culled
+    std::vector<Sphere> spheres = make_spheres(37, random);
+
+    FrustumCuller culler;
+    fill(culler, spheres);
+
+    for (U32 i = 0; i < spheres.size(); ++i)
+    {
+        spheres[i] = i % 2 == 0 ? Sphere { Vec3f(0.0f), 0.5f } : Sphere { Vec3f(0.0f, 0.0f, 50.0f), 0.5f };
+        culler.set(i, spheres[i].center, spheres[i].radius);
+    }
+
+    const std::vector<U32> expected = get_expected(culler, spheres);
+
+    CR_EXPECT(expected.size() == 19, "{} of 19 moved spheres are visible", expected.size());
+
+    test_kernel(get_simd_level(), jobs, spheres, expected, culler, "moved");
+
+    return Test::get_result("Culling");
+}
@@ -0,0 +1,259 @@
+#include "Test.hpp"
+
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+#include "Graphics/Vulkan/Queue.hpp"
+
+#include <unordered_map>
+
+// Vulkan::DeletionQueue release rules on two queues: a resource is destroyed only once every tracked queue has
+// passed its ticket, resources pushed without a ticket are stamped by close_frame() and collect() only asks each
+// queue for its timeline once.
+//
+// The Vulkan calls a Queue makes are stubbed below, the test owns the timeline values and needs no device. The
+// engine is a static library, so these definitions take precedence over the loader's.
+
+using namespace Cr;
+using namespace Cr::Graphics;
+
+namespace
+{
+
+struct FakeDevice
+{
+    std::unordered_map<VkSemaphore, U64> timelines; // Completed value of every timeline semaphore
+    U64 next_handle = 1;
+    U32 poll_count  = 0;
+};
+
+FakeDevice g_device;
+
+VkDevice get_device() { return reinterpret_cast<VkDevice>(&g_device); }
+
+template<typename T>
+T make_handle() { return reinterpret_cast<T>(g_device.next_handle++ * 16); }
+
+void complete(const Vulkan::Queue& queue, U64 ticket)
+{
+    g_device.timelines[queue.get_timeline()] = ticket;
+}
+
+U64 submit(Vulkan::Queue& queue)
+{
+    return queue.submit({});
+}
+
+// Records its destruction, moved-from instances do not count
+struct Resource
+{
+    explicit Resource(U32& released) : released(&released) {}
+
+    Resource(Resource&& other) noexcept : released(std::exchange(other.released, nullptr)) {}
+
+    ~Resource()
+    {
+        if (released) { ++*released; }
+    }
+
+    U32* released;
+};
+
+void test_tickets()
+{
+    Vulkan::Queue graphics { get_device(), 0, 0 };
+    Vulkan::Queue transfer { get_device(), 1, 0 };
+
+    Vulkan::Queue* queues[] = { &graphics, &transfer };
+    Vulkan::DeletionQueue deletion { queues };
+
+    U32 released = 0;
+
+    const U64 first  = submit(graphics);
+    const U64 second = submit(graphics);
+    (void)submit(transfer);
+
+    deletion.push(graphics, second, Resource { released });
+
+    CR_EXPECT(released == 0 && deletion.size() == 1, "Pushing released the resource");
+
+    complete(graphics, first);
+    deletion.collect();
+
+    CR_EXPECT(released == 0, "Released before its ticket completed");
+
+    // The transfer queue was submitted to, but the resource only waits on graphics
+    complete(graphics, second);
+    deletion.collect();
+
+    CR_EXPECT(released == 1 && deletion.size() == 0, "Not released once its ticket completed");
+
+    // Tickets of one queue are not compared against the timeline of the other
+    const U64 transfer_ticket = submit(transfer);
+    (void)submit(graphics);
+
+    deletion.push(transfer, transfer_ticket, Resource { released });
+
+    complete(graphics, graphics.get_last_submitted());
+    deletion.collect();
+
+    CR_EXPECT(released == 1, "Released when another queue passed its ticket");
+
+    complete(transfer, transfer_ticket);
+    deletion.collect();
+
+    CR_EXPECT(released == 2, "Not released once its own queue passed its ticket");
+
+    // Queues that are not tracked can not be waited on
+    Vulkan::Queue compute { get_device(), 2, 0 };
+
+    bool threw = false;
+
+    try
+    {
+        deletion.push(compute, submit(compute), Resource { released });
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+
+    CR_EXPECT(threw, "Pushing on an untracked queue did not throw");
+}
+
+void test_close_frame()
+{
+    Vulkan::Queue graphics { get_device(), 0, 0 };
+    Vulkan::Queue transfer { get_device(), 1, 0 };
+
+    Vulkan::Queue* queues[] = { &graphics, &transfer };
+    Vulkan::DeletionQueue deletion { queues };
+
+    U32 released = 0;
+
+    const U64 graphics_ticket = submit(graphics);
+    const U64 transfer_ticket = submit(transfer);
+
+    complete(graphics, graphics_ticket);
+    complete(transfer, transfer_ticket);
+
+    // Everything submitted so far is complete, but the frame that may still use the resource is not submitted yet
+    deletion.push(Resource { released });
+    deletion.collect();
+
+    CR_EXPECT(released == 0 && deletion.size() == 1, "Released before close_frame()");
+
+    const U64 graphics_frame = submit(graphics);
+    (void)submit(graphics);
+    const U64 transfer_frame = submit(transfer);
+
+    deletion.close_frame();
+
+    // Submissions after close_frame() do not hold the resource back
+    (void)submit(graphics);
+    (void)submit(transfer);
+
+    complete(graphics, graphics_frame);
+    complete(transfer, transfer_frame);
+    deletion.collect();
+
+    CR_EXPECT(released == 0, "Released before every submission of the frame completed");
+
+    complete(graphics, graphics_frame + 1);
+    complete(transfer, transfer_frame - 1);
+    deletion.collect();
+
+    CR_EXPECT(released == 0, "Released before the transfer queue passed the frame");
+
+    complete(transfer, transfer_frame);
+    deletion.collect();
+
+    CR_EXPECT(released == 1 && deletion.size() == 0, "Not released once both queues passed the frame");
+
+    // Nothing open, closing a frame stamps nothing
+    deletion.close_frame();
+    CR_EXPECT(deletion.size() == 0, "Empty close_frame() added entries");
+}
+
+void test_polling()
+{
+    Vulkan::Queue graphics { get_device(), 0, 0 };
+    Vulkan::Queue transfer { get_device(), 1, 0 };
+
+    Vulkan::Queue* queues[] = { &graphics, &transfer };
+    Vulkan::DeletionQueue deletion { queues };
+
+    U32 released = 0;
+
+    g_device.poll_count = 0;
+    deletion.collect();
+
+    CR_EXPECT(g_device.poll_count == 0, "Collecting nothing polled {} times", g_device.poll_count);
+
+    for (U32 i = 0; i < 100; ++i)
+    {
+        deletion.push(graphics, submit(graphics), Resource { released });
+    }
+
+    complete(graphics, 50);
+    deletion.collect();
+
+    CR_EXPECT(g_device.poll_count == 2, "Collecting polled {} times for two queues", g_device.poll_count);
+    CR_EXPECT(released == 50 && deletion.size() == 50, "Released {} of the 50 completed resources", released);
+
+    deletion.push(Resource { released });
+    deletion.flush();
+
+    CR_EXPECT(released == 101 && deletion.size() == 0, "flush() released {} of 101 resources", released);
+}
+
+} // namespace
+
+extern "C"
+{
+
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceQueue(VkDevice, uint32_t, uint32_t, VkQueue* queue)
+{
+    *queue = make_handle<VkQueue>();
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateCommandPool(VkDevice, const VkCommandPoolCreateInfo*, const VkAllocationCallbacks*, VkCommandPool* pool)
+{
+    *pool = make_handle<VkCommandPool>();
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyCommandPool(VkDevice, VkCommandPool, const VkAllocationCallbacks*) {}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateSemaphore(VkDevice, const VkSemaphoreCreateInfo*, const VkAllocationCallbacks*, VkSemaphore* semaphore)
+{
+    *semaphore = make_handle<VkSemaphore>();
+    g_device.timelines[*semaphore] = 0;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySemaphore(VkDevice, VkSemaphore semaphore, const VkAllocationCallbacks*)
+{
+    g_device.timelines.erase(semaphore);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmit2(VkQueue, uint32_t, const VkSubmitInfo2*, VkFence)
+{
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetSemaphoreCounterValue(VkDevice, VkSemaphore semaphore, uint64_t* value)
+{
+    ++g_device.poll_count;
+    *value = g_device.timelines.at(semaphore);
+    return VK_SUCCESS;
+}
+
+} // extern "C"
+
+int main()
+{
+    test_tickets();
+    test_close_frame();
+    test_polling();
+
+    return Test::get_result("DeletionQueue");
+}
@@ -0,0 +1,183 @@
+#include "Test.hpp"
+
+#include "Crunch/Pool.hpp"
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+// Pool<T> handle invariants: handles go stale on take() and clear() and stay stale when their slot is reused, the
+// generation is bumped on every release, and live handles keep resolving to their value while swap-removal reorders
+// the packed array. Values are move-only to cover take() moving them out.
+
+using namespace Cr;
+
+namespace
+{
+
+using Value = std::unique_ptr<U32>;
+
+void test_take()
+{
+    Pool<Value> pool;
+
+    const Handle<Value> first  = pool.emplace(std::make_unique<U32>(1));
+    const Handle<Value> second = pool.emplace(std::make_unique<U32>(2));
+
+    CR_EXPECT(pool.contains(first) && pool.contains(second), "New handles are not contained");
+
+    const Value taken = pool.take(first);
+
+    CR_EXPECT(taken && *taken == 1, "take() returned the wrong value");
+    CR_EXPECT(!pool.contains(first), "Taken handle is still contained");
+    CR_EXPECT(pool.contains(second) && *pool.get(second) == 2, "Other handle broke after take()");
+    CR_EXPECT(pool.size() == 1, "Size is {} after take()", pool.size());
+
+    // The freed slot is reused with the next generation, the old handle must not alias the new value
+    const Handle<Value> third = pool.emplace(std::make_unique<U32>(3));
+
+    CR_EXPECT(third.index == first.index, "Freed slot {} was not reused, got {}", first.index, third.index);
+    CR_EXPECT(third.generation == first.generation + 1, "Generation went from {} to {}", first.generation, third.generation);
+    CR_EXPECT(!pool.contains(first), "Stale handle is contained after its slot was reused");
+    CR_EXPECT(pool.contains(third) && *pool.get(third) == 3, "Reused slot resolves to the wrong value");
+
+    // Every reuse bumps the generation again
+    Handle<Value> handle = third;
+
+    for (U32 i = 0; i < 10; ++i)
+    {
+        const U32 generation = handle.generation;
+
+        (void)pool.take(handle);
+        handle = pool.emplace(std::make_unique<U32>(i));
+
+        CR_EXPECT(handle.index == third.index && handle.generation == generation + 1, "Reuse {} made handle {}:{}", i, handle.index, handle.generation);
+        CR_EXPECT(!pool.contains(third), "First handle of the slot is contained after reuse {}", i);
+    }
+}
+
+void test_contains()
+{
+    Pool<Value> pool;
+
+    CR_EXPECT(!pool.contains(Handle<Value> {}), "Default handle is contained in an empty pool");
+
+    const Handle<Value> handle = pool.emplace(std::make_unique<U32>(0));
+
+    CR_EXPECT(!pool.contains(Handle<Value> {}), "Default handle is contained");
+    CR_EXPECT(!pool.contains({ handle.index + 1, 0 }), "Handle past the slot table is contained");
+    CR_EXPECT(!pool.contains({ handle.index, handle.generation + 1 }), "Handle from a future generation is contained");
+
+    // A taken slot that was not reused yet
+    (void)pool.take(handle);
+
+    CR_EXPECT(!pool.contains(handle), "Taken handle with a free slot is contained");
+    CR_EXPECT(!pool.contains({ handle.index, handle.generation + 1 }), "Free slot is contained under its next generation");
+
+    // clear() invalidates every handle
+    std::vector<Handle<Value>> handles;
+
+    for (U32 i = 0; i < 8; ++i)
+    {
+        handles.push_back(pool.emplace(std::make_unique<U32>(i)));
+    }
+
+    pool.clear();
+
+    CR_EXPECT(pool.size() == 0, "Size is {} after clear()", pool.size());
+
+    for (const Handle<Value> cleared : handles)
+    {
+        CR_EXPECT(!pool.contains(cleared), "Handle {}:{} is contained after clear()", cleared.index, cleared.generation);
+    }
+
+    for (U32 i = 0; i < 8; ++i)
+    {
+        const Handle<Value> reused = pool.emplace(std::make_unique<U32>(i));
+
+        CR_EXPECT(std::ranges::find(handles, reused) == handles.end(), "Handle {}:{} was handed out twice", reused.index, reused.generation);
+    }
+}
+
+// Random emplace and take against a map of the expected values, each take swaps the last value into the hole
+void test_swap_remove()
+{
+    Pool<Value> pool;
+
+    std::mt19937 random(3);
+
+    std::vector<Handle<Value>>   live;
+    std::vector<Handle<Value>>   stale;
+    std::unordered_map<U32, U32> expected; // Value by handle index
+
+    U32 next_value = 0;
+
+    for (U32 step = 0; step < 5000; ++step)
+    {
+        if (live.empty() || random() % 5 < 3)
+        {
+            const Handle<Value> handle = pool.emplace(std::make_unique<U32>(next_value));
+
+            expected[handle.index] = next_value++;
+            live.push_back(handle);
+        }
+        else
+        {
+            const std::size_t i = random() % live.size();
+
+            const Handle<Value> handle = live[i];
+            const Value taken = pool.take(handle);
+
+            CR_EXPECT(*taken == expected[handle.index], "Step {}: took {} instead of {}", step, *taken, expected[handle.index]);
+
+            live[i] = live.back();
+            live.pop_back();
+            stale.push_back(handle);
+        }
+
+        if (step % 50 != 0) { continue; }
+
+        for (const Handle<Value> handle : live)
+        {
+            CR_EXPECT(pool.contains(handle) && *pool.get(handle) == expected[handle.index], "Step {}: handle {}:{} lost its value", step, handle.index, handle.generation);
+        }
+
+        for (const Handle<Value> handle : stale)
+        {
+            CR_EXPECT(!pool.contains(handle), "Step {}: stale handle {}:{} is contained", step, handle.index, handle.generation);
+        }
+
+        // The packed array holds exactly the live values
+        CR_EXPECT(pool.size() == live.size(), "Step {}: size is {} instead of {}", step, pool.size(), live.size());
+
+        std::vector<U32> values;
+
+        for (const Value& value : pool.get_values())
+        {
+            values.push_back(*value);
+        }
+
+        std::vector<U32> live_values;
+
+        for (const Handle<Value> handle : live)
+        {
+            live_values.push_back(expected[handle.index]);
+        }
+
+        std::ranges::sort(values);
+        std::ranges::sort(live_values);
+
+        CR_EXPECT(values == live_values, "Step {}: packed values differ from the live handles", step);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    test_take();
+    test_contains();
+    test_swap_remove();
+
+    return Test::get_result("Pool");
+}
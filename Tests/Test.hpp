@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Crunch/Crunch.hpp"
+
+// Failed checks are logged with their location and counted, a test keeps going to report every failure and
+// returns Test::get_result() from main
+
+#define CR_EXPECT(COND, FMT, ...) do {                                                                                 \
+    if ((COND) == false) [[unlikely]]                                                                                  \
+    {                                                                                                                  \
+        CR_ERROR("{}:{} " FMT, __FILE__, __LINE__ __VA_OPT__(,) __VA_ARGS__);                                          \
+        ++Cr::Test::g_failures;                                                                                        \
+    }                                                                                                                  \
+} while(0)
+
+namespace Cr::Test
+{
+
+inline U32 g_failures = 0;
+
+[[nodiscard]] inline int get_result(const char* name)
+{
+    if (g_failures != 0)
+    {
+        CR_ERROR("{}: {} checks failed", name, g_failures);
+        return 1;
+    }
+
+    CR_INFO("{}: passed", name);
+    return 0;
+}
+
+} // namespace Cr::Test
@@ -0,0 +1,239 @@
+#include "Test.hpp"
+
+#include "Scene/TransformHierarchy.hpp"
+
+#include "Core/Jobs.hpp"
+
+#include <random>
+
+// Scene::TransformHierarchy against a naive recursive composition of the local transforms, after changes to roots,
+// middle nodes and leaves and after nodes are added and removed. update() is also checked to only recompute the
+// subtrees of changed nodes.
+
+using namespace Cr;
+using namespace Cr::Scene;
+
+namespace
+{
+
+constexpr F32 TOLERANCE = 1e-4f;
+
+// Small batches so every level is split across the workers
+constexpr U32 BATCH_SIZE = 4;
+
+struct Tree
+{
+    TransformHierarchy hierarchy;
+
+    std::vector<U32> nodes;  // Live ids, parents before children
+    std::vector<U32> leaves;
+    std::vector<U32> middle; // Neither roots nor leaves
+    std::vector<U32> roots;
+};
+
+LocalTransform make_local(std::mt19937& random)
+{
+    std::uniform_real_distribution<F32> offset(-10.0f, 10.0f);
+    std::uniform_real_distribution<F32> angle(-PI, PI);
+    std::uniform_real_distribution<F32> scale(0.5f, 2.0f);
+
+    const Vec3f axis = glm::normalize(Vec3f(offset(random), offset(random), offset(random)) + Vec3f(0.0f, 0.0f, 21.0f));
+
+    return {
+        .translation = { offset(random), offset(random), offset(random) },
+        .rotation    = glm::angleAxis(angle(random), axis),
+        .scale       = { scale(random), scale(random), scale(random) },
+    };
+}
+
+// Composed from the root down without any caching
+Mat4f get_expected_world(const TransformHierarchy& hierarchy, U32 node)
+{
+    const LocalTransform& local = hierarchy.get_local(node);
+
+    const Mat4f matrix = glm::translate(Mat4f(1.0f), local.translation) * glm::mat4_cast(local.rotation) * glm::scale(Mat4f(1.0f), local.scale);
+
+    const U32 parent = hierarchy.get_parent(node);
+
+    return parent == TransformHierarchy::INVALID_NODE ? matrix : get_expected_world(hierarchy, parent) * matrix;
+}
+
+void expect_worlds(const Tree& tree, const char* when)
+{
+    for (const U32 node : tree.nodes)
+    {
+        const Mat4f& world    = tree.hierarchy.get_world(node);
+        const Mat4f  expected = get_expected_world(tree.hierarchy, node);
+
+        F32 error = 0.0f;
+        F32 scale = 1.0f;
+
+        for (U32 column = 0; column < 4; ++column)
+        {
+            for (U32 row = 0; row < 4; ++row)
+            {
+                error = std::max(error, std::abs(world[column][row] - expected[column][row]));
+                scale = std::max(scale, std::abs(expected[column][row]));
+            }
+        }
+
+        CR_EXPECT(error <= TOLERANCE * scale, "{}: world matrix of node {} is off by {}", when, node, error);
+    }
+}
+
+bool is_in_subtree(const TransformHierarchy& hierarchy, U32 node, U32 root)
+{
+    for (U32 ancestor = node; ancestor != TransformHierarchy::INVALID_NODE; ancestor = hierarchy.get_parent(ancestor))
+    {
+        if (ancestor == root) { return true; }
+    }
+
+    return false;
+}
+
+U32 get_subtree_size(const Tree& tree, U32 root)
+{
+    return static_cast<U32>(std::ranges::count_if(tree.nodes, [&](U32 node) { return is_in_subtree(tree.hierarchy, node, root); }));
+}
+
+// Three roots with three levels of three children below each
+void build(Tree& tree, std::mt19937& random)
+{
+    std::vector<U32> level;
+
+    for (U32 i = 0; i < 3; ++i)
+    {
+        level.push_back(tree.hierarchy.add(make_local(random)));
+    }
+
+    tree.roots = level;
+
+    for (U32 depth = 1; depth < 4; ++depth)
+    {
+        tree.nodes.insert(tree.nodes.end(), level.begin(), level.end());
+
+        if (depth > 1) { tree.middle.insert(tree.middle.end(), level.begin(), level.end()); }
+
+        std::vector<U32> next;
+
+        for (const U32 parent : level)
+        {
+            for (U32 i = 0; i < 3; ++i)
+            {
+                next.push_back(tree.hierarchy.add(make_local(random), parent));
+            }
+        }
+
+        level = std::move(next);
+    }
+
+    tree.nodes.insert(tree.nodes.end(), level.begin(), level.end());
+    tree.leaves = std::move(level);
+}
+
+// Changing one node recomputes exactly its subtree and nothing else moves
+void expect_change(Tree& tree, Core::JobSystem& jobs, std::mt19937& random, U32 node, const char* what)
+{
+    std::vector<Mat4f> before;
+
+    for (const U32 other : tree.nodes)
+    {
+        before.push_back(tree.hierarchy.get_world(other));
+    }
+
+    tree.hierarchy.set_local(node, make_local(random));
+    tree.hierarchy.set_local(node, make_local(random)); // Marking twice still updates once
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+
+    const U32 expected = get_subtree_size(tree, node);
+
+    CR_EXPECT(tree.hierarchy.get_updated_count() == expected, "{} change recomputed {} nodes instead of {}", what, tree.hierarchy.get_updated_count(), expected);
+
+    expect_worlds(tree, what);
+
+    for (std::size_t i = 0; i < tree.nodes.size(); ++i)
+    {
+        const bool moved = tree.hierarchy.get_world(tree.nodes[i]) != before[i];
+
+        CR_EXPECT(!moved || is_in_subtree(tree.hierarchy, tree.nodes[i], node), "{} change moved node {} outside of its subtree", what, tree.nodes[i]);
+    }
+}
+
+void test_changes(Core::JobSystem& jobs)
+{
+    std::mt19937 random(7);
+
+    Tree tree;
+    build(tree, random);
+
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+
+    CR_EXPECT(tree.hierarchy.get_updated_count() == tree.nodes.size(), "First update recomputed {} of {} nodes", tree.hierarchy.get_updated_count(), tree.nodes.size());
+    expect_worlds(tree, "first update");
+
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+    CR_EXPECT(tree.hierarchy.get_updated_count() == 0, "Update without changes recomputed {} nodes", tree.hierarchy.get_updated_count());
+
+    expect_change(tree, jobs, random, tree.leaves[7], "Leaf");
+    expect_change(tree, jobs, random, tree.middle[4], "Middle");
+    expect_change(tree, jobs, random, tree.roots[1], "Root");
+
+    // A parent and one of its descendants changed together, the descendant is only recomputed once
+    tree.hierarchy.set_local(tree.middle[0], make_local(random));
+    tree.hierarchy.set_local(tree.leaves[0], make_local(random));
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+
+    CR_EXPECT(tree.hierarchy.get_updated_count() == get_subtree_size(tree, tree.middle[0]), "Nested changes recomputed {} nodes", tree.hierarchy.get_updated_count());
+    expect_worlds(tree, "nested changes");
+}
+
+void test_layout_changes(Core::JobSystem& jobs)
+{
+    std::mt19937 random(11);
+
+    Tree tree;
+    build(tree, random);
+
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+
+    // Dropping a middle subtree moves the remaining nodes to new slots, none of them needs recomputing
+    const U32 removed = tree.middle[1];
+    const U32 removed_size = get_subtree_size(tree, removed);
+
+    tree.hierarchy.remove(removed);
+
+    std::erase_if(tree.nodes, [&](U32 node) { return is_in_subtree(tree.hierarchy, node, removed); });
+
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+
+    CR_EXPECT(tree.hierarchy.size() == tree.nodes.size(), "{} nodes left instead of {}", tree.hierarchy.size(), tree.nodes.size());
+    CR_EXPECT(tree.nodes.size() + removed_size == 120, "Removed subtree had {} nodes", removed_size);
+    CR_EXPECT(tree.hierarchy.get_updated_count() == 0, "Removing a subtree recomputed {} nodes", tree.hierarchy.get_updated_count());
+    expect_worlds(tree, "subtree removed");
+
+    // New children under a leaf and a root, reusing freed ids, only they are computed
+    const U32 leaf  = tree.hierarchy.add(make_local(random), tree.leaves.back());
+    const U32 child = tree.hierarchy.add(make_local(random), tree.roots.front());
+
+    tree.nodes.push_back(leaf);
+    tree.nodes.push_back(child);
+
+    tree.hierarchy.update(jobs, BATCH_SIZE);
+
+    CR_EXPECT(tree.hierarchy.get_updated_count() == 2, "Adding two nodes recomputed {} nodes", tree.hierarchy.get_updated_count());
+    expect_worlds(tree, "nodes added");
+
+    expect_change(tree, jobs, random, tree.roots.front(), "Root after layout changes");
+}
+
+} // namespace
+
+int main()
+{
+    Core::JobSystem jobs(3);
+
+    test_changes(jobs);
+    test_layout_changes(jobs);
+
+    return Test::get_result("TransformHierarchy");
+}
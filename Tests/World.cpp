@@ -0,0 +1,282 @@
+#include "Test.hpp"
+
+#include "Scene/World.hpp"
+
+#include <thread>
+
+// Scene::World storage invariants: rows stay packed across chunks when entities are destroyed or change archetype,
+// moved rows keep their entity records in sync, stale handles are rejected and cached queries pick up archetypes
+// created after them.
+
+using namespace Cr;
+using namespace Cr::Scene;
+
+namespace
+{
+
+struct ID
+{
+    U32 value;
+};
+
+struct Velocity
+{
+    F32 x, y, z;
+};
+
+// Large enough that an archetype only holds a handful of rows per chunk
+struct Payload
+{
+    std::array<U32, 250> words;
+};
+
+struct Visits
+{
+    U32 count;
+};
+
+Payload make_payload(U32 value)
+{
+    Payload payload;
+    payload.words.fill(value);
+
+    return payload;
+}
+
+// Every live entity of the list still reads back its own components
+void expect_intact(World& world, std::span<const Entity> entities, const char* when)
+{
+    for (const Entity entity : entities)
+    {
+        CR_EXPECT(world.is_alive(entity), "{}: entity {} is not alive", when, entity.index);
+
+        if (!world.is_alive(entity)) { continue; }
+
+        const U32 id = world.get<ID>(entity).value;
+
+        CR_EXPECT(id == entity.index, "{}: entity {} reads the ID of entity {}", when, entity.index, id);
+        CR_EXPECT(world.get<Payload>(entity).words.front() == id && world.get<Payload>(entity).words.back() == id,
+                  "{}: entity {} has the payload of another row", when, entity.index);
+    }
+}
+
+// Rows are packed, every chunk but the last is full, and every chunk entity is the one its record points to
+void expect_packed(World& world, const char* when)
+{
+    U32 rows = 0;
+
+    world.each_chunk<const ID>([&](std::span<const Entity> entities, std::span<const ID> ids)
+    {
+        for (std::size_t i = 0; i < entities.size(); ++i)
+        {
+            CR_EXPECT(ids[i].value == entities[i].index, "{}: chunk row of entity {} holds the ID {}", when, entities[i].index, ids[i].value);
+            CR_EXPECT(world.get<ID>(entities[i]).value == ids[i].value, "{}: record of entity {} points to another row", when, entities[i].index);
+        }
+
+        rows += static_cast<U32>(entities.size());
+    });
+
+    CR_EXPECT(rows == world.size(), "{}: queries see {} rows for {} entities", when, rows, world.size());
+}
+
+void test_chunk_boundaries()
+{
+    World world;
+
+    std::vector<Entity> entities;
+
+    for (U32 i = 0; i < 100; ++i)
+    {
+        const Entity entity = world.create(ID { 0 }, make_payload(0));
+
+        world.get<ID>(entity)      = { entity.index };
+        world.get<Payload>(entity) = make_payload(entity.index);
+
+        entities.push_back(entity);
+    }
+
+    expect_intact(world, entities, "created");
+
+    // Every third entity moves to another archetype and back, each move swap-removes a row of the source
+    for (U32 i = 0; i < entities.size(); i += 3)
+    {
+        world.add(entities[i], Velocity { F32(i), 0.0f, 0.0f });
+    }
+
+    expect_intact(world, entities, "components added");
+    expect_packed(world, "components added");
+
+    U32 moving = 0;
+    world.each<const Velocity, const ID>([&](const Velocity& velocity, const ID& id)
+    {
+        CR_EXPECT(entities[U32(velocity.x)].index == id.value, "Velocity of entity {} moved with another entity", id.value);
+        ++moving;
+    });
+
+    CR_EXPECT(moving == 34, "{} entities have a velocity instead of 34", moving);
+
+    for (U32 i = 0; i < entities.size(); i += 3)
+    {
+        world.remove<Velocity>(entities[i]);
+
+        CR_EXPECT(!world.has<Velocity>(entities[i]), "Velocity of entity {} was not removed", entities[i].index);
+    }
+
+    expect_intact(world, entities, "components removed");
+    expect_packed(world, "components removed");
+
+    // Adding a component the entity already has overwrites it in place
+    world.add(entities[5], ID { entities[5].index });
+    CR_EXPECT(world.get<ID>(entities[5]).value == entities[5].index, "Re-adding a component changed it");
+}
+
+void test_destroy()
+{
+    World world;
+
+    std::vector<Entity> entities;
+
+    for (U32 i = 0; i < 40; ++i)
+    {
+        const Entity entity = world.create(ID { 0 }, make_payload(0));
+
+        world.get<ID>(entity)      = { entity.index };
+        world.get<Payload>(entity) = make_payload(entity.index);
+
+        entities.push_back(entity);
+    }
+
+    // Last row, nothing moves
+    world.destroy(entities.back());
+    entities.pop_back();
+
+    expect_intact(world, entities, "last row destroyed");
+    expect_packed(world, "last row destroyed");
+
+    // Middle of the first chunk, the last row moves into it. Destroying the moved entity right away only works when
+    // its record was updated to the new row.
+    const Entity last = entities.back();
+
+    world.destroy(entities[2]);
+    entities.erase(entities.begin() + 2);
+
+    expect_intact(world, entities, "middle row destroyed");
+    expect_packed(world, "middle row destroyed");
+
+    world.destroy(last);
+    std::erase(entities, last);
+
+    expect_intact(world, entities, "moved row destroyed");
+    expect_packed(world, "moved row destroyed");
+
+    // Down to nothing from the front, every destroy moves the last row
+    while (!entities.empty())
+    {
+        world.destroy(entities.front());
+        entities.erase(entities.begin());
+
+        expect_intact(world, entities, "front row destroyed");
+    }
+
+    CR_EXPECT(world.size() == 0, "{} entities left after destroying all", world.size());
+    expect_packed(world, "all destroyed");
+}
+
+void test_stale_generations()
+{
+    World world;
+
+    const Entity first = world.create(ID { 1 });
+    world.destroy(first);
+
+    CR_EXPECT(!world.is_alive(first), "Destroyed entity is alive");
+    CR_EXPECT(!world.has<ID>(first), "Destroyed entity has components");
+
+    // The index is reused with a new generation, the old handle stays dead
+    const Entity second = world.create(ID { 2 });
+
+    CR_EXPECT(second.index == first.index, "Freed index {} was not reused, got {}", first.index, second.index);
+    CR_EXPECT(second.generation != first.generation, "Reused index kept generation {}", first.generation);
+    CR_EXPECT(world.is_alive(second) && !world.is_alive(first), "Old handle aliases the new entity");
+    CR_EXPECT(!world.has<ID>(first), "Old handle reads the components of the new entity");
+    CR_EXPECT(world.get<ID>(second).value == 2, "New entity reads {}", world.get<ID>(second).value);
+
+    CR_EXPECT(!world.is_alive(INVALID_ENTITY), "Invalid entity is alive");
+    CR_EXPECT(!world.is_alive(Entity { 1000, 0 }), "Out of range entity is alive");
+}
+
+void test_query_cache()
+{
+    World world;
+
+    (void)world.create(ID { 0 });
+
+    const auto count = [&world]()
+    {
+        U32 count = 0;
+        world.each<const ID>([&count](const ID&) { ++count; });
+        return count;
+    };
+
+    CR_EXPECT(count() == 1, "Query before new archetypes sees {} entities", count());
+
+    // Archetypes created after the query was cached, one matching and one not
+    (void)world.create(ID { 1 }, Velocity {});
+    (void)world.create(Velocity {});
+
+    const Entity moved = world.create(Visits {});
+    world.add(moved, ID { 2 }); // Through an add edge
+
+    CR_EXPECT(count() == 3, "Query after new archetypes sees {} entities instead of 3", count());
+
+    // A query first made now is built from every existing archetype
+    U32 velocities = 0;
+    world.each<const Velocity>([&velocities](const Velocity&) { ++velocities; });
+
+    CR_EXPECT(velocities == 2, "New query sees {} velocities instead of 2", velocities);
+}
+
+void test_parallel_each()
+{
+    World world;
+
+    Core::JobSystem jobs(std::max(std::thread::hardware_concurrency(), 4u) - 1);
+
+    // Several archetypes and many chunks each, batches of one chunk to spread them over every worker
+    for (U32 i = 0; i < 5000; ++i)
+    {
+        switch (i % 3)
+        {
+            case 0: (void)world.create(Visits {}); break;
+            case 1: (void)world.create(Visits {}, ID { i }); break;
+            case 2: (void)world.create(Visits {}, Velocity {}); break;
+        }
+    }
+
+    (void)world.create(ID { 0 }); // Not visited
+
+    world.parallel_each<Visits>(jobs, [](Visits& visits) { ++visits.count; }, 1);
+
+    U32 visited = 0;
+
+    world.each<const Visits>([&visited](const Visits& visits)
+    {
+        CR_EXPECT(visits.count == 1, "Entity visited {} times by parallel_each", visits.count);
+        ++visited;
+    });
+
+    CR_EXPECT(visited == 5000, "parallel_each covered {} of 5000 entities", visited);
+}
+
+} // namespace
+
+int main()
+{
+    test_chunk_boundaries();
+    test_destroy();
+    test_stale_generations();
+    test_query_cache();
+    test_parallel_each();
+
+    return Test::get_result("World");
+}